@@ -67,6 +67,11 @@ namespace bridges {
 					std::vector<double> vtxCounts;
 					std::vector<double> edgeCounts;
 
+					if (results)
+						results->setMetadata("benchmark", "BFSBenchmark");
+
+					SweepScheduler sweep = newSweep();
+
 					for (int years = 0; years < 120; years = 1.2 * years + 1) {
 						int year = 2019 - years;
 						std::cerr << "*" << std::flush;
@@ -77,22 +82,23 @@ namespace bridges {
 
 						std::string root = highestDegreeVertex(graph);
 
-						std::unordered_map<std::string, int> level;
-						std::unordered_map<std::string, std::string> parent;
-
-						std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
-
-						bfsalgo(graph, root, level, parent);
+						if (!affordable(sweep, edgeCount))
+							break;
 
-						std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
+						double elapsed = timeRuns(algoName, (double)edgeCount, sweep, [&]() {
+							std::unordered_map<std::string, int> level;
+							std::unordered_map<std::string, std::string> parent;
 
-						std::chrono::duration<double> elapsed_seconds = end - start;
+							bfsalgo(graph, root, level, parent);
+						});
+						if (elapsed < 0.)
+							break;
 
-						time.push_back ((double)elapsed_seconds.count() );
+						time.push_back (elapsed);
 						vtxCounts.push_back ( (double)vertexCount );
 						edgeCounts.push_back ( (double)edgeCount );
 
-						if (elapsed_seconds.count() > time_cap) {
+						if (elapsed > time_cap) {
 							break;
 						}
 					}
@@ -0,0 +1,697 @@
+#ifndef BENCHMARK_RESULTS_H
+#define BENCHMARK_RESULTS_H
+
+#include <LineChart.h>
+#include <BarChart.h>
+#include <JSONutil.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <rapidjson/prettywriter.h>
+
+namespace bridges {
+	namespace benchmark {
+		using namespace bridges::datastructure;
+
+		/**
+		 * @brief All the runtimes measured for one size of one series.
+		 **/
+		struct BenchmarkPoint {
+			double x;
+			std::vector<double> samples;
+
+			double mean() const {
+				double s = 0.;
+				for (double v : samples)
+					s += v;
+				return samples.size() ? s / samples.size() : 0.;
+			}
+
+			///@return unbiased variance of the samples (0 with less than 2 samples)
+			double variance() const {
+				if (samples.size() < 2)
+					return 0.;
+				double m = mean();
+				double s = 0.;
+				for (double v : samples)
+					s += (v - m) * (v - m);
+				return s / (samples.size() - 1);
+			}
+
+			double median() const {
+				if (samples.empty())
+					return 0.;
+				std::vector<double> v = samples;
+				std::sort(v.begin(), v.end());
+				size_t h = v.size() / 2;
+				return (v.size() % 2) ? v[h] : (v[h - 1] + v[h]) / 2.;
+			}
+		};
+
+		/**
+		 * @brief Machine readable results of a benchmark.
+		 *
+		 * The benchmark classes (SortingBenchmark, BFSBenchmark,
+		 * PageRankBenchmark, ShortestPathBenchmark) record every
+		 * measurement in a BenchmarkResults when one is attached to them
+		 * with recordResults(). The results can then be saved locally as
+		 * JSON or CSV, together with metadata describing the run
+		 * (compiler, compilation flags, CPU model, commit, date), and
+		 * loaded back to be compared with BenchmarkComparison.
+		 *
+		 * The compilation flags can be provided by defining
+		 * BRIDGES_BENCHMARK_FLAGS (e.g., -DBRIDGES_BENCHMARK_FLAGS="\"-O3\"")
+		 * or through the BRIDGES_BENCHMARK_FLAGS environment variable. The
+		 * commit is taken from the BRIDGES_BENCHMARK_COMMIT environment
+		 * variable or, failing that, from git.
+		 *
+		 * \code{.cpp}
+		 * LineChart lc;
+		 * BenchmarkResults res;
+		 * SortingBenchmark sb (lc);
+		 * sb.recordResults(res);
+		 * sb.run("mysort", mysort);
+		 * res.saveJSON("mysort.json");
+		 * \endcode
+		 **/
+		class BenchmarkResults {
+			private:
+				std::map<std::string, std::string> metadata;
+				std::map<std::string, std::vector<BenchmarkPoint>> series;
+
+				static std::string trim(const std::string& s) {
+					size_t b = s.find_first_not_of(" \t\r\n");
+					size_t e = s.find_last_not_of(" \t\r\n");
+					return (b == std::string::npos) ? "" : s.substr(b, e - b + 1);
+				}
+
+				static std::string compilerVersion() {
+#if defined(__clang__)
+					return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+					return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+					return "msvc " + std::to_string(_MSC_VER);
+#else
+					return "unknown";
+#endif
+				}
+
+				static std::string compilationFlags() {
+					const char* env = getenv("BRIDGES_BENCHMARK_FLAGS");
+					if (env != nullptr)
+						return env;
+#ifdef BRIDGES_BENCHMARK_FLAGS
+					return BRIDGES_BENCHMARK_FLAGS;
+#elif defined(__OPTIMIZE__)
+					return "optimized";
+#else
+					return "unknown";
+#endif
+				}
+
+				static std::string cpuModel() {
+					std::ifstream cpuinfo("/proc/cpuinfo");
+					std::string line;
+					while (std::getline(cpuinfo, line)) {
+						if (line.compare(0, 10, "model name") == 0) {
+							size_t colon = line.find(':');
+							if (colon != std::string::npos)
+								return trim(line.substr(colon + 1));
+						}
+					}
+					return "unknown";
+				}
+
+				static std::string commit() {
+					const char* env = getenv("BRIDGES_BENCHMARK_COMMIT");
+					if (env != nullptr)
+						return env;
+#ifndef _WIN32
+					FILE* p = popen("git rev-parse HEAD 2>/dev/null", "r");
+					if (p != nullptr) {
+						char buf[128];
+						std::string out;
+						while (fgets(buf, sizeof(buf), p) != nullptr)
+							out += buf;
+						pclose(p);
+						out = trim(out);
+						if (out.size())
+							return out;
+					}
+#endif
+					return "unknown";
+				}
+
+				static std::string now() {
+					char buf[64];
+					std::time_t t = std::time(nullptr);
+					std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", std::localtime(&t));
+					return buf;
+				}
+
+				/// member key of v, which must be an object; throws if it is missing
+				static const rapidjson::Value& member(const rapidjson::Value& v, const char* key) {
+					if (!v.IsObject() || !v.HasMember(key))
+						throw std::runtime_error(std::string("Malformed benchmark result JSON: no ") + key);
+					return v[key];
+				}
+
+				static const rapidjson::Value& array(const rapidjson::Value& v, const char* key) {
+					const rapidjson::Value& a = member(v, key);
+					if (!a.IsArray())
+						throw std::runtime_error(std::string("Malformed benchmark result JSON: ") + key
+							+ " is not an array");
+					return a;
+				}
+
+				static double number(const rapidjson::Value& v) {
+					if (!v.IsNumber())
+						throw std::runtime_error("Malformed benchmark result JSON: expected a number");
+					return v.GetDouble();
+				}
+
+				// The types are checked explicitly rather than through
+				// RAPIDJSON_ASSERT: whether it throws depends on which header
+				// included rapidjson first.
+				void loadJSONString(const std::string& content) {
+					rapidjson::Document doc;
+					// full precision, so that saved samples load back unchanged
+					doc.Parse<rapidjson::kParseFullPrecisionFlag>(content.c_str());
+					if (doc.HasParseError() || !doc.IsObject())
+						throw std::runtime_error("Malformed benchmark result JSON");
+
+					metadata.clear();
+					series.clear();
+					if (doc.HasMember("metadata")) {
+						const rapidjson::Value& meta = doc["metadata"];
+						if (!meta.IsObject())
+							throw std::runtime_error("Malformed benchmark result JSON: metadata is not an object");
+						for (auto& m : meta.GetObject()) {
+							if (!m.value.IsString())
+								throw std::runtime_error("Malformed benchmark result JSON: metadata are strings");
+							metadata[m.name.GetString()] = m.value.GetString();
+						}
+					}
+					for (auto& s : array(doc, "series").GetArray()) {
+						const rapidjson::Value& name = member(s, "name");
+						if (!name.IsString())
+							throw std::runtime_error("Malformed benchmark result JSON: name is not a string");
+						std::vector<BenchmarkPoint>& pts = series[name.GetString()];
+						for (auto& p : array(s, "points").GetArray()) {
+							BenchmarkPoint pt;
+							pt.x = number(member(p, "x"));
+							for (auto& v : array(p, "samples").GetArray())
+								pt.samples.push_back(number(v));
+							pts.push_back(pt);
+						}
+					}
+				}
+
+				void loadCSVStream(std::istream& in) {
+					metadata.clear();
+					series.clear();
+
+					std::string line;
+					bool header = true;
+					while (std::getline(in, line)) {
+						line = trim(line);
+						if (line.empty())
+							continue;
+						if (line[0] == '#') { // "# key: value"
+							size_t colon = line.find(':');
+							if (colon != std::string::npos)
+								metadata[trim(line.substr(1, colon - 1))] = trim(line.substr(colon + 1));
+							continue;
+						}
+						if (header) { //column names
+							header = false;
+							continue;
+						}
+						// series,x,time ; series names are quoted
+						size_t lastComma = line.rfind(',');
+						size_t midComma = (lastComma == std::string::npos) ? std::string::npos
+							: line.rfind(',', lastComma - 1);
+						if (midComma == std::string::npos)
+							throw std::runtime_error("Malformed benchmark result CSV: " + line);
+						std::string name = unquoteCSV(line.substr(0, midComma));
+						double x, time;
+						try {
+							x = std::stod(line.substr(midComma + 1, lastComma - midComma - 1));
+							time = std::stod(line.substr(lastComma + 1));
+						}
+						catch (std::logic_error&) { // invalid_argument, out_of_range
+							throw std::runtime_error("Malformed benchmark result CSV: " + line);
+						}
+						addSample(name, x, time);
+					}
+				}
+
+				static std::string quoteCSV(const std::string& s) {
+					std::string ret = "\"";
+					for (char c : s) {
+						if (c == '"')
+							ret += '"';
+						ret += c;
+					}
+					return ret + "\"";
+				}
+
+				static std::string unquoteCSV(const std::string& s) {
+					if (s.size() < 2 || s.front() != '"' || s.back() != '"')
+						return s;
+					std::string ret;
+					for (size_t i = 1; i + 1 < s.size(); ++i) {
+						if (s[i] == '"' && s[i + 1] == '"')
+							++i;
+						ret += s[i];
+					}
+					return ret;
+				}
+
+				static bool endsWith(const std::string& s, const std::string& suffix) {
+					return s.size() >= suffix.size() &&
+						s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+				}
+
+			public:
+				/**
+				 * @brief Creates an empty set of results and collects the
+				 * metadata of the current run.
+				 **/
+				BenchmarkResults()
+					: BenchmarkResults(true) {
+				}
+
+			private:
+				///@param collect whether to collect the metadata of the current run
+				explicit BenchmarkResults(bool collect) {
+					if (!collect)
+						return;
+					metadata["compiler"] = compilerVersion();
+					metadata["flags"] = compilationFlags();
+					metadata["cpu"] = cpuModel();
+					metadata["commit"] = commit();
+					metadata["date"] = now();
+				}
+
+			public:
+
+				/**
+				 * @brief Sets (or overrides) a metadata field
+				 *
+				 * @param key name of the field
+				 * @param value value of the field
+				 **/
+				void setMetadata(const std::string& key, const std::string& value) {
+					metadata[key] = value;
+				}
+
+				///@return the metadata field key (empty if not present)
+				std::string getMetadata(const std::string& key) const {
+					auto it = metadata.find(key);
+					return (it == metadata.end()) ? "" : it->second;
+				}
+
+				const std::map<std::string, std::string>& getAllMetadata() const {
+					return metadata;
+				}
+
+				/**
+				 * @brief Records one measurement
+				 *
+				 * @param seriesName name of the series (typically the algorithm)
+				 * @param x size of the problem
+				 * @param time runtime in seconds
+				 **/
+				void addSample(const std::string& seriesName, double x, double time) {
+					std::vector<BenchmarkPoint>& pts = series[seriesName];
+					for (auto& p : pts) {
+						if (p.x == x) {
+							p.samples.push_back(time);
+							return;
+						}
+					}
+					BenchmarkPoint p;
+					p.x = x;
+					p.samples.push_back(time);
+					pts.push_back(p);
+				}
+
+				///@return the names of the recorded series
+				std::vector<std::string> getSeriesNames() const {
+					std::vector<std::string> ret;
+					for (auto& s : series)
+						ret.push_back(s.first);
+					return ret;
+				}
+
+				///@return the points of a series (empty if there is no such series)
+				std::vector<BenchmarkPoint> getSeries(const std::string& seriesName) const {
+					auto it = series.find(seriesName);
+					if (it == series.end())
+						return std::vector<BenchmarkPoint>();
+					return it->second;
+				}
+
+				///@brief removes all measurements, but keeps the metadata
+				void clear() {
+					series.clear();
+				}
+
+				///@return the results as a JSON document
+				std::string toJSON() const {
+					rapidjson::StringBuffer sb;
+					rapidjson::PrettyWriter<rapidjson::StringBuffer> w(sb);
+					w.StartObject();
+					w.Key("metadata");
+					w.StartObject();
+					for (auto& m : metadata) {
+						w.Key(m.first.c_str());
+						w.String(m.second.c_str());
+					}
+					w.EndObject();
+					w.Key("series");
+					w.StartArray();
+					for (auto& s : series) {
+						w.StartObject();
+						w.Key("name");
+						w.String(s.first.c_str());
+						w.Key("points");
+						w.StartArray();
+						for (auto& p : s.second) {
+							w.StartObject();
+							w.Key("x");
+							w.Double(p.x);
+							w.Key("samples");
+							w.StartArray();
+							for (double v : p.samples)
+								w.Double(v);
+							w.EndArray();
+							w.EndObject();
+						}
+						w.EndArray();
+						w.EndObject();
+					}
+					w.EndArray();
+					w.EndObject();
+					return sb.GetString();
+				}
+
+				///@return the results as CSV, metadata are "# key: value" lines
+				std::string toCSV() const {
+					std::stringstream ss;
+					ss.precision(17);
+					for (auto& m : metadata)
+						ss << "# " << m.first << ": " << m.second << "\n";
+					ss << "series,x,time\n";
+					for (auto& s : series)
+						for (auto& p : s.second)
+							for (double v : p.samples)
+								ss << quoteCSV(s.first) << "," << p.x << "," << v << "\n";
+					return ss.str();
+				}
+
+				///@brief writes the results as JSON in filename
+				void saveJSON(const std::string& filename) const {
+					std::ofstream out(filename);
+					if (!out)
+						throw std::runtime_error("Can not write benchmark results to " + filename);
+					out << toJSON() << "\n";
+				}
+
+				///@brief writes the results as CSV in filename
+				void saveCSV(const std::string& filename) const {
+					std::ofstream out(filename);
+					if (!out)
+						throw std::runtime_error("Can not write benchmark results to " + filename);
+					out << toCSV();
+				}
+
+				/**
+				 * @brief writes the results in filename
+				 *
+				 * The format is CSV if the file name ends in ".csv" and JSON
+				 * otherwise.
+				 **/
+				void save(const std::string& filename) const {
+					if (endsWith(filename, ".csv"))
+						saveCSV(filename);
+					else
+						saveJSON(filename);
+				}
+
+				/**
+				 * @brief Loads results written by save(), saveJSON() or
+				 * saveCSV()
+				 *
+				 * The format is CSV if the file name ends in ".csv" and JSON
+				 * otherwise.
+				 *
+				 * @param filename file to read
+				 * @return the results stored in the file
+				 **/
+				static BenchmarkResults load(const std::string& filename) {
+					std::ifstream in(filename);
+					if (!in)
+						throw std::runtime_error("Can not read benchmark results from " + filename);
+
+					BenchmarkResults res(false);
+					if (endsWith(filename, ".csv")) {
+						res.loadCSVStream(in);
+					}
+					else {
+						std::stringstream ss;
+						ss << in.rdbuf();
+						res.loadJSONString(ss.str());
+					}
+					return res;
+				}
+		};
+
+		/**
+		 * @brief Compares two benchmark runs.
+		 *
+		 * Points of series with the same name and same size in both runs
+		 * are matched. For each of them the speedup (mean baseline time
+		 * over mean candidate time, larger is better) is computed, and
+		 * Welch's t-test tells whether the difference is significant.
+		 * The test needs at least two samples per point on each side;
+		 * see setRepetitions() in the benchmark classes.
+		 *
+		 * \code{.cpp}
+		 * BenchmarkComparison cmp (BenchmarkResults::load("lastweek.json"),
+		 *                          BenchmarkResults::load("today.json"));
+		 * LineChart lc;
+		 * cmp.render(lc);
+		 * \endcode
+		 **/
+		class BenchmarkComparison {
+			public:
+				struct PointComparison {
+					double x;
+					double baselineMean;
+					double candidateMean;
+					double speedup;
+					double pValue; ///< NaN if there are not enough samples
+					bool significant;
+				};
+
+			private:
+				double alpha;
+				std::map<std::string, std::vector<PointComparison>> comparisons;
+
+				/// continued fraction of the incomplete beta function (Lentz)
+				static double betacf(double a, double b, double x) {
+					const double eps = 1e-15, fpmin = 1e-300;
+					double qab = a + b, qap = a + 1., qam = a - 1.;
+					double c = 1., d = 1. - qab * x / qap;
+					if (std::abs(d) < fpmin)
+						d = fpmin;
+					d = 1. / d;
+					double h = d;
+					for (int m = 1; m <= 300; ++m) {
+						int m2 = 2 * m;
+						double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+						d = 1. + aa * d;
+						if (std::abs(d) < fpmin)
+							d = fpmin;
+						c = 1. + aa / c;
+						if (std::abs(c) < fpmin)
+							c = fpmin;
+						d = 1. / d;
+						h *= d * c;
+						aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+						d = 1. + aa * d;
+						if (std::abs(d) < fpmin)
+							d = fpmin;
+						c = 1. + aa / c;
+						if (std::abs(c) < fpmin)
+							c = fpmin;
+						d = 1. / d;
+						double del = d * c;
+						h *= del;
+						if (std::abs(del - 1.) < eps)
+							break;
+					}
+					return h;
+				}
+
+				/// regularized incomplete beta function I_x(a,b)
+				static double incompleteBeta(double a, double b, double x) {
+					if (x <= 0.)
+						return 0.;
+					if (x >= 1.)
+						return 1.;
+					double bt = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b)
+							+ a * std::log(x) + b * std::log(1. - x));
+					if (x < (a + 1.) / (a + b + 2.))
+						return bt * betacf(a, b, x) / a;
+					return 1. - bt * betacf(b, a, 1. - x) / b;
+				}
+
+			public:
+				/**
+				 * @brief two-sided p-value of Welch's t-test
+				 *
+				 * @return NaN if either side has less than two samples
+				 **/
+				static double welchTTest(const BenchmarkPoint& a, const BenchmarkPoint& b) {
+					double na = a.samples.size(), nb = b.samples.size();
+					if (na < 2 || nb < 2)
+						return std::nan("");
+					double va = a.variance() / na, vb = b.variance() / nb;
+					double diff = a.mean() - b.mean();
+					if (va + vb == 0.)
+						return (diff == 0.) ? 1. : 0.;
+					double t = diff / std::sqrt(va + vb);
+					double df = (va + vb) * (va + vb) /
+						(va * va / (na - 1) + vb * vb / (nb - 1));
+					return incompleteBeta(df / 2., 0.5, df / (df + t * t));
+				}
+
+				/**
+				 * @param baseline reference run
+				 * @param candidate run compared to the reference
+				 * @param alpha significance level of the test
+				 **/
+				BenchmarkComparison(const BenchmarkResults& baseline,
+					const BenchmarkResults& candidate, double alpha = 0.05)
+					: alpha(alpha) {
+					for (auto& name : baseline.getSeriesNames()) {
+						std::vector<BenchmarkPoint> cand = candidate.getSeries(name);
+						if (cand.empty())
+							continue;
+						std::vector<PointComparison>& out = comparisons[name];
+						for (auto& bp : baseline.getSeries(name)) {
+							for (auto& cp : cand) {
+								if (cp.x != bp.x)
+									continue;
+								PointComparison pc;
+								pc.x = bp.x;
+								pc.baselineMean = bp.mean();
+								pc.candidateMean = cp.mean();
+								pc.speedup = pc.baselineMean / pc.candidateMean;
+								pc.pValue = welchTTest(bp, cp);
+								pc.significant = !std::isnan(pc.pValue) && pc.pValue < alpha;
+								out.push_back(pc);
+							}
+						}
+						std::sort(out.begin(), out.end(),
+						[](const PointComparison & p1, const PointComparison & p2) {
+							return p1.x < p2.x;
+						});
+					}
+				}
+
+				///@return the names of the series present in both runs
+				std::vector<std::string> getSeriesNames() const {
+					std::vector<std::string> ret;
+					for (auto& c : comparisons)
+						ret.push_back(c.first);
+					return ret;
+				}
+
+				///@return the per point comparison of a series
+				std::vector<PointComparison> getComparison(const std::string& seriesName) const {
+					auto it = comparisons.find(seriesName);
+					if (it == comparisons.end())
+						return std::vector<PointComparison>();
+					return it->second;
+				}
+
+				///@return the geometric mean of the speedups of a series
+				double getMeanSpeedup(const std::string& seriesName) const {
+					double logsum = 0.;
+					int count = 0;
+					for (auto& pc : getComparison(seriesName)) {
+						if (pc.speedup > 0. && std::isfinite(pc.speedup)) {
+							logsum += std::log(pc.speedup);
+							count++;
+						}
+					}
+					return count ? std::exp(logsum / count) : std::nan("");
+				}
+
+				/**
+				 * @brief Plots the speedup of each series against the size
+				 *
+				 * @param lc LineChart to add the series to
+				 **/
+				void render(LineChart& lc) const {
+					lc.setXLabel("Size");
+					lc.setYLabel("Speedup (baseline time / candidate time)");
+					for (auto& c : comparisons) {
+						std::vector<double> xdata, ydata;
+						for (auto& pc : c.second) {
+							xdata.push_back(pc.x);
+							ydata.push_back(pc.speedup);
+						}
+						lc.setDataSeries(c.first, xdata, ydata);
+					}
+				}
+
+				/**
+				 * @brief Shows the mean speedup of each series as a bar
+				 *
+				 * @param bc BarChart to fill; it should not have series yet
+				 **/
+				void render(BarChart& bc) const {
+					std::vector<std::string> names = getSeriesNames();
+					std::vector<double> speedups;
+					for (auto& n : names)
+						speedups.push_back(getMeanSpeedup(n));
+					bc.setCategoriesLabel("Series");
+					bc.setValueLabel("Speedup (baseline time / candidate time)");
+					bc.setCategories(names);
+					bc.addDataSeries("speedup", speedups);
+				}
+
+				///@brief prints a human readable table of the comparison
+				void print(std::ostream& out = std::cout) const {
+					for (auto& c : comparisons) {
+						out << c.first << "\n";
+						for (auto& pc : c.second) {
+							out << "  x=" << pc.x
+								<< " baseline=" << pc.baselineMean
+								<< " candidate=" << pc.candidateMean
+								<< " speedup=" << pc.speedup
+								<< " p=" << pc.pValue
+								<< (pc.significant ? " *" : "") << "\n";
+						}
+					}
+				}
+		};
+	}
+}
+
+#endif
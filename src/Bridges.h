@@ -93,6 +93,9 @@ namespace bridges {
 
 			unsigned int lastAssignNum = 0, subAssignNum = 0;
 
+			// visualizations an assignment holds
+			static const unsigned int maxSubAssignments = 99;
+
 			// JSON object - contains the data structure representationa
 			rapidjson::Writer<rapidjson::StringBuffer> json_obj;
 
@@ -278,6 +281,16 @@ namespace bridges {
 			unsigned int getAssignment() const {
 				return assn_num;
 			}
+			/**
+			 *  @return the number of visualizations that can still be
+			 *  posted to the assignment; visualize() posts nothing once
+			 *  its sub-assignments are used up
+			 */
+			unsigned int getSubAssignmentsLeft() const {
+				if (getAssignment() != lastAssignNum)
+					return maxSubAssignments;
+				return subAssignNum < maxSubAssignments ? maxSubAssignments - subAssignNum : 0;
+			}
 			/**
 			 *  Set the assignment number
 			 *
@@ -559,7 +572,7 @@ namespace bridges {
 					lastAssignNum = getAssignment();
 					subAssignNum = 0;
 				}
-				if (subAssignNum == 99) {
+				if (subAssignNum >= maxSubAssignments) {
 					cout << "#sub-assignments limit(99) exceeded, visualization not generated .."
 						<< endl;
 					return;
@@ -652,6 +665,7 @@ namespace bridges {
 					ServerComm::makeRequest(BASE_URL + to_string(getAssignment()) + "." +
 						(subAssignNum > 9 ? "" : "0") + to_string(subAssignNum) + "?apikey=" + getApiKey() +
 						"&username=" + getUserName(), {"Content-Type: text/plain"}, ds_json);
+					ds_handle->representationSent();
 
 					if (post_visualization_link) {
 						cout << "Success: Assignment posted to the server. " << endl
@@ -54,8 +54,8 @@ namespace bridges {
 			}
 			void getPosition (float *p) const {
 				p[0] = position[0];
-				p[1] = position[0];
-				p[2] = position[0];
+				p[1] = position[1];
+				p[2] = position[2];
 			}
 
 	};
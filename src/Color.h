@@ -6,6 +6,9 @@
 #include <regex> //regex
 #include <unordered_map> //unordered_map
 #include <cmath> //log
+#include <cstdint> //uint32_t
+#include <cstring> //memcpy
+#include <algorithm> //min
 
 #include <sstream>
 #include <iomanip>
@@ -45,170 +48,41 @@ namespace bridges {
 		 *
 		 * Default Color is opaque white
 		 *
+		 * A Color is stored as a single packed 32-bit RGBA value (see
+		 * getRGBA()), and the named colors are also available as
+		 * compile-time constants in the colors namespace (colors::red),
+		 * which avoids looking the name up.
+		 *
 		 * @date 7/8/19, Kalpathi Subramanian
 		 */
 		class Color {
 			private:
-				// The named colors' rgba channel value mappings
-				static const unordered_map<string, const array<int, 4 >> &
-				ColorNames() {
-					static unordered_map<string, const array<int, 4 >> cn {
+				// The named colors' packed rgba values, defined after the colors namespace
+				static const unordered_map<string, uint32_t>& ColorNames();
 
-						{	{"aliceblue", {{240, 248, 255, 255}}},
-							{"antiquewhite", {{250, 235, 215, 255}}},
-							{"cyan", {{0, 255, 255, 255}}},
-							{"aquamarine", {{127, 255, 212, 255}}},
-							{"azure", {{240, 255, 255, 255}}},
-							{"beige", {{245, 245, 220, 255}}},
-							{"bisque", {{255, 228, 196, 255}}},
-							{"black", {{0, 0, 0, 255}}},
-							{"blanchedalmond", {{255, 235, 205, 255}}},
-							{"blue", {{0, 0, 255, 255}}},
-							{"blueviolet", {{138, 43, 226, 255}}},
-							{"brown", {{165, 42, 42, 255}}},
-							{"burlywood", {{222, 184, 135, 255}}},
-							{"cadetblue", {{95, 158, 160, 255}}},
-							{"chartreuse", {{127, 255, 0, 255}}},
-							{"chocolate", {{210, 105, 30, 255}}},
-							{"coral", {{255, 127, 80, 255}}},
-							{"cornflowerblue", {{100, 149, 237, 255}}},
-							{"cornsilk", {{255, 248, 220, 255}}},
-							{"crimson", {{220, 20, 60, 255}}},
-							{"darkblue", {{0, 0, 139, 255}}},
-							{"darkcyan", {{0, 139, 139, 255}}},
-							{"darkgoldenrod", {{184, 134, 11, 255}}},
-							{"darkgrey", {{169, 169, 169, 255}}},
-							{"darkgreen", {{0, 100, 0, 255}}},
-							{"darkkhaki", {{189, 183, 107, 255}}},
-							{"darkmagenta", {{139, 0, 139, 255}}},
-							{"darkolivegreen", {{85, 107, 47, 255}}},
-							{"darkorange", {{255, 140, 0, 255}}},
-							{"darkorchid", {{153, 50, 204, 255}}},
-							{"darkred", {{139, 0, 0, 255}}},
-							{"darksalmon", {{233, 150, 122, 255}}},
-							{"darkseagreen", {{143, 188, 143, 255}}},
-							{"darkslateblue", {{72, 61, 139, 255}}},
-							{"darkslategrey", {{47, 79, 79, 255}}},
-							{"darkturquoise", {{0, 206, 209, 255}}},
-							{"darkviolet", {{148, 0, 211, 255}}},
-							{"deeppink", {{255, 20, 147, 255}}},
-							{"deepskyblue", {{0, 191, 255, 255}}},
-							{"dimgrey", {{105, 105, 105, 255}}},
-							{"dodgerblue", {{30, 144, 255, 255}}},
-							{"firebrick", {{178, 34, 34, 255}}},
-							{"floralwhite", {{255, 250, 240, 255}}},
-							{"forestgreen", {{34, 139, 34, 255}}},
-							{"magenta", {{255, 0, 255, 255}}},
-							{"gainsboro", {{220, 220, 220, 255}}},
-							{"ghostwhite", {{248, 248, 255, 255}}},
-							{"gold", {{255, 215, 0, 255}}},
-							{"goldenrod", {{218, 165, 32, 255}}},
-							{"grey", {{128, 128, 128, 255}}},
-							{"green", {{0, 128, 0, 255}}},
-							{"greenyellow", {{173, 255, 47, 255}}},
-							{"honeydew", {{240, 255, 240, 255}}},
-							{"hotpink", {{255, 105, 180, 255}}},
-							{"indianred", {{205, 92, 92, 255}}},
-							{"indigo", {{75, 0, 130, 255}}},
-							{"ivory", {{255, 255, 240, 255}}},
-							{"khaki", {{240, 230, 140, 255}}},
-							{"lavender", {{230, 230, 250, 255}}},
-							{"lavenderblush", {{255, 240, 245, 255}}},
-							{"lawngreen", {{124, 252, 0, 255}}},
-							{"lemonchiffon", {{255, 250, 205, 255}}},
-							{"lightblue", {{173, 216, 230, 255}}},
-							{"lightcoral", {{240, 128, 128, 255}}},
-							{"lightcyan", {{224, 255, 255, 255}}},
-							{"lightgoldenrodyellow", {{250, 250, 210, 255}}},
-							{"lightgrey", {{211, 211, 211, 255}}},
-							{"lightgreen", {{144, 238, 144, 255}}},
-							{"lightpink", {{255, 182, 193, 255}}},
-							{"lightsalmon", {{255, 160, 122, 255}}},
-							{"lightseagreen", {{32, 178, 170, 255}}},
-							{"lightskyblue", {{135, 206, 250, 255}}},
-							{"lightslategrey", {{119, 136, 153, 255}}},
-							{"lightsteelblue", {{176, 196, 222, 255}}},
-							{"lightyellow", {{255, 255, 224, 255}}},
-							{"lime", {{0, 255, 0, 255}}},
-							{"limegreen", {{50, 205, 50, 255}}},
-							{"linen", {{250, 240, 230, 255}}},
-							{"maroon", {{128, 0, 0, 255}}},
-							{"mediumaquamarine", {{102, 205, 170, 255}}},
-							{"mediumblue", {{0, 0, 205, 255}}},
-							{"mediumorchid", {{186, 85, 211, 255}}},
-							{"mediumpurple", {{147, 112, 219, 255}}},
-							{"mediumseagreen", {{60, 179, 113, 255}}},
-							{"mediumslateblue", {{123, 104, 238, 255}}},
-							{"mediumspringgreen", {{0, 250, 154, 255}}},
-							{"mediumturquoise", {{72, 209, 204, 255}}},
-							{"mediumvioletred", {{199, 21, 133, 255}}},
-							{"midnightblue", {{25, 25, 112, 255}}},
-							{"mintcream", {{245, 255, 250, 255}}},
-							{"mistyrose", {{255, 228, 225, 255}}},
-							{"moccasin", {{255, 228, 181, 255}}},
-							{"navajowhite", {{255, 222, 173, 255}}},
-							{"navy", {{0, 0, 128, 255}}},
-							{"oldlace", {{253, 245, 230, 255}}},
-							{"olive", {{128, 128, 0, 255}}},
-							{"olivedrab", {{107, 142, 35, 255}}},
-							{"orange", {{255, 165, 0, 255}}},
-							{"orangered", {{255, 69, 0, 255}}},
-							{"orchid", {{218, 112, 214, 255}}},
-							{"palegoldenrod", {{238, 232, 170, 255}}},
-							{"palegreen", {{152, 251, 152, 255}}},
-							{"paleturquoise", {{175, 238, 238, 255}}},
-							{"palevioletred", {{219, 112, 147, 255}}},
-							{"papayawhip", {{255, 239, 213, 255}}},
-							{"peachpuff", {{255, 218, 185, 255}}},
-							{"peru", {{205, 133, 63, 255}}},
-							{"pink", {{255, 192, 203, 255}}},
-							{"plum", {{221, 160, 221, 255}}},
-							{"powderblue", {{176, 224, 230, 255}}},
-							{"purple", {{128, 0, 128, 255}}},
-							{"red", {{255, 0, 0, 255}}},
-							{"rosybrown", {{188, 143, 143, 255}}},
-							{"royalblue", {{65, 105, 225, 255}}},
-							{"saddlebrown", {{139, 69, 19, 255}}},
-							{"salmon", {{250, 128, 114, 255}}},
-							{"sandybrown", {{244, 164, 96, 255}}},
-							{"seagreen", {{46, 139, 87, 255}}},
-							{"seashell", {{255, 245, 238, 255}}},
-							{"sienna", {{160, 82, 45, 255}}},
-							{"silver", {{192, 192, 192, 255}}},
-							{"skyblue", {{135, 206, 235, 255}}},
-							{"slateblue", {{106, 90, 205, 255}}},
-							{"slategrey", {{112, 128, 144, 255}}},
-							{"snow", {{255, 250, 250, 255}}},
-							{"springgreen", {{0, 255, 127, 255}}},
-							{"steelblue", {{70, 130, 180, 255}}},
-							{"tan", {{210, 180, 140, 255}}},
-							{"teal", {{0, 128, 128, 255}}},
-							{"thistle", {{216, 191, 216, 255}}},
-							{"tomato", {{255, 99, 71, 255}}},
-							{"turquoise", {{64, 224, 208, 255}}},
-							{"violet", {{238, 130, 238, 255}}},
-							{"wheat", {{245, 222, 179, 255}}},
-							{"white", {{255, 255, 255, 255}}},
-							{"whitesmoke", {{245, 245, 245, 255}}},
-							{"yellow", {{255, 255, 0, 255}}},
-							{"yellowgreen", {{154, 205, 50, 255}}}
-						}
-					};
-					return cn;
+				// The rgba channel values of this Color, red in the low byte:
+				// on little-endian machines the bytes are R, G, B, A in memory
+				uint32_t rgba = 0xFFFFFFFFu;
+
+				static constexpr uint32_t pack(int r, int g, int b, int a) {
+					return (uint32_t) r | ((uint32_t) g << 8) | ((uint32_t) b << 16) | ((uint32_t) a << 24);
+				}
+
+				/// @return value if it is a valid channel value
+				/// @throw string if value is not in [0,255]
+				static constexpr int checkChannel(int value) {
+					return (value < 0 || 255 < value)
+						? throw "Invalid channel parameter: " + to_string(value) +
+						" Must be in the [0,255] range"
+						: value;
 				}
 
-				// The rgba channel values of this Color
-				array<int, 4> channels{{255, 255, 255, 255}};
 			public:
 				/**
 				 *  Default constructor
 				 *  Defaults to black
 				 */
-				Color() {
-					setRed(0);
-					setGreen(0);
-					setBlue(0);
-					setAlpha(255);
+				constexpr Color() : rgba(pack(0, 0, 0, 255)) {
 				}
 				/**
 				 * Constructs a color with the specified rgba color channel values [0,255].
@@ -219,8 +93,8 @@ namespace bridges {
 				 * @param b The blue channel
 				 * @param a The alpha channel(default 255)
 				 */
-				Color(const int r, const int g, const int b, const int a = 255) {
-					setValue(r, g, b, a);
+				constexpr Color(const int r, const int g, const int b, const int a = 255)
+					: rgba(pack(checkChannel(r), checkChannel(g), checkChannel(b), checkChannel(a))) {
 				}
 				/**
 				 * Constructs a color from a named color or a "#hexadecimal" [0-F](base 16)
@@ -232,29 +106,45 @@ namespace bridges {
 				Color(const string& name) {
 					setValue(name);
 				}
+				/**
+				 * Constructs a color from its packed value, as returned by getRGBA()
+				 *
+				 * @param rgba red in the low byte, then green, blue and alpha
+				 * @return the color
+				 */
+				static constexpr Color fromRGBA(uint32_t rgba) {
+					return Color(rgba, 0);
+				}
+				/**
+				 * @return the packed value of this color: red in the low byte,
+				 * then green, blue and alpha
+				 */
+				constexpr uint32_t getRGBA() const {
+					return rgba;
+				}
 				/**
 				 * Equality Comparison Operator
 				 * @return True if both Colors represent the same Color, false if not
 				 */
-				bool operator==(const Color& that) const {
-					return channels == that.channels;
+				constexpr bool operator==(const Color& that) const {
+					return rgba == that.rgba;
 				}
 				/**
 				 * Inequality Comparison Operator
 				 * @return False if both Colors represent the same Color, true if not
 				 */
-				bool operator!=(const Color& that) const {
-					return channels != that.channels;
+				constexpr bool operator!=(const Color& that) const {
+					return rgba != that.rgba;
 				}
 				/** @return True if fully opaque, false if not */
-				bool isOpaque()  const {
+				constexpr bool isOpaque()  const {
 					return getAlpha() == 255;
 				}
 				/**
 				 *  Checks for transparency
 				 *	@return True if fully transparent, false if not
 				 */
-				bool isTransparent() const {
+				constexpr bool isTransparent() const {
 					return getAlpha() == 0;
 				}
 
@@ -262,29 +152,29 @@ namespace bridges {
 				 * Get red component
 				 * @return rgba value of the red channel [0,255]
 				 */
-				int getRed() const {
-					return channels.at(0);
+				constexpr int getRed() const {
+					return (int) ((rgba) & 0xFF);
 				}
 				/**
 				 *  Get green component
 				 *	@return rgba value of the green channel [0,255]
 				 */
-				int getGreen() const {
-					return channels.at(1);
+				constexpr int getGreen() const {
+					return (int) ((rgba >> 8) & 0xFF);
 				}
 				/**
 				 *  Get blue component
 				 *	@return rgba value of the blue channel [0,255]
 				 */
-				int getBlue()  const {
-					return channels.at(2);
+				constexpr int getBlue() const {
+					return (int) ((rgba >> 16) & 0xFF);
 				}
 				/**
 				 *  Get alpha component
 				 * @return rgba value of the alpha channel [0,255]
 				 */
-				int getAlpha() const {
-					return channels.at(3);
+				constexpr int getAlpha() const {
+					return (int) (rgba >> 24);
 				}
 
 				/** @return The "#hexadecimal" representation ("#RRGGBBAA") of this color */
@@ -361,20 +251,20 @@ namespace bridges {
 					auto it = ColorNames().find(name);
 
 					if (it != ColorNames().end()) {
-						channels = it->second;   //Named value
+						rgba = it->second;   //Named value
 					}
 					else if (regex_match(name, HEX_RANGE)) { //#Hex value
 						name.erase(0, 1); //removes "#"
 						// alpha value, overwritten if present by loop number
 						// of chars representing a channel
-						channels.at(3) = 255;
+						rgba |= 0xFF000000u;
 						const int chanChars = (name.size() == 3 || name.size() == 4) ? 1 : 2;
 						//unit place scale factor, handles channel size variance
 						const int chanMultiplier = (chanChars == 1) ? 17 : 1;
 						for (size_t i = 0; i < name.size() / chanChars; i++) {
 							//converts and save hex val to rgba val
-							channels.at(i) = (int) strtol(name.substr(i * chanChars,
-										chanChars).c_str(), nullptr, 16) * chanMultiplier;
+							setChannel((int) strtol(name.substr(i * chanChars,
+										chanChars).c_str(), nullptr, 16) * chanMultiplier, (int) i);
 						}
 					}
 					else { //invalid color
@@ -401,18 +291,18 @@ namespace bridges {
 				*
 				*/
 				const string getCSSRepresentation() const {
-					using bridges::JSONUtil::JSONencode;
-					if (this->isTransparent()) {
-						//leaves off other channels if transparent
-						return "[0, 0, 0, 0.0]";
-					}
-					const string strCSS =
-						JSONencode(this->getRed()) + "," +
-						JSONencode(this->getGreen()) + "," +
-						JSONencode(this->getBlue()) + "," +
-						JSONencode( ((float) (this->getAlpha()) / 255.0f));
-
-					return OPEN_BOX + strCSS + CLOSE_BOX;
+					char buf[cssMaxLength];
+					return string(buf, writeCSSRepresentation(buf));
+				}
+				/**
+				* Appends the CSS representation of this color to a string,
+				* without building an intermediate string
+				*
+				* @param out string to append to
+				*/
+				void appendCSSRepresentation(string& out) const {
+					char buf[cssMaxLength];
+					out.append(buf, writeCSSRepresentation(buf));
 				}
 				const void getCSSRepresentation(rapidjson::Document& d) const {
 
@@ -450,12 +340,359 @@ namespace bridges {
 				 * @throw string Throw if value is invalid
 				 */
 				void setChannel(const int& value, const int& channel) {
-					(value < 0 || 255 < value)
-					? throw "Invalid channel parameter: " + to_string(value) +
-					" Must be in the [0,255] range"
-					: channels.at(channel) = value;
+					const int shift = 8 * channel;
+					rgba = (rgba & ~(0xFFu << shift)) | ((uint32_t) checkChannel(value) << shift);
+				}
+
+				/// constructor of fromRGBA(), the int distinguishes it from Color(r, g, b)
+				constexpr Color(uint32_t rgba, int) : rgba(rgba) {
+				}
+
+				/// "[255,255,255," plus the longest alpha
+				static const size_t cssMaxLength = 64;
+
+				/**
+				 * The alpha channel of the CSS representation, as JSONencode
+				 * formats it, for each of the 256 values
+				 */
+				static const array<string, 256>& cssAlpha() {
+					static const array<string, 256> table = []() {
+						array<string, 256> t;
+						for (int a = 0; a < 256; ++a)
+							t[a] = bridges::JSONUtil::JSONencode((float) (a) / 255.0f);
+						return t;
+					}();
+					return table;
+				}
+
+				/// writes a channel in decimal, returns the end of the digits
+				static char* writeChannel(char* p, int v) {
+					if (v >= 100)
+						*p++ = (char) ('0' + v / 100);
+					if (v >= 10)
+						*p++ = (char) ('0' + v / 10 % 10);
+					*p++ = (char) ('0' + v % 10);
+					return p;
+				}
+
+				/// writes getCSSRepresentation() into buf, returns its length
+				size_t writeCSSRepresentation(char* buf) const {
+					if (this->isTransparent()) {
+						//leaves off other channels if transparent
+						static const char transparent[] = "[0, 0, 0, 0.0]";
+						std::memcpy(buf, transparent, sizeof(transparent) - 1);
+						return sizeof(transparent) - 1;
+					}
+					char* p = buf;
+					*p++ = '[';
+					p = writeChannel(p, getRed());
+					*p++ = ',';
+					p = writeChannel(p, getGreen());
+					*p++ = ',';
+					p = writeChannel(p, getBlue());
+					*p++ = ',';
+					const string& alpha = cssAlpha()[getAlpha()];
+					size_t n = std::min(alpha.size(), (size_t) (buf + cssMaxLength - 1 - p));
+					std::memcpy(p, alpha.data(), n);
+					p += n;
+					*p++ = ']';
+					return (size_t) (p - buf);
 				}
 		};//end of color class
+
+		/**
+		 * @brief The named colors supported by Color, as compile-time
+		 * constants
+		 *
+		 * colors::red is the same color as Color("red") without the
+		 * lookup of the name, and can be used in constant expressions.
+		 */
+		namespace colors {
+			constexpr Color aliceblue {240, 248, 255, 255};
+			constexpr Color antiquewhite {250, 235, 215, 255};
+			constexpr Color cyan {0, 255, 255, 255};
+			constexpr Color aquamarine {127, 255, 212, 255};
+			constexpr Color azure {240, 255, 255, 255};
+			constexpr Color beige {245, 245, 220, 255};
+			constexpr Color bisque {255, 228, 196, 255};
+			constexpr Color black {0, 0, 0, 255};
+			constexpr Color blanchedalmond {255, 235, 205, 255};
+			constexpr Color blue {0, 0, 255, 255};
+			constexpr Color blueviolet {138, 43, 226, 255};
+			constexpr Color brown {165, 42, 42, 255};
+			constexpr Color burlywood {222, 184, 135, 255};
+			constexpr Color cadetblue {95, 158, 160, 255};
+			constexpr Color chartreuse {127, 255, 0, 255};
+			constexpr Color chocolate {210, 105, 30, 255};
+			constexpr Color coral {255, 127, 80, 255};
+			constexpr Color cornflowerblue {100, 149, 237, 255};
+			constexpr Color cornsilk {255, 248, 220, 255};
+			constexpr Color crimson {220, 20, 60, 255};
+			constexpr Color darkblue {0, 0, 139, 255};
+			constexpr Color darkcyan {0, 139, 139, 255};
+			constexpr Color darkgoldenrod {184, 134, 11, 255};
+			constexpr Color darkgrey {169, 169, 169, 255};
+			constexpr Color darkgreen {0, 100, 0, 255};
+			constexpr Color darkkhaki {189, 183, 107, 255};
+			constexpr Color darkmagenta {139, 0, 139, 255};
+			constexpr Color darkolivegreen {85, 107, 47, 255};
+			constexpr Color darkorange {255, 140, 0, 255};
+			constexpr Color darkorchid {153, 50, 204, 255};
+			constexpr Color darkred {139, 0, 0, 255};
+			constexpr Color darksalmon {233, 150, 122, 255};
+			constexpr Color darkseagreen {143, 188, 143, 255};
+			constexpr Color darkslateblue {72, 61, 139, 255};
+			constexpr Color darkslategrey {47, 79, 79, 255};
+			constexpr Color darkturquoise {0, 206, 209, 255};
+			constexpr Color darkviolet {148, 0, 211, 255};
+			constexpr Color deeppink {255, 20, 147, 255};
+			constexpr Color deepskyblue {0, 191, 255, 255};
+			constexpr Color dimgrey {105, 105, 105, 255};
+			constexpr Color dodgerblue {30, 144, 255, 255};
+			constexpr Color firebrick {178, 34, 34, 255};
+			constexpr Color floralwhite {255, 250, 240, 255};
+			constexpr Color forestgreen {34, 139, 34, 255};
+			constexpr Color magenta {255, 0, 255, 255};
+			constexpr Color gainsboro {220, 220, 220, 255};
+			constexpr Color ghostwhite {248, 248, 255, 255};
+			constexpr Color gold {255, 215, 0, 255};
+			constexpr Color goldenrod {218, 165, 32, 255};
+			constexpr Color grey {128, 128, 128, 255};
+			constexpr Color green {0, 128, 0, 255};
+			constexpr Color greenyellow {173, 255, 47, 255};
+			constexpr Color honeydew {240, 255, 240, 255};
+			constexpr Color hotpink {255, 105, 180, 255};
+			constexpr Color indianred {205, 92, 92, 255};
+			constexpr Color indigo {75, 0, 130, 255};
+			constexpr Color ivory {255, 255, 240, 255};
+			constexpr Color khaki {240, 230, 140, 255};
+			constexpr Color lavender {230, 230, 250, 255};
+			constexpr Color lavenderblush {255, 240, 245, 255};
+			constexpr Color lawngreen {124, 252, 0, 255};
+			constexpr Color lemonchiffon {255, 250, 205, 255};
+			constexpr Color lightblue {173, 216, 230, 255};
+			constexpr Color lightcoral {240, 128, 128, 255};
+			constexpr Color lightcyan {224, 255, 255, 255};
+			constexpr Color lightgoldenrodyellow {250, 250, 210, 255};
+			constexpr Color lightgrey {211, 211, 211, 255};
+			constexpr Color lightgreen {144, 238, 144, 255};
+			constexpr Color lightpink {255, 182, 193, 255};
+			constexpr Color lightsalmon {255, 160, 122, 255};
+			constexpr Color lightseagreen {32, 178, 170, 255};
+			constexpr Color lightskyblue {135, 206, 250, 255};
+			constexpr Color lightslategrey {119, 136, 153, 255};
+			constexpr Color lightsteelblue {176, 196, 222, 255};
+			constexpr Color lightyellow {255, 255, 224, 255};
+			constexpr Color lime {0, 255, 0, 255};
+			constexpr Color limegreen {50, 205, 50, 255};
+			constexpr Color linen {250, 240, 230, 255};
+			constexpr Color maroon {128, 0, 0, 255};
+			constexpr Color mediumaquamarine {102, 205, 170, 255};
+			constexpr Color mediumblue {0, 0, 205, 255};
+			constexpr Color mediumorchid {186, 85, 211, 255};
+			constexpr Color mediumpurple {147, 112, 219, 255};
+			constexpr Color mediumseagreen {60, 179, 113, 255};
+			constexpr Color mediumslateblue {123, 104, 238, 255};
+			constexpr Color mediumspringgreen {0, 250, 154, 255};
+			constexpr Color mediumturquoise {72, 209, 204, 255};
+			constexpr Color mediumvioletred {199, 21, 133, 255};
+			constexpr Color midnightblue {25, 25, 112, 255};
+			constexpr Color mintcream {245, 255, 250, 255};
+			constexpr Color mistyrose {255, 228, 225, 255};
+			constexpr Color moccasin {255, 228, 181, 255};
+			constexpr Color navajowhite {255, 222, 173, 255};
+			constexpr Color navy {0, 0, 128, 255};
+			constexpr Color oldlace {253, 245, 230, 255};
+			constexpr Color olive {128, 128, 0, 255};
+			constexpr Color olivedrab {107, 142, 35, 255};
+			constexpr Color orange {255, 165, 0, 255};
+			constexpr Color orangered {255, 69, 0, 255};
+			constexpr Color orchid {218, 112, 214, 255};
+			constexpr Color palegoldenrod {238, 232, 170, 255};
+			constexpr Color palegreen {152, 251, 152, 255};
+			constexpr Color paleturquoise {175, 238, 238, 255};
+			constexpr Color palevioletred {219, 112, 147, 255};
+			constexpr Color papayawhip {255, 239, 213, 255};
+			constexpr Color peachpuff {255, 218, 185, 255};
+			constexpr Color peru {205, 133, 63, 255};
+			constexpr Color pink {255, 192, 203, 255};
+			constexpr Color plum {221, 160, 221, 255};
+			constexpr Color powderblue {176, 224, 230, 255};
+			constexpr Color purple {128, 0, 128, 255};
+			constexpr Color red {255, 0, 0, 255};
+			constexpr Color rosybrown {188, 143, 143, 255};
+			constexpr Color royalblue {65, 105, 225, 255};
+			constexpr Color saddlebrown {139, 69, 19, 255};
+			constexpr Color salmon {250, 128, 114, 255};
+			constexpr Color sandybrown {244, 164, 96, 255};
+			constexpr Color seagreen {46, 139, 87, 255};
+			constexpr Color seashell {255, 245, 238, 255};
+			constexpr Color sienna {160, 82, 45, 255};
+			constexpr Color silver {192, 192, 192, 255};
+			constexpr Color skyblue {135, 206, 235, 255};
+			constexpr Color slateblue {106, 90, 205, 255};
+			constexpr Color slategrey {112, 128, 144, 255};
+			constexpr Color snow {255, 250, 250, 255};
+			constexpr Color springgreen {0, 255, 127, 255};
+			constexpr Color steelblue {70, 130, 180, 255};
+			constexpr Color tan {210, 180, 140, 255};
+			constexpr Color teal {0, 128, 128, 255};
+			constexpr Color thistle {216, 191, 216, 255};
+			constexpr Color tomato {255, 99, 71, 255};
+			constexpr Color turquoise {64, 224, 208, 255};
+			constexpr Color violet {238, 130, 238, 255};
+			constexpr Color wheat {245, 222, 179, 255};
+			constexpr Color white {255, 255, 255, 255};
+			constexpr Color whitesmoke {245, 245, 245, 255};
+			constexpr Color yellow {255, 255, 0, 255};
+			constexpr Color yellowgreen {154, 205, 50, 255};
+		}
+
+		inline const unordered_map<string, uint32_t>& Color::ColorNames() {
+			static const unordered_map<string, uint32_t> cn {
+				{
+					{"aliceblue", colors::aliceblue.getRGBA()},
+					{"antiquewhite", colors::antiquewhite.getRGBA()},
+					{"cyan", colors::cyan.getRGBA()},
+					{"aquamarine", colors::aquamarine.getRGBA()},
+					{"azure", colors::azure.getRGBA()},
+					{"beige", colors::beige.getRGBA()},
+					{"bisque", colors::bisque.getRGBA()},
+					{"black", colors::black.getRGBA()},
+					{"blanchedalmond", colors::blanchedalmond.getRGBA()},
+					{"blue", colors::blue.getRGBA()},
+					{"blueviolet", colors::blueviolet.getRGBA()},
+					{"brown", colors::brown.getRGBA()},
+					{"burlywood", colors::burlywood.getRGBA()},
+					{"cadetblue", colors::cadetblue.getRGBA()},
+					{"chartreuse", colors::chartreuse.getRGBA()},
+					{"chocolate", colors::chocolate.getRGBA()},
+					{"coral", colors::coral.getRGBA()},
+					{"cornflowerblue", colors::cornflowerblue.getRGBA()},
+					{"cornsilk", colors::cornsilk.getRGBA()},
+					{"crimson", colors::crimson.getRGBA()},
+					{"darkblue", colors::darkblue.getRGBA()},
+					{"darkcyan", colors::darkcyan.getRGBA()},
+					{"darkgoldenrod", colors::darkgoldenrod.getRGBA()},
+					{"darkgrey", colors::darkgrey.getRGBA()},
+					{"darkgreen", colors::darkgreen.getRGBA()},
+					{"darkkhaki", colors::darkkhaki.getRGBA()},
+					{"darkmagenta", colors::darkmagenta.getRGBA()},
+					{"darkolivegreen", colors::darkolivegreen.getRGBA()},
+					{"darkorange", colors::darkorange.getRGBA()},
+					{"darkorchid", colors::darkorchid.getRGBA()},
+					{"darkred", colors::darkred.getRGBA()},
+					{"darksalmon", colors::darksalmon.getRGBA()},
+					{"darkseagreen", colors::darkseagreen.getRGBA()},
+					{"darkslateblue", colors::darkslateblue.getRGBA()},
+					{"darkslategrey", colors::darkslategrey.getRGBA()},
+					{"darkturquoise", colors::darkturquoise.getRGBA()},
+					{"darkviolet", colors::darkviolet.getRGBA()},
+					{"deeppink", colors::deeppink.getRGBA()},
+					{"deepskyblue", colors::deepskyblue.getRGBA()},
+					{"dimgrey", colors::dimgrey.getRGBA()},
+					{"dodgerblue", colors::dodgerblue.getRGBA()},
+					{"firebrick", colors::firebrick.getRGBA()},
+					{"floralwhite", colors::floralwhite.getRGBA()},
+					{"forestgreen", colors::forestgreen.getRGBA()},
+					{"magenta", colors::magenta.getRGBA()},
+					{"gainsboro", colors::gainsboro.getRGBA()},
+					{"ghostwhite", colors::ghostwhite.getRGBA()},
+					{"gold", colors::gold.getRGBA()},
+					{"goldenrod", colors::goldenrod.getRGBA()},
+					{"grey", colors::grey.getRGBA()},
+					{"green", colors::green.getRGBA()},
+					{"greenyellow", colors::greenyellow.getRGBA()},
+					{"honeydew", colors::honeydew.getRGBA()},
+					{"hotpink", colors::hotpink.getRGBA()},
+					{"indianred", colors::indianred.getRGBA()},
+					{"indigo", colors::indigo.getRGBA()},
+					{"ivory", colors::ivory.getRGBA()},
+					{"khaki", colors::khaki.getRGBA()},
+					{"lavender", colors::lavender.getRGBA()},
+					{"lavenderblush", colors::lavenderblush.getRGBA()},
+					{"lawngreen", colors::lawngreen.getRGBA()},
+					{"lemonchiffon", colors::lemonchiffon.getRGBA()},
+					{"lightblue", colors::lightblue.getRGBA()},
+					{"lightcoral", colors::lightcoral.getRGBA()},
+					{"lightcyan", colors::lightcyan.getRGBA()},
+					{"lightgoldenrodyellow", colors::lightgoldenrodyellow.getRGBA()},
+					{"lightgrey", colors::lightgrey.getRGBA()},
+					{"lightgreen", colors::lightgreen.getRGBA()},
+					{"lightpink", colors::lightpink.getRGBA()},
+					{"lightsalmon", colors::lightsalmon.getRGBA()},
+					{"lightseagreen", colors::lightseagreen.getRGBA()},
+					{"lightskyblue", colors::lightskyblue.getRGBA()},
+					{"lightslategrey", colors::lightslategrey.getRGBA()},
+					{"lightsteelblue", colors::lightsteelblue.getRGBA()},
+					{"lightyellow", colors::lightyellow.getRGBA()},
+					{"lime", colors::lime.getRGBA()},
+					{"limegreen", colors::limegreen.getRGBA()},
+					{"linen", colors::linen.getRGBA()},
+					{"maroon", colors::maroon.getRGBA()},
+					{"mediumaquamarine", colors::mediumaquamarine.getRGBA()},
+					{"mediumblue", colors::mediumblue.getRGBA()},
+					{"mediumorchid", colors::mediumorchid.getRGBA()},
+					{"mediumpurple", colors::mediumpurple.getRGBA()},
+					{"mediumseagreen", colors::mediumseagreen.getRGBA()},
+					{"mediumslateblue", colors::mediumslateblue.getRGBA()},
+					{"mediumspringgreen", colors::mediumspringgreen.getRGBA()},
+					{"mediumturquoise", colors::mediumturquoise.getRGBA()},
+					{"mediumvioletred", colors::mediumvioletred.getRGBA()},
+					{"midnightblue", colors::midnightblue.getRGBA()},
+					{"mintcream", colors::mintcream.getRGBA()},
+					{"mistyrose", colors::mistyrose.getRGBA()},
+					{"moccasin", colors::moccasin.getRGBA()},
+					{"navajowhite", colors::navajowhite.getRGBA()},
+					{"navy", colors::navy.getRGBA()},
+					{"oldlace", colors::oldlace.getRGBA()},
+					{"olive", colors::olive.getRGBA()},
+					{"olivedrab", colors::olivedrab.getRGBA()},
+					{"orange", colors::orange.getRGBA()},
+					{"orangered", colors::orangered.getRGBA()},
+					{"orchid", colors::orchid.getRGBA()},
+					{"palegoldenrod", colors::palegoldenrod.getRGBA()},
+					{"palegreen", colors::palegreen.getRGBA()},
+					{"paleturquoise", colors::paleturquoise.getRGBA()},
+					{"palevioletred", colors::palevioletred.getRGBA()},
+					{"papayawhip", colors::papayawhip.getRGBA()},
+					{"peachpuff", colors::peachpuff.getRGBA()},
+					{"peru", colors::peru.getRGBA()},
+					{"pink", colors::pink.getRGBA()},
+					{"plum", colors::plum.getRGBA()},
+					{"powderblue", colors::powderblue.getRGBA()},
+					{"purple", colors::purple.getRGBA()},
+					{"red", colors::red.getRGBA()},
+					{"rosybrown", colors::rosybrown.getRGBA()},
+					{"royalblue", colors::royalblue.getRGBA()},
+					{"saddlebrown", colors::saddlebrown.getRGBA()},
+					{"salmon", colors::salmon.getRGBA()},
+					{"sandybrown", colors::sandybrown.getRGBA()},
+					{"seagreen", colors::seagreen.getRGBA()},
+					{"seashell", colors::seashell.getRGBA()},
+					{"sienna", colors::sienna.getRGBA()},
+					{"silver", colors::silver.getRGBA()},
+					{"skyblue", colors::skyblue.getRGBA()},
+					{"slateblue", colors::slateblue.getRGBA()},
+					{"slategrey", colors::slategrey.getRGBA()},
+					{"snow", colors::snow.getRGBA()},
+					{"springgreen", colors::springgreen.getRGBA()},
+					{"steelblue", colors::steelblue.getRGBA()},
+					{"tan", colors::tan.getRGBA()},
+					{"teal", colors::teal.getRGBA()},
+					{"thistle", colors::thistle.getRGBA()},
+					{"tomato", colors::tomato.getRGBA()},
+					{"turquoise", colors::turquoise.getRGBA()},
+					{"violet", colors::violet.getRGBA()},
+					{"wheat", colors::wheat.getRGBA()},
+					{"white", colors::white.getRGBA()},
+					{"whitesmoke", colors::whitesmoke.getRGBA()},
+					{"yellow", colors::yellow.getRGBA()},
+					{"yellowgreen", colors::yellowgreen.getRGBA()}
+				}
+			};
+			return cn;
+		}
 	}
 };//end of bridge namespace
 #endif
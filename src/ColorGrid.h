@@ -8,12 +8,34 @@ using namespace std;
 #include "Grid.h"
 #include "Color.h"
 #include "base64.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace bridges {
 	namespace datastructure {
 		/**
 		 * @brief This is a class in BRIDGES for representing an image.
 		 *
+		 * When a ColorGrid is visualized repeatedly to animate an
+		 * algorithm, setDeltaFrames() makes it send only the parts of
+		 * the image that changed since the previous visualization (in
+		 * rectangles of 32 x 32 pixel tiles), with a full keyframe at a
+		 * regular interval or whenever the delta would not be smaller.
+		 *
 		 * @author David Burlinson, Kalpathi Subramanian
 		 *
 		 * There is a tutorial about ColorGrid :
@@ -24,7 +46,36 @@ namespace bridges {
 				int debug() const {
 					return 0;
 				}
-				Color baseColor = Color("black");
+				Color baseColor = colors::black;
+
+				/// side of the tiles compared to find the changed parts of a frame
+				static const int deltaTile = 32;
+
+				bool deltaFrames = false;
+				int keyframeInterval = 30;
+
+				// the frame the viewer has, which deltas are relative to; only
+				// advanced by representationSent(), once a frame was posted
+				mutable std::vector<BYTE> lastFrame;
+				mutable int lastRows = 0;
+				mutable int lastCols = 0;
+				mutable int framesSinceKeyframe = 0;
+
+				// the frame of the last representation, which becomes
+				// lastFrame if it is sent
+				mutable std::vector<BYTE> pendingFrame;
+				mutable bool pendingKeyframe = false;
+				mutable bool pending = false;
+
+				/// copies the delta frame settings, the copy starts with a keyframe
+				void copyDeltaSettings(const ColorGrid& cg) {
+					deltaFrames = cg.deltaFrames;
+					keyframeInterval = cg.keyframeInterval;
+					lastFrame.clear();
+					lastRows = lastCols = 0;
+					framesSinceKeyframe = 0;
+					pending = false;
+				}
 
 				/**
 				 * @brief initializes the grid with the passed color
@@ -34,9 +85,7 @@ namespace bridges {
 				 **/
 				void initializeGrid (const Color& col) {
 					// fill elements with base color
-					for (int i = 0; i < gridSize[0]; i++)
-						for (int j = 0; j < gridSize[1]; j++)
-							grid[i][j] = col;
+					fill(col);
 				}
 
 			public:
@@ -81,22 +130,67 @@ namespace bridges {
 				ColorGrid (const ColorGrid& cg)
 					: Grid<Color> (cg),
 					  baseColor(cg.baseColor) {
+					copyDeltaSettings(cg);
 				}
 
 				ColorGrid& operator= (const ColorGrid& cg) {
 					Grid::operator=(cg);
 
 					this->baseColor = cg.baseColor;
+					copyDeltaSettings(cg);
+
+					return *this;
+				}
+
+				/**
+				 * Move Constructor
+				 **/
+				ColorGrid (ColorGrid&& cg) noexcept
+					: Grid<Color> (std::move(cg)),
+					  baseColor(cg.baseColor) {
+					copyDeltaSettings(cg);
+				}
+
+				ColorGrid& operator= (ColorGrid&& cg) noexcept {
+					Grid::operator=(std::move(cg));
+
+					this->baseColor = cg.baseColor;
+					copyDeltaSettings(cg);
 
 					return *this;
 				}
 
+				/**
+				 * @brief Sends only what changed between two visualizations
+				 *
+				 * The first visualization, and then one every
+				 * keyframeInterval, sends the whole image. The others send
+				 * the rectangles of 32 x 32 tiles that differ from the
+				 * previous visualization of this grid. Delta frames
+				 * require a viewer that supports the "DELTA" encoding.
+				 *
+				 * @param enable true to send delta frames (default is false)
+				 * @param keyframeInterval number of visualizations between two full images
+				 **/
+				void setDeltaFrames(bool enable, int keyframeInterval = 30) {
+					deltaFrames = enable;
+					this->keyframeInterval = std::max(1, keyframeInterval);
+					forceKeyframe();
+				}
+
+				/// @brief the next visualization sends the whole image
+				void forceKeyframe() {
+					lastFrame.clear();
+					lastRows = lastCols = 0;
+					pending = false;
+				}
+
 				/**
 				 *	Get the height of the color grid
 				 *
 				 *	@return the height (number of rows) of the grid
 				 */
-				int getHeight() {
+				int getHeight() const {
 					return gridSize[0];
 				}
 
@@ -105,130 +199,535 @@ namespace bridges {
 				 *
 				 *	@return the width (number of columns) of the grid
 				 */
-				int getWidth() {
+				int getWidth() const {
 					return gridSize[1];
 				}
 
-			private:
+				/**
+				 * @brief Runs f(row, col, pixel) on every pixel, in parallel
+				 *
+				 * The image is split in bands of rows processed on the
+				 * threads of ThreadPool::global(); pixel is a reference to
+				 * the color stored in the grid. f is called concurrently for
+				 * different pixels, so it must not modify shared state
+				 * without synchronization.
+				 *
+				 * \code{.cpp}
+				 * cg.forEachPixel([](int i, int j, Color& c) {
+				 *   c.setRed(255 - c.getRed());
+				 * });
+				 * \endcode
+				 *
+				 * @param f function of the row, the column and the pixel
+				 **/
+				template <typename Func>
+				void forEachPixel(Func f) {
+					const int cols = gridSize[1];
+					forRows([&](int r0, int r1) {
+						for (int i = r0; i < r1; ++i) {
+							Color* row = grid + (size_t) i * cols;
+							for (int j = 0; j < cols; ++j)
+								f(i, j, row[j]);
+						}
+					});
+				}
 
 				/**
-				 * Returns a vector of BYTEs that is a RAW encoding of the ColorGrid
-				 */
-				std::vector<BYTE> getRAWencoding() const {
-					std::vector<BYTE> byte_buf(4 * gridSize[0] * gridSize[1]);
-
-					int k = 0;
-					for (int i = 0; i < gridSize[0]; i++) {
-						for (int j = 0; j < gridSize[1]; j++) {
-							byte_buf[k++] = grid[i][j].getRed();
-							byte_buf[k++] = grid[i][j].getGreen();
-							byte_buf[k++] = grid[i][j].getBlue();
-							byte_buf[k++] = grid[i][j].getAlpha();
+				 * @brief Sets every pixel to f(row, col), in parallel
+				 *
+				 * Same as forEachPixel(), for functions that compute the
+				 * color from the position only (fractals, procedural
+				 * textures, ...).
+				 *
+				 * \code{.cpp}
+				 * cg.transform([&](int i, int j) {
+				 *   return mandelbrot(i, j) ? Color(0, 0, 0) : Color(255, 255, 255);
+				 * });
+				 * \endcode
+				 *
+				 * @param f function of the row and the column returning a Color
+				 **/
+				template <typename Func>
+				void transform(Func f) {
+					const int cols = gridSize[1];
+					forRows([&](int r0, int r1) {
+						for (int i = r0; i < r1; ++i) {
+							Color* row = grid + (size_t) i * cols;
+							for (int j = 0; j < cols; ++j)
+								row[j] = f(i, j);
 						}
-					}
-					return byte_buf;
+					});
+				}
 
+				/**
+				 * @brief Sets a rectangle of pixels to a color
+				 *
+				 * The rectangle is clipped to the grid.
+				 *
+				 * @param row first row of the rectangle
+				 * @param col first column of the rectangle
+				 * @param height number of rows of the rectangle
+				 * @param width number of columns of the rectangle
+				 * @param color color of the rectangle
+				 **/
+				void fillRect(int row, int col, int height, int width, const Color& color) {
+					int r0 = std::max(0, row), r1 = std::min(gridSize[0], row + height);
+					int c0 = std::max(0, col), c1 = std::min(gridSize[1], col + width);
+					if (r0 >= r1 || c0 >= c1)
+						return;
+					const int cols = gridSize[1];
+					forRows(r0, r1, [&](int b, int e) {
+						for (int i = b; i < e; ++i)
+							std::fill(grid + (size_t) i * cols + c0, grid + (size_t) i * cols + c1, color);
+					});
 				}
 
 				/**
-				 * Returns a vector of BYTEs that is an RLE encoding of the ColorGrid
-				 */
-				std::vector<BYTE> getRLEencoding() const {
-					std::vector<BYTE> vec;
+				 * @brief Mixes another image into this one
+				 *
+				 * Each channel (alpha included) becomes
+				 * (1 - alpha) * this + alpha * other, computed in 8-bit
+				 * fixed point.
+				 *
+				 * @param other image of the same dimensions
+				 * @param alpha weight of the other image, in [0, 1]
+				 * @throw std::invalid_argument if the dimensions differ
+				 **/
+				void blend(const ColorGrid& other, double alpha) {
+					if (other.gridSize[0] != gridSize[0] || other.gridSize[1] != gridSize[1])
+						throw std::invalid_argument("ColorGrid::blend: dimensions differ");
+					const int w = (int) std::lround(std::min(1., std::max(0., alpha)) * 256.);
+					const size_t cols = gridSize[1];
+					// every byte of the packed pixels is a channel, so the
+					// blend is the same byte-wise operation on all of them
+					BYTE* dst = reinterpret_cast<BYTE*>(grid);
+					const BYTE* src = reinterpret_cast<const BYTE*>(other.grid);
+					forRows([&](int r0, int r1) {
+						for (size_t k = 4 * r0 * cols; k < 4 * r1 * cols; ++k)
+							dst[k] = (BYTE) ((dst[k] * (256 - w) + src[k] * w + 128) >> 8);
+					});
+				}
 
-					int count = 0;
-					int totalcount = 0;
-					BYTE r, g, b, a;
+				/**
+				 * @brief Colors the image after a scalar field (a heat map)
+				 *
+				 * Values are scaled from [min, max] to the palette, whose
+				 * colors are evenly spaced and linearly interpolated; values
+				 * out of range (or NaN) get the color of the nearest end.
+				 * The palette is sampled in a table of 256 colors.
+				 *
+				 * @param field rows x cols values, row-major
+				 * @param min value mapped to the first color of the palette
+				 * @param max value mapped to the last color of the palette
+				 * @param palette colors of the map, at least one
+				 * @throw std::invalid_argument if the palette is empty
+				 **/
+				void colormap(const double* field, double min, double max,
+					const std::vector<Color>& palette) {
+					const std::vector<Color> lut = colormapTable(palette);
+					const double scale = (max > min) ? 255. / (max - min) : 0.;
+					const int cols = gridSize[1];
+					forRows([&](int r0, int r1) {
+						for (size_t k = (size_t) r0 * cols; k < (size_t) r1 * cols; ++k) {
+							double t = (field[k] - min) * scale;
+							// NaN fails both comparisons and maps to 0
+							int idx = (t > 0.) ? (t < 255. ? (int) (t + 0.5) : 255) : 0;
+							grid[k] = lut[idx];
+						}
+					});
+				}
+
+				/**
+				 * @brief Colors the image after a scalar field (a heat map)
+				 *
+				 * @param field rows x cols values, row-major
+				 * @param min value mapped to the first color of the palette
+				 * @param max value mapped to the last color of the palette
+				 * @param palette colors of the map, from low to high values
+				 * @throw std::invalid_argument if the field does not have
+				 * one value per pixel or the palette is empty
+				 **/
+				void colormap(const std::vector<double>& field, double min, double max,
+					const std::vector<Color>& palette = {Color(0, 0, 255), Color(0, 255, 255),
+							Color(0, 255, 0), Color(255, 255, 0), Color(255, 0, 0)
+					}) {
+					if (field.size() != cellCount())
+						throw std::invalid_argument("ColorGrid::colormap: the field must have one value per pixel");
+					colormap(field.data(), min, max, palette);
+				}
+
+				/**
+				 * @brief Convolves the image with a square kernel
+				 *
+				 * The red, green and blue channels are filtered (alpha is
+				 * kept); pixels beyond the border repeat the border pixels.
+				 * Results are rounded and clamped to [0, 255].
+				 *
+				 * \code{.cpp}
+				 * cg.convolve({1/9., 1/9., 1/9., 1/9., 1/9., 1/9., 1/9., 1/9., 1/9.}, 3); // box blur
+				 * \endcode
+				 *
+				 * @param kernel size x size weights, row-major
+				 * @param size side of the kernel, odd
+				 * @throw std::invalid_argument if size is not odd or does not
+				 * match the number of weights
+				 **/
+				void convolve(const std::vector<double>& kernel, int size) {
+					if (size <= 0 || size % 2 == 0 || kernel.size() != (size_t) size * size)
+						throw std::invalid_argument("ColorGrid::convolve: the kernel must be size x size with an odd size");
+					const int rows = gridSize[0], cols = gridSize[1];
+					const int half = size / 2;
+					const std::vector<Color> src(grid, grid + cellCount());
+
+					// columns of each tap, clamped once instead of per pixel
+					std::vector<int> colIdx((size_t) cols * size);
+					for (int j = 0; j < cols; ++j)
+						for (int kj = 0; kj < size; ++kj)
+							colIdx[(size_t) j * size + kj] = std::min(cols - 1, std::max(0, j + kj - half));
+
+					forRows([&](int r0, int r1) {
+						std::vector<double> acc((size_t) cols * 3);
+						for (int i = r0; i < r1; ++i) {
+							std::fill(acc.begin(), acc.end(), 0.);
+							for (int ki = 0; ki < size; ++ki) {
+								const Color* srow = src.data() + (size_t) std::min(rows - 1, std::max(0, i + ki - half)) * cols;
+								for (int kj = 0; kj < size; ++kj) {
+									const double wt = kernel[(size_t) ki * size + kj];
+									if (wt == 0.)
+										continue;
+									for (int j = 0; j < cols; ++j) {
+										const Color& c = srow[colIdx[(size_t) j * size + kj]];
+										acc[3 * j] += wt * c.getRed();
+										acc[3 * j + 1] += wt * c.getGreen();
+										acc[3 * j + 2] += wt * c.getBlue();
+									}
+								}
+							}
+							Color* row = grid + (size_t) i * cols;
+							for (int j = 0; j < cols; ++j)
+								row[j] = Color(clampChannel(acc[3 * j]), clampChannel(acc[3 * j + 1]),
+										clampChannel(acc[3 * j + 2]), row[j].getAlpha());
+						}
+					});
+				}
 
-					auto commit = [&]() {
-						if (count == 0)
-							return;
+			private:
 
-						totalcount += count;
+				/// pixels per chunk of the parallel kernels
+				static const int kernelGrain = 16384;
 
-						BYTE repeat = (BYTE) (count - 1);
+				/// runs f(firstRow, endRow) on bands of the rows [r0, r1) in parallel
+				template <typename Func>
+				void forRows(int r0, int r1, Func f) {
+					const long rowsPerChunk = std::max(1L, (long) kernelGrain / std::max(1, gridSize[1]));
+					ThreadPool::global().parallelFor(r0, r1, rowsPerChunk, [&](long b, long e) {
+						f((int) b, (int) e);
+					});
+				}
 
-						if (debug() > 1)
-							std::cerr << "RLEencodingstream: " << (int)repeat << " " << (int)r << " " << (int)g << " " << (int)b << " " << (int)a << std::endl;
+				template <typename Func>
+				void forRows(Func f) {
+					forRows(0, gridSize[0], f);
+				}
 
-						vec.push_back(repeat);
-						vec.push_back(r);
-						vec.push_back(g);
-						vec.push_back(b);
-						vec.push_back(a);
+				static int clampChannel(double v) {
+					return v <= 0. ? 0 : (v >= 255. ? 255 : (int) (v + 0.5));
+				}
 
-						count = 0;
-					};
+				/// samples a palette in 256 colors
+				static std::vector<Color> colormapTable(const std::vector<Color>& palette) {
+					if (palette.empty())
+						throw std::invalid_argument("ColorGrid::colormap: empty palette");
+					std::vector<Color> lut(256);
+					const int last = (int) palette.size() - 1;
+					for (int k = 0; k < 256; ++k) {
+						double pos = k / 255. * last;
+						int p = std::min(last, (int) pos);
+						int q = std::min(last, p + 1);
+						double f = pos - p;
+						const Color& a = palette[p];
+						const Color& b = palette[q];
+						lut[k] = Color(
+								(int) std::lround(a.getRed() + f * (b.getRed() - a.getRed())),
+								(int) std::lround(a.getGreen() + f * (b.getGreen() - a.getGreen())),
+								(int) std::lround(a.getBlue() + f * (b.getBlue() - a.getBlue())),
+								(int) std::lround(a.getAlpha() + f * (b.getAlpha() - a.getAlpha())));
+					}
+					return lut;
+				}
 
-					int pos = 0;
-					while (pos < gridSize[0]*gridSize[1]) {
+				/**
+				 * Returns a vector of BYTEs that is a RAW encoding of the ColorGrid
+				 *
+				 * Each pixel is packed as 4 bytes R, G, B, A, so the RAW
+				 * encoding is also an array of 32-bit pixels that can be
+				 * compared in one instruction.
+				 */
+				std::vector<BYTE> getRAWencoding() const {
+					size_t count = (size_t) gridSize[0] * gridSize[1];
+					std::vector<BYTE> byte_buf(4 * count);
+
+					BYTE* out = byte_buf.data();
+					const Color* cells = data();
+					if (littleEndian() && count > 0) {
+						// a packed Color is already R, G, B, A in memory
+						std::memcpy(out, cells, 4 * count);
+						return byte_buf;
+					}
+					for (size_t i = 0; i < count; i++) {
+						out[4 * i] = (BYTE) cells[i].getRed();
+						out[4 * i + 1] = (BYTE) cells[i].getGreen();
+						out[4 * i + 2] = (BYTE) cells[i].getBlue();
+						out[4 * i + 3] = (BYTE) cells[i].getAlpha();
+					}
+					return byte_buf;
 
-						int posX = pos / gridSize[1];
-						int posY = pos % gridSize[1];
-						BYTE lr = grid[posX][posY].getRed();
-						BYTE lg = grid[posX][posY].getGreen();
-						BYTE lb = grid[posX][posY].getBlue();
-						BYTE la = grid[posX][posY].getAlpha();
+				}
 
-						if (count == 0) {
-							count = 1;
-							r = lr;
-							g = lg;
-							b = lb;
-							a = la;
-						}
-						else {
-							if (r == lr &&
-								g == lg &&
-								b == lb &&
-								a == la) { //same color than previous pixel
-								count++;
-							}
-							else { //different color than previous pixel
-								commit();
-								count = 1;
-								r = lr;
-								g = lg;
-								b = lb;
-								a = la;
-							}
-						}
+				static bool littleEndian() {
+					static_assert(sizeof(Color) == 4, "Color must be a packed RGBA value");
+					const uint32_t one = 1;
+					BYTE first;
+					std::memcpy(&first, &one, 1);
+					return first == 1;
+				}
 
-						if (count == 256) {
-							commit();
-						}
+				static int countTrailingZeros(unsigned int v) {
+#if defined(_MSC_VER)
+					unsigned long idx;
+					_BitScanForward(&idx, v);
+					return (int) idx;
+#else
+					return __builtin_ctz(v);
+#endif
+				}
 
-						pos++;
+				/**
+				 * Length of the run of pixels equal to the first one
+				 *
+				 * Compares 8 (AVX2) or 4 (SSE2) pixels at a time when the
+				 * compiler targets these instruction sets.
+				 *
+				 * @param px packed RGBA pixels
+				 * @param n largest run length to report
+				 */
+				static int runLength(const BYTE* px, int n) {
+					uint32_t first;
+					std::memcpy(&first, px, 4);
+					int i = 1;
+#if defined(__AVX2__)
+					__m256i ref8 = _mm256_set1_epi32((int) first);
+					while (i + 8 <= n) {
+						__m256i cur = _mm256_loadu_si256((const __m256i*) (px + 4 * i));
+						unsigned int eq = (unsigned int) _mm256_movemask_ps(
+								_mm256_castsi256_ps(_mm256_cmpeq_epi32(cur, ref8)));
+						if (eq != 0xFF)
+							return i + countTrailingZeros(~eq);
+						i += 8;
+					}
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+					__m128i ref4 = _mm_set1_epi32((int) first);
+					while (i + 4 <= n) {
+						__m128i cur = _mm_loadu_si128((const __m128i*) (px + 4 * i));
+						unsigned int eq = (unsigned int) _mm_movemask_ps(
+								_mm_castsi128_ps(_mm_cmpeq_epi32(cur, ref4)));
+						if (eq != 0xF)
+							return i + countTrailingZeros(~eq);
+						i += 4;
+					}
+#endif
+					for (; i < n; ++i) {
+						uint32_t v;
+						std::memcpy(&v, px + 4 * i, 4);
+						if (v != first)
+							break;
 					}
-					//there could be something uncommitted at this point.
-					commit();
+					return i;
+				}
 
-					if (totalcount != gridSize[0]*gridSize[1])
-						throw "what happened in RLE construction?";
+				/**
+				 * RLE encodes RAW bytes as (run length - 1, R, G, B, A) records
+				 * of at most 256 pixels
+				 *
+				 * @param raw RAW encoding of the grid
+				 * @param limit largest size of the encoding
+				 * @param rle the encoding
+				 * @return false if the encoding would be larger than limit
+				 */
+				bool encodeRLE(const std::vector<BYTE>& raw, size_t limit, std::vector<BYTE>& rle) const {
+					size_t count = raw.size() / 4;
+					rle.resize(std::min(limit, 5 * count));
+
+					BYTE* out = rle.data();
+					size_t len = 0;
+					size_t pos = 0;
+					while (pos < count) {
+						if (len + 5 > limit)
+							return false;
+						int run = runLength(&raw[4 * pos], (int) std::min<size_t>(256, count - pos));
+						out[len] = (BYTE) (run - 1);
+						std::memcpy(out + len + 1, &raw[4 * pos], 4);
+						len += 5;
+						pos += run;
+					}
+					rle.resize(len);
 
 					if (debug())
-						std::cerr << "RLE length: " << vec.size()
-							<< " raw length: " << gridSize[0]*gridSize[1] * 4
-							<< " Compression rate:" << (float)(vec.size()) / (gridSize[0]*gridSize[1] * 4)
+						std::cerr << "RLE length: " << len
+							<< " raw length: " << raw.size()
+							<< " Compression rate:" << (float)(len) / raw.size()
 							<< std::endl;
+					return true;
+				}
+
+				/**
+				 * Returns a vector of BYTEs that is an RLE encoding of the ColorGrid
+				 */
+				std::vector<BYTE> getRLEencoding() const {
+					std::vector<BYTE> vec;
+					encodeRLE(getRAWencoding(), std::numeric_limits<size_t>::max(), vec);
 					return vec;
 				}
 
+				/**
+				 * @brief encodes the changed rectangles of the frame
+				 *
+				 * Each row of 32 x 32 tiles is compared with the previous
+				 * frame, and each span of consecutive changed tiles becomes
+				 * a rectangle [row, col, height, width, encoding, pixels] whose
+				 * pixels are RLE or RAW encoded like a full frame.
+				 *
+				 * @param raw RAW encoding of the frame
+				 * @param limit largest acceptable size of the encoded rectangles
+				 * @param rects JSON array of the rectangles
+				 * @return false if the delta is larger than limit
+				 **/
+				bool encodeDelta(const std::vector<BYTE>& raw, size_t limit, std::string& rects) const {
+					using bridges::JSONUtil::JSONencode;
+					const int tile = deltaTile;
+					int rows = gridSize[0], cols = gridSize[1];
+					size_t stride = 4 * (size_t) cols;
+					int tilesAcross = (cols + tile - 1) / tile;
+					size_t payload = 0;
+					std::vector<BYTE> rectRaw, rectRLE;
+
+					rects = OPEN_BOX;
+					bool first = true;
+					for (int r0 = 0; r0 < rows; r0 += tile) {
+						int h = std::min(tile, rows - r0);
+						std::vector<bool> dirty(tilesAcross, false);
+						for (int t = 0; t < tilesAcross; ++t) {
+							size_t off = 4 * (size_t) t * tile;
+							size_t len = 4 * (size_t) std::min(tile, cols - t * tile);
+							for (int r = r0; r < r0 + h && !dirty[t]; ++r)
+								dirty[t] = std::memcmp(&raw[r * stride + off], &lastFrame[r * stride + off], len) != 0;
+						}
+
+						for (int t = 0; t < tilesAcross; ) {
+							if (!dirty[t]) {
+								++t;
+								continue;
+							}
+							int t1 = t;
+							while (t1 < tilesAcross && dirty[t1])
+								++t1;
+							int c0 = t * tile;
+							int w = std::min(t1 * tile, cols) - c0;
+							t = t1;
+
+							rectRaw.resize(4 * (size_t) h * w);
+							for (int r = 0; r < h; ++r)
+								std::memcpy(&rectRaw[4 * (size_t) r * w], &raw[(r0 + r) * stride + 4 * (size_t) c0], 4 * (size_t) w);
+							bool isRLE = encodeRLE(rectRaw, rectRaw.size(), rectRLE);
+							const std::vector<BYTE>& bytes = isRLE ? rectRLE : rectRaw;
+							payload += bytes.size();
+							if (payload > limit)
+								return false;
+
+							if (!first)
+								rects += COMMA;
+							first = false;
+							rects += OPEN_BOX + JSONencode(r0) + COMMA + JSONencode(c0) + COMMA +
+								JSONencode(h) + COMMA + JSONencode(w) + COMMA +
+								QUOTE + (isRLE ? "RLE" : "RAW") + QUOTE + COMMA +
+								QUOTE + base64::encode(bytes.data(), bytes.size()) + QUOTE + CLOSE_BOX;
+						}
+					}
+					rects += CLOSE_BOX;
+					return true;
+				}
+
+				/**
+				 * The viewer now has the frame of the last representation,
+				 * which the next deltas are relative to. Called by
+				 * Bridges::visualize() once the frame is posted, so a
+				 * representation that is not sent (a failed post, a
+				 * benchmark, a debug dump) does not move the baseline.
+				 *
+				 * Only call it after a successful post: it is const but
+				 * replaces the mutable baseline, and calling it for a frame
+				 * the viewer did not get makes every following delta
+				 * relative to the wrong image.
+				 **/
+				virtual void representationSent() const override {
+					if (!pending)
+						return;
+					pending = false;
+					lastFrame.swap(pendingFrame);
+					if (pendingKeyframe) {
+						lastRows = gridSize[0];
+						lastCols = gridSize[1];
+						framesSinceKeyframe = 0;
+					}
+					else
+						++framesSinceKeyframe;
+				}
+
 				//public:
 				/**
 				 * get the JSON representation of the color grid
 				 *
+				 * With delta frames, the representation is relative to the
+				 * last frame sent by Bridges::visualize(); producing it does
+				 * not change what the next one is relative to.
+				 *
 				 * @return the JSON representation of the color grid
 				 **/
 				virtual const string getDataStructureRepresentation () const override {
 					using bridges::JSONUtil::JSONencode;
 
-					// Maintain a bytebuffer for the byte representations of each grid color
-					std::vector<BYTE> byte_buf = getRLEencoding();
+					// Pack the pixels once; the RLE pass stops as soon as it
+					// gets larger than the packed pixels, which are sent RAW
+					std::vector<BYTE> raw = getRAWencoding();
+
+					if (deltaFrames) {
+						bool keyframe = lastRows != gridSize[0] || lastCols != gridSize[1]
+							|| framesSinceKeyframe + 1 >= keyframeInterval;
+						std::string rects;
+						// a delta larger than half the RAW frame is sent as a keyframe
+						if (!keyframe && encodeDelta(raw, raw.size() / 2, rects)) {
+							pendingFrame.swap(raw);
+							pendingKeyframe = false;
+							pending = true;
+							return QUOTE + "encoding" + QUOTE + COLON + QUOTE + "DELTA" + QUOTE + COMMA +
+								QUOTE + "dimensions" + QUOTE + COLON +
+								OPEN_BOX + JSONencode(gridSize[0]) + COMMA + JSONencode(gridSize[1]) +
+								CLOSE_BOX + COMMA +
+								QUOTE + "rects" + QUOTE + COLON + rects +
+								CLOSE_CURLY;
+						}
+						pendingFrame = raw;
+						pendingKeyframe = true;
+						pending = true;
+					}
+
+					std::vector<BYTE> rle;
 					std::string encoding = "RLE";
-					if ((int)(byte_buf.size()) > gridSize[0]*gridSize[1] * 4) {
+					const std::vector<BYTE>* byte_buf = &rle;
+					if (!encodeRLE(raw, raw.size(), rle)) {
 						encoding = "RAW";
-						byte_buf = getRAWencoding();
+						byte_buf = &raw;
 						if (debug())
 							std::cerr << "encoding ColorGrid as RAW" << std::endl;
 					}
@@ -248,7 +747,7 @@ namespace bridges {
 
 						QUOTE + "nodes" + QUOTE + COLON +
 						OPEN_BOX + QUOTE +
-						base64::encode (&(byte_buf[0]), byte_buf.size()) +
+						base64::encode (byte_buf->data(), byte_buf->size()) +
 						QUOTE + CLOSE_BOX +
 						CLOSE_CURLY;
 
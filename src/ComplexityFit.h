@@ -0,0 +1,396 @@
+#ifndef COMPLEXITY_FIT_H
+#define COMPLEXITY_FIT_H
+
+#include <LineChart.h>
+#include <BenchmarkResults.h>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace bridges {
+	namespace benchmark {
+		using namespace bridges::datastructure;
+
+		/**
+		 * @brief A complexity model fitted on benchmark measurements
+		 *
+		 * The runtime is modeled as t = a + b * f(n), or t = a + b * n + c * m
+		 * for the "n + m" model of graph algorithms, where n is the
+		 * number of vertices and m the number of edges. The "n^k" model
+		 * is t = a + b * n^k and also fits the exponent k.
+		 **/
+		struct FittedModel {
+			/// name of the model, "n", "n log n", "n^2", "n^3", "n^k" or "n + m"
+			std::string name;
+			/// a, b (and c for "n + m")
+			std::vector<double> coefficients;
+			/// k of the "n^k" model, 0 for the other models
+			double exponent;
+			/// root mean square of the relative error of the fit
+			double error;
+			/// Akaike information criterion of the fit, lower is better
+			double aic;
+
+			/// @return the runtime predicted by the model for size n (and m edges)
+			double evaluate(double n, double m = 0.) const {
+				if (name == "n^k")
+					return coefficients[0] + coefficients[1] * std::pow(n, exponent);
+				if (name == "n + m")
+					return coefficients[0] + coefficients[1] * n + coefficients[2] * m;
+				return coefficients[0] + coefficients[1] * basis(name, n);
+			}
+
+			/// @return a formula such as "t = 1.2e-09 * n log n + 3e-06"
+			std::string toString() const {
+				std::ostringstream oss;
+				oss << "t = ";
+				if (name == "n^k")
+					oss << coefficients[1] << " * n^" << exponent << " + " << coefficients[0];
+				else if (name == "n + m")
+					oss << coefficients[1] << " * n + " << coefficients[2]
+						<< " * m + " << coefficients[0];
+				else
+					oss << coefficients[1] << " * " << name << " + " << coefficients[0];
+				return oss.str();
+			}
+
+			/// @return f(n) of the model of that name
+			static double basis(const std::string& name, double n) {
+				if (name == "n")
+					return n;
+				if (name == "n log n")
+					return n * std::log2(std::max(n, 1.));
+				if (name == "n^2")
+					return n * n;
+				if (name == "n^3")
+					return n * n * n;
+				throw std::runtime_error("unknown complexity model " + name);
+			}
+		};
+
+		/**
+		 * @brief Fits complexity models on benchmark measurements
+		 *
+		 * Each candidate model is fitted by least squares on the relative
+		 * error (runtimes span several orders of magnitude, so an
+		 * absolute fit would only care about the largest sizes). The
+		 * models are ranked by the Akaike information criterion, which
+		 * penalizes the extra parameter of "n^k" and "n + m": n^1.1 fits
+		 * an n log n runtime about as well as n log n does, but the
+		 * simpler model is reported as the best one.
+		 *
+		 * Points whose time is not positive, such as runs too short for
+		 * the clock, are left out of the fit (see getDroppedPoints());
+		 * at least 3 points must remain.
+		 *
+		 * A typical use would look something like
+		 *
+		 * \code{.cpp}
+		 * LineChart lc;
+		 * SortingBenchmark sb (lc);
+		 * sb.run("mysortingalgorithm", mysort);
+		 * ComplexityFit fit (lc, "mysortingalgorithm");
+		 * std::cout << fit.getBestModel().toString() << std::endl;
+		 * fit.render(lc, "mysortingalgorithm");
+		 * \endcode
+		 **/
+		class ComplexityFit {
+			private:
+				std::vector<double> sizes;
+				std::vector<double> edges;
+				std::vector<double> times;
+				std::vector<FittedModel> models;
+				size_t dropped = 0;
+
+				/// solves the k x k system a x = b in place (Gaussian elimination with partial pivoting)
+				static bool solve(std::vector<std::vector<double>>& a, std::vector<double>& b) {
+					size_t k = b.size();
+					for (size_t col = 0; col < k; ++col) {
+						size_t piv = col;
+						for (size_t r = col + 1; r < k; ++r)
+							if (std::fabs(a[r][col]) > std::fabs(a[piv][col]))
+								piv = r;
+						if (std::fabs(a[piv][col]) < 1e-300)
+							return false;
+						std::swap(a[piv], a[col]);
+						std::swap(b[piv], b[col]);
+						for (size_t r = col + 1; r < k; ++r) {
+							double f = a[r][col] / a[col][col];
+							for (size_t c = col; c < k; ++c)
+								a[r][c] -= f * a[col][c];
+							b[r] -= f * b[col];
+						}
+					}
+					for (size_t col = k; col-- > 0;) {
+						for (size_t c = col + 1; c < k; ++c)
+							b[col] -= a[col][c] * b[c];
+						b[col] /= a[col][col];
+					}
+					return true;
+				}
+
+				/**
+				 * @brief least squares of t on the given regressors,
+				 * weighted by 1/t^2 to minimize the relative error
+				 *
+				 * @return the coefficients, empty if the system is singular
+				 **/
+				std::vector<double> weightedFit(const std::vector<std::vector<double>>& regressors) const {
+					size_t k = regressors.size();
+					std::vector<std::vector<double>> ata(k, std::vector<double>(k, 0.));
+					std::vector<double> atb(k, 0.);
+					for (size_t i = 0; i < times.size(); ++i) {
+						double w = 1. / (times[i] * times[i]);
+						for (size_t r = 0; r < k; ++r) {
+							for (size_t c = 0; c < k; ++c)
+								ata[r][c] += w * regressors[r][i] * regressors[c][i];
+							atb[r] += w * regressors[r][i] * times[i];
+						}
+					}
+					if (!solve(ata, atb))
+						return std::vector<double>();
+					return atb;
+				}
+
+				/// computes the error and AIC of a model with p parameters
+				void score(FittedModel& m, int p) const {
+					double rss = 0.;
+					for (size_t i = 0; i < times.size(); ++i) {
+						double rel = (m.evaluate(sizes[i], edges.empty() ? 0. : edges[i]) - times[i]) / times[i];
+						rss += rel * rel;
+					}
+					double n = (double) times.size();
+					m.error = std::sqrt(rss / n);
+					m.aic = n * std::log(std::max(rss / n, 1e-300)) + 2. * p;
+				}
+
+				void fitLinearModel(const std::string& name) {
+					std::vector<std::vector<double>> reg(2);
+					for (double n : sizes) {
+						reg[0].push_back(1.);
+						reg[1].push_back(FittedModel::basis(name, n));
+					}
+					std::vector<double> coef = weightedFit(reg);
+					if (coef.empty() || coef[1] <= 0.)
+						return;
+					FittedModel m;
+					m.name = name;
+					m.coefficients = coef;
+					m.exponent = 0.;
+					score(m, 2);
+					models.push_back(m);
+				}
+
+				/// t = a + b * n^k, k searched on a grid of step 0.01 in [0.5; 4]
+				void fitPowerModel() {
+					FittedModel best;
+					best.aic = std::numeric_limits<double>::max();
+					for (int step = 50; step <= 400; ++step) {
+						double k = step / 100.;
+						std::vector<std::vector<double>> reg(2);
+						for (double n : sizes) {
+							reg[0].push_back(1.);
+							reg[1].push_back(std::pow(n, k));
+						}
+						std::vector<double> coef = weightedFit(reg);
+						if (coef.empty() || coef[1] <= 0.)
+							continue;
+						FittedModel m;
+						m.name = "n^k";
+						m.coefficients = coef;
+						m.exponent = k;
+						score(m, 3);
+						if (m.aic < best.aic)
+							best = m;
+					}
+					if (best.aic < std::numeric_limits<double>::max())
+						models.push_back(best);
+				}
+
+				void fitGraphModel() {
+					std::vector<std::vector<double>> reg(3);
+					for (size_t i = 0; i < sizes.size(); ++i) {
+						reg[0].push_back(1.);
+						reg[1].push_back(sizes[i]);
+						reg[2].push_back(edges[i]);
+					}
+					std::vector<double> coef = weightedFit(reg);
+					if (coef.empty() || coef[1] < 0. || coef[2] < 0.)
+						return;
+					FittedModel m;
+					m.name = "n + m";
+					m.coefficients = coef;
+					m.exponent = 0.;
+					score(m, 3);
+					models.push_back(m);
+				}
+
+				/// drops the points whose size, edge count or time is not
+				/// positive (or NaN): a run too fast for the clock measures 0
+				/// and has no relative error
+				void dropInvalidPoints() {
+					size_t kept = 0;
+					for (size_t i = 0; i < times.size(); ++i) {
+						if (!(sizes[i] > 0.) || !(times[i] > 0.) || !std::isfinite(times[i])
+							|| (!edges.empty() && !(edges[i] >= 0.))) {
+							++dropped;
+							continue;
+						}
+						sizes[kept] = sizes[i];
+						times[kept] = times[i];
+						if (!edges.empty())
+							edges[kept] = edges[i];
+						++kept;
+					}
+					sizes.resize(kept);
+					times.resize(kept);
+					if (!edges.empty())
+						edges.resize(kept);
+				}
+
+				void fitAll() {
+					if (sizes.size() != times.size() || (!edges.empty() && edges.size() != times.size()))
+						throw std::runtime_error("sizes and times of different lengths");
+					dropInvalidPoints();
+					if (times.size() < 3)
+						throw std::runtime_error("at least 3 points with a positive size and time are needed to fit a complexity");
+
+					fitLinearModel("n");
+					fitLinearModel("n log n");
+					fitLinearModel("n^2");
+					fitLinearModel("n^3");
+					fitPowerModel();
+					if (!edges.empty())
+						fitGraphModel();
+					if (models.empty())
+						throw std::runtime_error("no complexity model fits the data");
+
+					std::sort(models.begin(), models.end(),
+					[](const FittedModel & a, const FittedModel & b) {
+						return a.aic < b.aic;
+					});
+				}
+
+			public:
+				/**
+				 * @brief fits the models on runtimes measured for several sizes
+				 *
+				 * @param sizes sizes of the runs (n)
+				 * @param times runtimes of the runs, in seconds
+				 **/
+				ComplexityFit(const std::vector<double>& sizes, const std::vector<double>& times)
+					: sizes(sizes), times(times) {
+					fitAll();
+				}
+
+				/**
+				 * @brief fits the models on runtimes of graph algorithms,
+				 * including the "n + m" model
+				 *
+				 * @param vertices number of vertices of each graph (n)
+				 * @param edges number of edges of each graph (m)
+				 * @param times runtimes of the runs, in seconds
+				 **/
+				ComplexityFit(const std::vector<double>& vertices, const std::vector<double>& edges,
+					const std::vector<double>& times)
+					: sizes(vertices), edges(edges), times(times) {
+					fitAll();
+				}
+
+				/**
+				 * @brief fits the models on a series of a LineChart, such as
+				 * the ones produced by SortingBenchmark
+				 *
+				 * @param lc chart holding the series
+				 * @param series name of the series
+				 **/
+				ComplexityFit(LineChart& lc, const std::string& series)
+					: sizes(lc.getXData(series)), times(lc.getYData(series)) {
+					fitAll();
+				}
+
+				/**
+				 * @brief fits the models on the medians of recorded
+				 * measurements
+				 *
+				 * @param points a series of BenchmarkResults
+				 **/
+				ComplexityFit(const std::vector<BenchmarkPoint>& points) {
+					for (auto& p : points) {
+						sizes.push_back(p.x);
+						times.push_back(p.median());
+					}
+					fitAll();
+				}
+
+				///@return the number of points left out of the fit because
+				/// their size or time was not positive
+				size_t getDroppedPoints() const {
+					return dropped;
+				}
+
+				///@return the fitted models, best first
+				const std::vector<FittedModel>& getModels() const {
+					return models;
+				}
+
+				///@return the model of lowest AIC
+				const FittedModel& getBestModel() const {
+					return models.front();
+				}
+
+				/**
+				 * @brief the fitted model of that name
+				 *
+				 * @param name "n", "n log n", "n^2", "n^3", "n^k" or "n + m"
+				 **/
+				const FittedModel& getModel(const std::string& name) const {
+					for (auto& m : models)
+						if (m.name == name)
+							return m;
+					throw std::runtime_error("model " + name + " was not fitted");
+				}
+
+				/**
+				 * @brief overlays the best fitted model on a LineChart
+				 *
+				 * The fitted series is evaluated on the measured points and
+				 * named after the measured series and the model, for
+				 * instance "quicksort (n log n)". For graphs the x axis is
+				 * the one the benchmark used, the number of edges.
+				 *
+				 * @param lc chart to add the series to
+				 * @param series name of the measured series
+				 **/
+				void render(LineChart& lc, const std::string& series) const {
+					render(lc, series, getBestModel());
+				}
+
+				/// overlays a given fitted model on a LineChart
+				void render(LineChart& lc, const std::string& series, const FittedModel& m) const {
+					std::vector<double> xdata, ydata;
+					for (size_t i = 0; i < times.size(); ++i) {
+						xdata.push_back(edges.empty() ? sizes[i] : edges[i]);
+						ydata.push_back(m.evaluate(sizes[i], edges.empty() ? 0. : edges[i]));
+					}
+					lc.setDataSeries(series + " (" + m.name + ")", xdata, ydata);
+				}
+
+				/// prints the fitted models, best first
+				void print(std::ostream& out = std::cout) const {
+					for (auto& m : models) {
+						out << m.name << ": " << m.toString()
+							<< " error=" << m.error * 100. << "%"
+							<< " aic=" << m.aic << "\n";
+					}
+				}
+		};
+	}
+}
+
+#endif
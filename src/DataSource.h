@@ -34,6 +34,7 @@ using namespace std;
 #include <ServerComm.h>
 #include <Bridges.h>
 #include "rapidjson/document.h"
+#include "rapidjson/reader.h"
 #include <rapidjson/istreamwrapper.h>
 #include "assert.h"
 #include "rapidjson/error/en.h"
@@ -1306,6 +1307,150 @@ namespace bridges {
 				return gr;
 			}
 
+		private:
+			/**
+			 * Decodes the base64 RAW pixels of a ColorGrid straight into
+			 * its buffer; on little-endian machines the R, G, B, A bytes
+			 * are already the packed Colors.
+			 **/
+			static void decodeColorGridRAW(bridges::ColorGrid& cg, const char* b64, size_t len) {
+				const size_t count = (size_t) cg.getHeight() * cg.getWidth();
+				const size_t bytes = 4 * count;
+				BYTE* out = reinterpret_cast<BYTE*>(cg.data());
+
+				// whole quads that fit in the grid are decoded in place, the
+				// last ones through a small buffer
+				size_t quads = std::min(len / 4, bytes / 3);
+				size_t got = bridges::base64::decode(b64, 4 * quads, out);
+				if (got == 3 * quads && got < bytes) {
+					std::vector<BYTE> tail(bridges::base64::decodedLength(len - 4 * quads));
+					size_t more = bridges::base64::decode(b64 + 4 * quads, len - 4 * quads, tail.data());
+					more = std::min(more, bytes - got);
+					std::memcpy(out + got, tail.data(), more);
+					got += more;
+				}
+				if (got < bytes)
+					throw "Malformed ColorGrid JSON: nodes is smaller than expected";
+
+				const uint32_t probe = 1;
+				BYTE firstByte;
+				std::memcpy(&firstByte, &probe, 1);
+				if (firstByte != 1) {
+					bridges::Color* px = cg.data();
+					for (size_t i = 0; i < count; ++i) {
+						const BYTE* b = out + 4 * i;
+						px[i] = bridges::Color::fromRGBA((uint32_t) b[0] | ((uint32_t) b[1] << 8)
+								| ((uint32_t) b[2] << 16) | ((uint32_t) b[3] << 24));
+					}
+				}
+			}
+
+			/**
+			 * Decodes the base64 RLE pixels of a ColorGrid: records of
+			 * (count - 1, r, g, b, a) filled as runs in its buffer
+			 **/
+			static void decodeColorGridRLE(bridges::ColorGrid& cg, const char* b64, size_t len) {
+				std::vector<BYTE> decoded(bridges::base64::decodedLength(len));
+				decoded.resize(bridges::base64::decode(b64, len, decoded.data()));
+				if (decoded.size() % 5 != 0)
+					throw "Malformed ColorGrid JSON: nodes is not a multiple of 5";
+
+				const size_t count = (size_t) cg.getHeight() * cg.getWidth();
+				bridges::Color* px = cg.data();
+				size_t pos = 0;
+				for (size_t k = 0; k < decoded.size(); k += 5) {
+					const BYTE* rec = decoded.data() + k;
+					size_t run = (size_t) rec[0] + 1;
+					if (run > count - pos)
+						throw "Malformed ColorGrid JSON: Too much data in nodes";
+					bridges::Color c = bridges::Color::fromRGBA((uint32_t) rec[1] | ((uint32_t) rec[2] << 8)
+							| ((uint32_t) rec[3] << 16) | ((uint32_t) rec[4] << 24));
+					std::fill(px + pos, px + pos + run, c);
+					pos += run;
+				}
+				if (pos != count)
+					throw "Malformed ColorGrid JSON: Not enough data in nodes";
+			}
+
+			/**
+			 * SAX handler picking the fields of a ColorGrid assignment:
+			 * assignment_type, and the encoding, dimensions and first
+			 * nodes string of data[0]. The document is never built; with
+			 * an in situ parse the nodes string points into the response.
+			 **/
+			struct ColorGridHandler
+				: rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ColorGridHandler> {
+				/// an object or array being parsed, with its current key or index
+				struct Frame {
+					bool array;
+					size_t index;
+					std::string key;
+				};
+				std::vector<Frame> stack;
+
+				std::string assignmentType, encoding;
+				int dims[2] = {-1, -1};
+				const char* nodes = nullptr;
+				size_t nodesLength = 0;
+
+				/// inside the object data[0], at key, depth levels below it
+				bool inData(const char* key, size_t depth) const {
+					return stack.size() == 3 + depth && stack[0].key == "data"
+						&& stack[1].array && stack[1].index == 0
+						&& !stack[2].array && stack[2].key == key;
+				}
+
+				/// a value ended, the next one of an array has the next index
+				bool next() {
+					if (!stack.empty() && stack.back().array)
+						++stack.back().index;
+					return true;
+				}
+
+				bool Uint(unsigned v) {
+					if (inData("dimensions", 1) && stack[3].array && stack[3].index < 2
+						&& v <= (unsigned) std::numeric_limits<int>::max())
+						dims[stack[3].index] = (int) v;
+					return next();
+				}
+				bool String(const char* str, rapidjson::SizeType len, bool) {
+					if (stack.size() == 1 && stack[0].key == "assignment_type")
+						assignmentType.assign(str, len);
+					else if (inData("encoding", 0))
+						encoding.assign(str, len);
+					else if (inData("nodes", 1) && stack[3].array && stack[3].index == 0) {
+						nodes = str;
+						nodesLength = len;
+					}
+					return next();
+				}
+				bool Key(const char* str, rapidjson::SizeType len, bool) {
+					stack.back().key.assign(str, len);
+					return true;
+				}
+				bool StartObject() {
+					stack.push_back({false, 0, std::string()});
+					return true;
+				}
+				bool EndObject(rapidjson::SizeType) {
+					stack.pop_back();
+					return next();
+				}
+				bool StartArray() {
+					stack.push_back({true, 0, std::string()});
+					return true;
+				}
+				bool EndArray(rapidjson::SizeType) {
+					stack.pop_back();
+					return next();
+				}
+				/// other values (negative or non-integer numbers, booleans, null)
+				bool Default() {
+					return next();
+				}
+			};
+
+		public:
 			/**Reconstruct a ColorGrid from an existing ColorGrid on the Bridges server
 			 *
 			 * @return the ColorGrid stored in the bridges server
@@ -1316,124 +1461,49 @@ namespace bridges {
 			bridges::ColorGrid getColorGridFromAssignment(const std::string& user,
 				int assignment,
 				int subassignment = 0) {
+				return getColorGridFromJSON(this->getAssignment(user, assignment, subassignment));
+			}
 
-				std::string s = this->getAssignment(user, assignment, subassignment);
-
-				rapidjson::Document doc;
-				doc.Parse(s.c_str());
-				if (doc.HasParseError())
+			/**Reconstruct a ColorGrid from the JSON of a ColorGrid assignment
+			 *
+			 * The JSON is parsed in place with a SAX handler that keeps
+			 * only the fields of the grid, so no document is built and
+			 * the base64 pixels are never copied; they are decoded
+			 * straight into the buffer of the ColorGrid.
+			 *
+			 * @return the ColorGrid of the assignment
+			 * @param json the assignment, as stored by the Bridges server
+			 **/
+			bridges::ColorGrid getColorGridFromJSON(std::string json) {
+				ColorGridHandler h;
+				rapidjson::InsituStringStream in(&json[0]);
+				rapidjson::Reader reader;
+				// the strings h points to are in json
+				if (!reader.Parse<rapidjson::kParseInsituFlag>(in, h))
 					throw "Malformed JSON";
 
-				try {
-					std::string assignment_type = doc["assignment_type"].GetString();
-
-					if (assignment_type != "ColorGrid")
-						throw "Malformed ColorGrid JSON: Not a ColorGrid";
-				}
-				catch (rapidjson_exception re) {
+				if (h.assignmentType.empty())
 					throw "Malformed JSON: Not a Bridges assignment?";
-				}
-
-				try {
-					auto& data = doc["data"][0];
-
-					std::string encoding = data["encoding"].GetString();
-					if (encoding != "RAW" && encoding != "RLE")
-						throw "Malformed ColorGrid JSON: encoding not supported";
-
-					//Access doc["data"][0]["dimensions"]
-					const auto& dimensions = data["dimensions"];
-					int dimx = dimensions[0].GetInt();
-					int dimy = dimensions[1].GetInt();
-
-					if (debug())
-						std::cerr << "Dimensions: " << dimx << "x" << dimy << std::endl;
-
-					//Access doc["data"][0]["nodes"][0]
-					std::string base64_encoded_assignment = data["nodes"][0].GetString();
-
-					std::vector<bridges::BYTE> decoded = bridges::base64::decode(base64_encoded_assignment);
-
-					bridges::ColorGrid cg (dimx, dimy);
-
-					if (encoding == "RAW") {
-						if (debug())
-							std::cerr << "decoding RAW" << std::endl;
-						if (debug())
-							std::cerr << "length: " << decoded.size() << std::endl;
-						if (decoded.size() < dimx * dimy * 4)
-							throw "Malformed ColorGrid JSON: nodes is smaller than expected";
-
-						//first pixel
-						//std::cerr<<(int)decoded[0]<<" "<<(int)decoded[1]<<" "<<(int)decoded[2]<<" "<<(int)decoded[3]<<std::endl;
-
-						//bridges::ColorGrid* ptr = new bridges::ColorGrid (dimx, dimy);
-
-						size_t base = 0;
-
-						for (int x = 0; x < dimx; ++x) {
-							for (int y = 0; y < dimy; ++y) {
-								bridges::Color c ((int)decoded[base],
-									(int)decoded[base + 1],
-									(int)decoded[base + 2],
-									(int)decoded[base + 3]
-								);
-
-								cg.set(x, y, c);
-								base += 4;
-							}
-						}
-					}
-					else if (encoding == "RLE") {
-						if (debug())
-							std::cerr << "Decoding RLE" << std::endl;
+				if (h.assignmentType != "ColorGrid")
+					throw "Malformed ColorGrid JSON: Not a ColorGrid";
+				if (h.encoding.empty() || h.dims[0] < 0 || h.dims[1] < 0 || h.nodes == nullptr)
+					throw "Malformed ColorGrid JSON";
+				if (h.encoding != "RAW" && h.encoding != "RLE")
+					throw "Malformed ColorGrid JSON: encoding not supported";
 
-						int currentInDecoded = 0;
-						int currentInCG = 0;
-						while (currentInDecoded != decoded.size()) {
-							if (currentInDecoded + 5 > decoded.size())
-								throw "Malformed ColorGrid JSON: nodes is not a multiple of 5";
+				if (debug())
+					std::cerr << "Dimensions: " << h.dims[0] << "x" << h.dims[1] << std::endl;
 
-							int repeat = (BYTE) decoded[currentInDecoded++];
-							int r = (BYTE) decoded[currentInDecoded++];
-							int g = (BYTE) decoded[currentInDecoded++];
-							int b = (BYTE) decoded[currentInDecoded++];
-							int a = (BYTE) decoded[currentInDecoded++];
+				bridges::ColorGrid cg (h.dims[0], h.dims[1]);
 
-							if (debug())
-								std::cerr << "indecoded: " << currentInDecoded
-									<< " repeat: " << (int)repeat
-									<< " color(" << (int)r << "," << (int)g << "," << (int)b << "," << (int)a << ")"
-									<< std::endl;
-
-							bridges::Color c (r, g, b, a);
-
-							while (repeat >= 0) {
-								int posX = currentInCG / dimy;
-								int posY = currentInCG % dimy;
-								if (posX >= dimx || posY >= dimy) {
-									if (debug())
-										std::cerr << posX << " " << dimx << " " << posY << " " << dimy << std::endl;
-									throw "Malformed ColorGrid JSON: Too much data in nodes";
-								}
-								cg.set(posX, posY, c);
-
-								currentInCG++;
-								repeat --;
-							}
-						}
-						if (debug())
-							std::cerr << "written " << currentInCG << " pixels" << std::endl;
-						if (currentInCG != dimx * dimy)
-							throw "Malformed ColorGrid JSON: Not enough data in nodes";
-					}
-
-					return cg;
-				}
-				catch (rapidjson_exception re) {
-					throw "Malformed ColorGrid JSON";
-				}
+				if (debug())
+					std::cerr << "decoding " << h.encoding << ", length: " << h.nodesLength << std::endl;
+				if (h.encoding == "RAW")
+					decodeColorGridRAW(cg, h.nodes, h.nodesLength);
+				else
+					decodeColorGridRLE(cg, h.nodes, h.nodesLength);
 
+				return cg;
 			}
 		private:
 			/***
@@ -74,6 +74,8 @@ namespace bridges {
 		class DataStructure {
 				// Used for access to getDataStructureRepresentation()
 				friend class bridges::Bridges;
+				// Used by tests and benchmarks
+				friend struct RepresentationAccess;
 				//			friend void Bridges::visualize();
 
 			public:
@@ -102,9 +104,41 @@ namespace bridges {
 				 * @return The JSON representation of the data structure: A pair holding the nodes and links JSON strings respectively
 				 */
 				virtual const string getDataStructureRepresentation() const = 0;
+
+				/**
+				 * Called by Bridges::visualize() once the representation
+				 * was posted. Data structures that send only what changed
+				 * between visualizations record here what the viewer has.
+				 *
+				 * Only call it after a successful post of the last
+				 * representation: it is const so that visualize() can work
+				 * on a const data structure, but it changes the mutable
+				 * state the next representation is computed from.
+				 */
+				virtual void representationSent() const {
+				}
 				//				virtual void getDataStructureRepresentation(rapidjson::Document& d) const = 0;
 
 		};  //end of DataStructure class
+
+		/**
+		 * @brief Reads the representation of a data structure outside of
+		 * Bridges::visualize(), for tests and benchmarks.
+		 *
+		 * This class is not meant to be used directly by students.
+		 */
+		struct RepresentationAccess {
+			/// @return the JSON representation of ds, as visualize() sends it
+			static string get(const DataStructure& ds) {
+				return ds.getDataStructureRepresentation();
+			}
+
+			/// @brief records that the last representation of ds was
+			/// posted, as visualize() does after a successful post
+			static void sent(const DataStructure& ds) {
+				ds.representationSent();
+			}
+		};
 	}
 }   //end of bridges namespace
 #endif
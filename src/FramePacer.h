@@ -0,0 +1,273 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#if defined(__linux__)
+#include <time.h>
+#include <errno.h>
+#endif
+
+namespace bridges {
+	namespace game {
+
+		/**
+		 * @brief Time spent in each part of the frames of a game.
+		 *
+		 * The game loop records how long the update of the game took,
+		 * the sender how long encoding and emitting the frame took, and
+		 * the FramePacer how late each frame started compared to its
+		 * deadline (the jitter). The jitter is kept as a histogram whose
+		 * bucket i counts the frames that started between
+		 * getJitterBucketLimit(i-1) and getJitterBucketLimit(i) late.
+		 *
+		 * The parts can be recorded from different threads.
+		 *
+		 * This class is not meant to be used directly by students.
+		 **/
+		class FrameStats {
+			public:
+				typedef std::chrono::steady_clock::duration duration;
+
+				/// @brief durations of one part of the frames, in seconds
+				struct Timing {
+					long count = 0;
+					double total = 0.;
+					double max = 0.;
+					double last = 0.;
+
+					///@return the mean duration, 0 if nothing was recorded
+					double mean() const {
+						return count > 0 ? total / count : 0.;
+					}
+				};
+
+				/// number of buckets of the jitter histogram
+				static const int jitterBuckets = 16;
+
+			private:
+				mutable std::mutex m;
+				Timing update;
+				Timing encode;
+				Timing emit;
+				std::vector<long> jitter;
+				long missed = 0;
+
+				void record(Timing& t, duration d) {
+					double s = std::chrono::duration<double>(d).count();
+					std::lock_guard<std::mutex> lk(m);
+					++t.count;
+					t.total += s;
+					t.max = std::max(t.max, s);
+					t.last = s;
+				}
+
+				Timing get(const Timing& t) const {
+					std::lock_guard<std::mutex> lk(m);
+					return t;
+				}
+
+			public:
+				FrameStats() : jitter(jitterBuckets, 0) {
+				}
+
+				/**
+				 * @param i bucket of the jitter histogram
+				 * @return the upper limit of the bucket in seconds: 1
+				 * microsecond for bucket 0, doubling at each bucket; the
+				 * last bucket has no limit
+				 */
+				static double getJitterBucketLimit(int i) {
+					return (double) (1L << i) * 1e-6;
+				}
+
+				/// @brief records the duration of the update of a frame
+				void recordUpdate(duration d) {
+					record(update, d);
+				}
+
+				/// @brief records the duration of the encoding of a frame
+				void recordEncode(duration d) {
+					record(encode, d);
+				}
+
+				/// @brief records the duration of the emission of a frame
+				void recordEmit(duration d) {
+					record(emit, d);
+				}
+
+				/// @brief records how late a frame started
+				/// @param late delay after the deadline of the frame
+				/// @param missedDeadline whether the frame started more than a
+				/// period late and the pacer had to skip ahead
+				void recordJitter(duration late, bool missedDeadline) {
+					long us = (long) std::chrono::duration_cast<std::chrono::microseconds>(late).count();
+					int b = 0;
+					while (b < jitterBuckets - 1 && us >= (1L << b))
+						++b;
+					std::lock_guard<std::mutex> lk(m);
+					++jitter[b];
+					if (missedDeadline)
+						++missed;
+				}
+
+				///@return the time spent updating the game (input and gameLoop())
+				Timing getUpdateTime() const {
+					return get(update);
+				}
+
+				///@return the time spent encoding the frames
+				Timing getEncodeTime() const {
+					return get(encode);
+				}
+
+				///@return the time spent emitting the frames to the server
+				Timing getEmitTime() const {
+					return get(emit);
+				}
+
+				///@return the jitter histogram, see getJitterBucketLimit()
+				std::vector<long> getJitterHistogram() const {
+					std::lock_guard<std::mutex> lk(m);
+					return jitter;
+				}
+
+				///@return the number of frames that started more than a period late
+				long getMissedDeadlines() const {
+					std::lock_guard<std::mutex> lk(m);
+					return missed;
+				}
+
+				/// @brief forgets everything recorded so far
+				void reset() {
+					std::lock_guard<std::mutex> lk(m);
+					update = encode = emit = Timing();
+					std::fill(jitter.begin(), jitter.end(), 0);
+					missed = 0;
+				}
+		};
+
+		/**
+		 * @brief Runs a game loop at a fixed frame rate.
+		 *
+		 * Frame k is due at start + k * period: the deadlines are absolute,
+		 * so the time a frame takes, or a late wake up, does not shift the
+		 * following frames. The pacer sleeps until shortly before the
+		 * deadline (with clock_nanosleep on an absolute time on Linux) and
+		 * spins for the last spinTail, since sleeping threads often wake
+		 * up tens of microseconds late.
+		 *
+		 * When a frame ends more than a period after its deadline, the
+		 * pacer does not run the missed frames back to back to catch up;
+		 * it starts over from the current time.
+		 *
+		 * Without pacing, frames run as fast as possible, which is what a
+		 * headless simulation wants.
+		 *
+		 * This class is not meant to be used directly by students.
+		 **/
+		class FramePacer {
+			public:
+				typedef std::chrono::steady_clock clock;
+
+			private:
+				clock::duration period;
+				clock::time_point deadline;
+				bool paced = true;
+				FrameStats* stats;
+
+				/// time spent spinning before a deadline instead of sleeping
+				static clock::duration spinTail() {
+					return std::chrono::microseconds(200);
+				}
+
+				static void sleepUntil(clock::time_point t) {
+					clock::time_point now = clock::now();
+					if (now >= t)
+						return;
+#if defined(__linux__)
+					// steady_clock may not be CLOCK_MONOTONIC, so the target is
+					// expressed from a fresh CLOCK_MONOTONIC reading
+					timespec ts;
+					clock_gettime(CLOCK_MONOTONIC, &ts);
+					long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t - now).count()
+						+ ts.tv_nsec;
+					ts.tv_sec += (time_t) (ns / 1000000000LL);
+					ts.tv_nsec = (long) (ns % 1000000000LL);
+					while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+					}
+#else
+					std::this_thread::sleep_until(t);
+#endif
+				}
+
+			public:
+				/**
+				 * @param fps frames per second
+				 * @param stats where to record the jitter, may be null
+				 */
+				explicit FramePacer(double fps = 30., FrameStats* stats = nullptr)
+					: stats(stats) {
+					setFrameRate(fps);
+					start();
+				}
+
+				/// @param fps frames per second
+				/// @throw std::invalid_argument if fps is not positive
+				void setFrameRate(double fps) {
+					if (!(fps > 0.))
+						throw std::invalid_argument("the frame rate must be positive");
+					period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1. / fps));
+					if (period <= clock::duration::zero())
+						period = clock::duration(1);
+				}
+
+				///@return the frame rate, in frames per second
+				double getFrameRate() const {
+					return 1. / std::chrono::duration<double>(period).count();
+				}
+
+				/// @brief whether wait() waits for the deadline of the frame
+				/// @param p false to run frames as fast as possible
+				void setPaced(bool p) {
+					paced = p;
+				}
+
+				///@return whether wait() waits for the deadline of the frame
+				bool isPaced() const {
+					return paced;
+				}
+
+				/// @brief the next frame is due one period from now
+				void start() {
+					deadline = clock::now() + period;
+				}
+
+				/// @brief waits until the next frame is due
+				void wait() {
+					if (!paced)
+						return;
+					sleepUntil(deadline - spinTail());
+					clock::time_point now = clock::now();
+					while (now < deadline) {
+						std::this_thread::yield();
+						now = clock::now();
+					}
+
+					bool missed = now - deadline > period;
+					if (stats != nullptr)
+						stats->recordJitter(now - deadline, missed);
+					if (missed)
+						deadline = now + period;
+					else
+						deadline += period;
+				}
+		};
+	}
+}
+
+#endif
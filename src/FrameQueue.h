@@ -0,0 +1,113 @@
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+namespace bridges {
+	namespace game {
+
+		/**
+		 * @brief Hands the latest frame of a game from the game thread
+		 * to a sender thread (a triple buffer).
+		 *
+		 * The producer fills backBuffer() and calls publish(); the
+		 * consumer calls acquire() and reads the frame it gets until its
+		 * next acquire(). Each side owns one buffer and the third one
+		 * holds the latest published frame, so neither side ever waits
+		 * for the other to finish using a frame. When the consumer is
+		 * slower than the producer, a published frame that was not
+		 * acquired yet is replaced by the newer one: stale frames are
+		 * dropped instead of piling up.
+		 *
+		 * This class is not meant to be used directly by students.
+		 *
+		 * @param T type of a frame
+		 */
+		template <typename T>
+		class FrameQueue {
+				std::unique_ptr<T> back;
+				std::unique_ptr<T> ready;
+				std::unique_ptr<T> front;
+
+				std::mutex m;
+				std::condition_variable cv;
+				bool fresh = false;
+				bool closed = false;
+				long published = 0;
+				long dropped = 0;
+
+			public:
+				/// @param args arguments of the constructor of the three frames
+				template <typename... Args>
+				explicit FrameQueue(const Args& ... args)
+					: back(new T(args...)), ready(new T(args...)), front(new T(args...)) {
+				}
+
+				FrameQueue(const FrameQueue&) = delete;
+				FrameQueue& operator= (const FrameQueue&) = delete;
+
+				/// @return the frame the producer fills, valid until publish()
+				T& backBuffer() {
+					return *back;
+				}
+
+				/// @brief makes the back buffer the latest frame
+				void publish() {
+					{
+						std::lock_guard<std::mutex> lk(m);
+						std::swap(back, ready);
+						if (fresh)
+							++dropped;
+						fresh = true;
+						++published;
+					}
+					cv.notify_one();
+				}
+
+				/**
+				 * @brief waits for a frame that was not acquired yet
+				 *
+				 * @return the latest frame, valid until the next acquire(),
+				 * or nullptr once the queue is closed and the last frame
+				 * was acquired
+				 */
+				T* acquire() {
+					std::unique_lock<std::mutex> lk(m);
+					cv.wait(lk, [this]() {
+						return fresh || closed;
+					});
+					if (!fresh)
+						return nullptr;
+					std::swap(front, ready);
+					fresh = false;
+					return front.get();
+				}
+
+				/// @brief wakes up the consumer; acquire() still returns the last frame
+				void close() {
+					{
+						std::lock_guard<std::mutex> lk(m);
+						closed = true;
+					}
+					cv.notify_all();
+				}
+
+				///@return the number of frames published
+				long getPublishedFrames() {
+					std::lock_guard<std::mutex> lk(m);
+					return published;
+				}
+
+				///@return the number of frames replaced before being acquired
+				long getDroppedFrames() {
+					std::lock_guard<std::mutex> lk(m);
+					return dropped;
+				}
+		};
+	}
+}
+
+#endif
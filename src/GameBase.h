@@ -2,6 +2,9 @@
 #define GAME_BASE_H
 
 #include <SocketConnection.h>
+#include <HeadlessTransport.h>
+#include <FrameQueue.h>
+#include <thread>
 
 namespace bridges {
 	namespace game {
@@ -29,7 +32,31 @@ namespace bridges {
 				bool firsttime = true;
 
 				bool bquit = false;
-				std::unique_ptr<SocketConnection> sockcon;
+				std::shared_ptr<GameTransport> transport;
+
+				// frames are copied from gg by the game thread, and encoded
+				// and emitted by the sender thread, so a slow emit does not
+				// delay the game loop
+				FrameQueue<GameGrid> frames;
+				// the grid as last sent, only used by the sender thread
+				GameGrid sentGrid;
+				std::thread sender;
+
+				FrameStats stats;
+
+				void sendFrames() {
+					while (GameGrid* frame = frames.acquire()) {
+						// the cells that differ from the last sent frame are
+						// the delta, even when frames were dropped in between
+						try {
+							sentGrid.copyFrom(*frame);
+							transport->sendDataToServer(sentGrid, &stats);
+						}
+						catch (const std::exception& e) {
+							std::cerr << "could not send a frame: " << e.what() << std::endl;
+						}
+					}
+				}
 
 			protected:
 				bool debug = false;
@@ -41,20 +68,48 @@ namespace bridges {
 				 * directly created. Since GameBase is meant to be a
 				 * purely internal class, that seems appropriate.
 				 */
+				///
+				/// If the FORCE_BRIDGES_HEADLESS environment variable is set,
+				/// the game runs without the server, as with a
+				/// HeadlessTransport.
 				GameBase(int assignmentID, std::string username,
 					std::string apikey, int nbRow = 10, int nbColumn = 10)
 					: bridges(assignmentID, username, apikey), gg(nbRow,
-						  nbColumn) {
+						  nbColumn), frames(nbRow, nbColumn), sentGrid(nbRow, nbColumn) {
 					bridges.setServer("games");
 
-					sockcon = std::make_unique<SocketConnection>(bridges);
+					if (getenv("FORCE_BRIDGES_HEADLESS") != nullptr)
+						transport = std::make_shared<HeadlessTransport>();
+					else
+						transport = std::make_shared<SocketConnection>(bridges);
 
 					if (debug)
 						std::cerr << "nbRow: " << nbRow << " nbCol: " <<
 							nbColumn << std::endl;
 				}
 
-				virtual ~GameBase() = default;
+				/**
+				 * @brief Runs the game with another transport than the
+				 * Bridges games server, typically a HeadlessTransport
+				 *
+				 * @param transport where frames go and key events come from
+				 * @param nbRow number of rows of the board
+				 * @param nbColumn number of columns of the board
+				 */
+				GameBase(std::shared_ptr<GameTransport> transport,
+					int nbRow = 10, int nbColumn = 10)
+					: bridges(0, "", ""), gg(nbRow, nbColumn), transport(transport),
+					  frames(nbRow, nbColumn), sentGrid(nbRow, nbColumn) {
+					if (!this->transport)
+						throw std::invalid_argument("a game needs a transport");
+				}
+
+				virtual ~GameBase() {
+					// the sender thread sends the last frame and stops
+					frames.close();
+					if (sender.joinable())
+						sender.join();
+				}
 
 				/// @brief This function is called once when the game starts.
 				///
@@ -77,14 +132,23 @@ namespace bridges {
 				///
 				/// @param p a KeypressListener to register
 				void registerKeyListener(KeypressListener* p) {
-					sockcon->registerKeyListener(p);
+					transport->registerKeyListener(p);
 				}
 
 				/// @brief Renders the game
 				///
 				/// Student should not have to call this function directly. It is
 				/// called automatically by Bridges.
+				///
+				/// The board is copied and handed to a sender thread, which
+				/// encodes and emits it. If the sender falls behind, it skips to
+				/// the latest frame. A game that is not live sends every frame
+				/// itself.
 				void render() {
+					if (!transport->isLive()) {
+						transport->sendDataToServer(gg, &stats);
+						return;
+					}
 					if (firsttime) {
 						bridges.setJSONFlag(debug);
 
@@ -94,9 +158,38 @@ namespace bridges {
 
 						firsttime = false;
 
+						sender = std::thread(&GameBase::sendFrames, this);
 					}
 
-					sockcon->sendDataToServer(gg);
+					frames.backBuffer().copyCells(gg);
+					frames.publish();
+				}
+
+				/// @brief How many frames were skipped because the previous
+				/// ones were still being sent?
+				///
+				/// @return the number of rendered frames that were not sent
+				long getDroppedFrames() {
+					return frames.getDroppedFrames();
+				}
+
+				/// @brief How long do the parts of the frames take?
+				///
+				/// @return the update, encode and emit times and the jitter
+				/// of the frames so far
+				FrameStats& getFrameStats() {
+					return stats;
+				}
+
+				///@return whether the game is displayed to a player, see
+				/// GameTransport::isLive()
+				bool isLive() const {
+					return transport->isLive();
+				}
+
+				/// @brief called by the game loop at the start of each frame
+				void frameStart(long frame) {
+					transport->frameStart(frame);
 				}
 
 			protected:
@@ -113,6 +206,28 @@ namespace bridges {
 					bquit = true;
 				}
 
+				/// @brief the cells of the board, shared with the board until
+				/// it changes, see GameGrid::snapshot()
+				GameGrid::Snapshot getBoardSnapshot() const {
+					return gg.snapshot();
+				}
+
+				/// @brief copies the board: the background colors, then the
+				/// symbol colors, then the symbols, see GameGrid::copyPlanes()
+				///
+				/// @param out buffer of 3 * getBoardHeight() * getBoardWidth() bytes
+				void copyBoard(unsigned char* out) const {
+					const size_t count = (size_t) gg.getDimensions()[0] * gg.getDimensions()[1];
+					gg.copyPlanes(out, out + count, out + 2 * count);
+				}
+
+				/// @brief sets the board back to a snapshot, and whether the
+				/// game is over
+				void restoreBoard(const GameGrid::Snapshot& s, bool over) {
+					gg.restore(s);
+					bquit = over;
+				}
+
 				/// @brief Change the background color of a cell
 				///
 				/// @param row row of the cell to set
@@ -133,6 +248,29 @@ namespace bridges {
 					gg.drawSymbol(row, col, symb, nc);
 				}
 
+				/// @brief Send only the cells that changed between frames
+				///
+				/// Frames in which few cells changed are much smaller, which
+				/// helps fast games on large boards. Every keyframeInterval
+				/// frames, the whole board is sent.
+				///
+				/// @param enable whether to send delta frames
+				/// @param keyframeInterval frames between two complete boards
+				void setDeltaFrames(bool enable, int keyframeInterval = 60) {
+					gg.setDeltaFrames(enable, keyframeInterval);
+				}
+
+				/// @brief Send frames as binary data instead of JSON
+				///
+				/// The cells travel as raw bytes, without base64, which makes
+				/// frames smaller and faster to encode. Binary frames require
+				/// a server that supports them.
+				///
+				/// @param enable whether to send binary frames
+				void setBinaryFrames(bool enable) {
+					transport->setBinaryFrames(enable);
+				}
+
 				/// @brief Set the title of the game
 				///
 				/// @param title Title of the game
@@ -152,7 +290,7 @@ namespace bridges {
 				/// @param row row of the cell
 				/// @param col column of the cell
 				NamedColor getBGColor(int row, int col) {
-					return gg[row][col].getBGColor();
+					return gg.getBGColor(row, col);
 				}
 
 				/// @brief What object is in this cell?
@@ -160,7 +298,7 @@ namespace bridges {
 				/// @param row row of the cell
 				/// @param col column of the cell
 				NamedSymbol getSymbol(int row, int col) {
-					return gg[row][col].getSymbol();
+					return gg.getSymbol(row, col);
 				}
 
 				/// @brief What color is object in this cell?
@@ -168,13 +306,13 @@ namespace bridges {
 				/// @param row row of the cell
 				/// @param col column of the cell
 				NamedColor getSymbolColor(int row, int col) {
-					return gg[row][col].getFGColor();
+					return gg.getFGColor(row, col);
 				}
 
 				/// @brief How wide is the Game Board?
 				///
 				/// @return the number of columns of the board
-				int getBoardWidth() {
+				int getBoardWidth() const {
 					int const* size = gg.getDimensions();
 					return size[1];
 				}
@@ -182,7 +320,7 @@ namespace bridges {
 				/// @brief How tall is the Game Board?
 				///
 				/// @return the number of rows of the board
-				int getBoardHeight() {
+				int getBoardHeight() const {
 					int const* size = gg.getDimensions();
 					return size[0];
 				}
@@ -2,9 +2,11 @@
 #define GAME_BASE_3D_H
 
 #include "SocketConnection.h"
+#include "HeadlessTransport.h"
 #include "GameGrid.h"
 #include "Bridges.h"
 #include "Scene.h"
+#include "TerrainLOD.h"
 
 namespace bridges {
 	namespace game {
@@ -28,12 +30,11 @@ namespace bridges {
 				bool firsttime = true;
 
 				bool bquit = false;
-				std::unique_ptr<SocketConnection> sockcon;
+				std::shared_ptr<GameTransport> transport;
 
-				Scene *scene;
-				// we keep this object locally to prevent users from creating a
-				// a whole bunch of Scene objects
-				// Scene scene;
+				FrameStats stats;
+
+				std::shared_ptr<TerrainLOD> terrainLOD;
 
 			protected:
 				bool debug = false;
@@ -50,11 +51,22 @@ namespace bridges {
 
 					bridges.setServer("games");
 
-					sockcon = std::make_unique<SocketConnection>(bridges);
+					if (getenv("FORCE_BRIDGES_HEADLESS") != nullptr)
+						transport = std::make_shared<HeadlessTransport>();
+					else
+						transport = std::make_shared<SocketConnection>(bridges);
+				}
 
-					// set up the default 3D scene
-					float position[] = {0., 0., 0.};
-					scene = new Scene("fps", 90, position);
+				/**
+				 * @brief Runs the game with another transport than the
+				 * Bridges games server, typically a HeadlessTransport
+				 *
+				 * @param transport where frames go and key events come from
+				 */
+				GameBase3D(std::shared_ptr<GameTransport> transport)
+					: bridges(0, "", ""), transport(transport) {
+					if (!this->transport)
+						throw std::invalid_argument("a game needs a transport");
 				}
 
 				virtual ~GameBase3D() = default;
@@ -80,7 +92,7 @@ namespace bridges {
 				///
 				/// @param p a KeypressListener to register
 				void registerKeyListener(KeypressListener* p) {
-					sockcon->registerKeyListener(p);
+					transport->registerKeyListener(p);
 				}
 
 				/// @brief Renders the game
@@ -88,7 +100,9 @@ namespace bridges {
 				/// Student should not have to call this function directly. It is
 				/// called automatically by Bridges.
 				void render() {
-					if (firsttime) {
+					if (terrainLOD)
+						terrainLOD->update(current_scene);
+					if (firsttime && transport->isLive()) {
 						bridges.setJSONFlag(debug);
 
 						bridges.setDataStructure(current_scene);
@@ -97,7 +111,15 @@ namespace bridges {
 
 						firsttime = false;
 					}
-					sockcon->sendSceneDataToServer(current_scene);
+					transport->sendSceneDataToServer(current_scene, &stats);
+				}
+
+				/// @brief How long do the parts of the frames take?
+				///
+				/// @return the update, encode and emit times and the jitter
+				/// of the frames so far
+				FrameStats& getFrameStats() {
+					return stats;
 				}
 
 				///@brief calling this function causes the game to end.
@@ -108,6 +130,54 @@ namespace bridges {
 					bquit = true;
 				}
 
+				/// @brief Show a large terrain with less detail far from the camera
+				///
+				/// Before each frame, the chunks of the terrain needed from
+				/// the camera position are added to the scene and the others
+				/// removed. Use it with setDeltaFrames() so that a frame
+				/// only sends the chunks that appeared.
+				///
+				/// @param lod the terrain, or nullptr to remove it from the scene
+				void setTerrainLOD(std::shared_ptr<TerrainLOD> lod) {
+					if (terrainLOD && terrainLOD != lod)
+						terrainLOD->clear(current_scene);
+					terrainLOD = lod;
+				}
+
+				/// @brief Send only the meshes that changed between frames
+				///
+				/// Terrains that did not change are not sent again, which
+				/// helps games with large or many terrains. Every
+				/// keyframeInterval frames, the whole scene is sent.
+				///
+				/// @param enable whether to send delta frames
+				/// @param keyframeInterval frames between two complete scenes
+				void setDeltaFrames(bool enable, int keyframeInterval = 60) {
+					current_scene.setDeltaFrames(enable, keyframeInterval);
+				}
+
+				/// @brief Send the mesh arrays of JSON frames as packed floats
+				///
+				/// The vertices and colors travel as base64 32-bit floats
+				/// instead of decimal text. Packed meshes require a server
+				/// that supports them.
+				///
+				/// @param enable whether to pack the meshes
+				void setPackedMeshes(bool enable) {
+					current_scene.setPackedMeshes(enable);
+				}
+
+				/// @brief Send the scene as binary data instead of JSON
+				///
+				/// The mesh vertices and colors travel as 32-bit floats
+				/// instead of text. Binary frames require a server that
+				/// supports them.
+				///
+				/// @param enable whether to send binary frames
+				void setBinaryFrames(bool enable) {
+					transport->setBinaryFrames(enable);
+				}
+
 				/// @brief Set the title of the game
 				///
 				/// @param title Title of the game
@@ -127,8 +197,12 @@ namespace bridges {
 				Scene current_scene;
 
 				// accessors
+				// the new scene continues the frames of the current one, so
+				// the meshes they share are not sent again
 				void addScene(Scene& sc) {
+					Scene previous = std::move(current_scene);
 					current_scene = sc;
+					current_scene.continueFrames(previous);
 				}
 
 				Scene getCurrentScene() {
@@ -138,6 +212,17 @@ namespace bridges {
 				bool gameover() const {
 					return bquit;
 				}
+
+				///@return whether the game is displayed to a player, see
+				/// GameTransport::isLive()
+				bool isLive() const {
+					return transport->isLive();
+				}
+
+				/// @brief called by the game loop at the start of each frame
+				void frameStart(long frame) {
+					transport->frameStart(frame);
+				}
 		};
 	}
 }
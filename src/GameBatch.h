@@ -0,0 +1,211 @@
+#ifndef GAME_BATCH_H
+#define GAME_BATCH_H
+
+#include <NonBlockingGame.h>
+#include <HeadlessTransport.h>
+#include <ThreadPool.h>
+#include <vector>
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <stdexcept>
+
+namespace bridges {
+	namespace game {
+
+		/**
+		 * @brief Runs many instances of a game in lock-step, for agents
+		 * that learn to play it.
+		 *
+		 * Each game has its own HeadlessTransport that keeps no frames,
+		 * so no game waits between frames or encodes its board. step()
+		 * runs one frame of every game across a ThreadPool, with the key
+		 * events of each game. Then it copies the boards into one
+		 * contiguous array of shape (games, 3, rows, columns): the
+		 * background colors, the symbol colors and the symbols of each
+		 * game, one byte per cell.
+		 *
+		 * A game that is over is put back in its initial state at the end
+		 * of the step (see setAutoReset()). getDone() tells which games
+		 * ended, and the observation of such a game is its first frame.
+		 *
+		 * The games run concurrently, so gameLoop() must not share
+		 * mutable state between instances (such as rand(); use a random
+		 * generator member of the game instead).
+		 *
+		 * \code{.cpp}
+		 * GameBatch<my_game> batch(256);      // my_game(transport)
+		 * std::vector<std::vector<InputEvent>> events(batch.size());
+		 * for (;;) {
+		 *   // fill events from the agent
+		 *   batch.step(events);
+		 *   const unsigned char* obs = batch.getObservations();
+		 *   const unsigned char* done = batch.getDone();
+		 * }
+		 * \endcode
+		 *
+		 * @param Game a NonBlockingGame constructible from a
+		 * std::shared_ptr<GameTransport> followed by the other
+		 * parameters of the GameBatch constructor
+		 **/
+		template <typename Game>
+		class GameBatch {
+				static_assert(std::is_base_of<NonBlockingGame, Game>::value,
+					"GameBatch runs NonBlockingGame instances");
+
+				ThreadPool* pool = &ThreadPool::global();
+				std::vector<std::unique_ptr<Game>> games;
+				std::vector<NonBlockingGame::Snapshot> initial;
+				bool autoReset = true;
+
+				size_t boardSize = 0;
+				std::vector<unsigned char> observations;
+				std::vector<unsigned char> done;
+
+				// runs f(i) for each game, over the pool
+				template <typename Func>
+				void forEachGame(Func f) {
+					long count = (long) games.size();
+					long grain = std::max(1L, count / (8L * pool->size()));
+					pool->parallelFor(0, count, grain, [&](long b, long e) {
+						for (long i = b; i < e; ++i)
+							f((size_t) i);
+					});
+				}
+
+				void stepGame(size_t i, const std::vector<InputEvent>& events) {
+					Game& g = *games[i];
+					done[i] = 0;
+					if (!g.isGameOver()) {
+						g.step(events);
+						done[i] = g.isGameOver();
+					}
+					if (g.isGameOver() && autoReset)
+						g.restore(initial[i]);
+					g.observe(&observations[i * boardSize]);
+				}
+
+			public:
+				/**
+				 * @brief Creates and initializes the games
+				 *
+				 * @param count number of games
+				 * @param args other parameters of the constructor of Game,
+				 * after its transport
+				 */
+				template <typename... Args>
+				explicit GameBatch(size_t count, const Args& ... args) {
+					if (count == 0)
+						throw std::invalid_argument("GameBatch: no game to run");
+					games.reserve(count);
+					for (size_t i = 0; i < count; ++i)
+						games.emplace_back(new Game(std::make_shared<HeadlessTransport>(), args...));
+
+					const Game& first = *games.front();
+					boardSize = 3 * (size_t) first.getBoardHeight() * first.getBoardWidth();
+					for (const auto& g : games)
+						if (3 * (size_t) g->getBoardHeight() * g->getBoardWidth() != boardSize)
+							throw std::invalid_argument("GameBatch: the boards differ in size");
+					observations.resize(count * boardSize);
+					done.assign(count, 0);
+
+					// initialize() runs when the first snapshot is taken
+					initial.resize(count);
+					forEachGame([this](size_t i) {
+						initial[i] = games[i]->snapshot();
+						games[i]->observe(&observations[i * boardSize]);
+					});
+				}
+
+				GameBatch(const GameBatch&) = delete;
+				GameBatch& operator= (const GameBatch&) = delete;
+
+				///@return the number of games
+				size_t size() const {
+					return games.size();
+				}
+
+				///@return game i
+				Game& get(size_t i) {
+					return *games.at(i);
+				}
+
+				/// @param pool pool the games run on (default is
+				/// ThreadPool::global())
+				void setThreadPool(ThreadPool& pool) {
+					this->pool = &pool;
+				}
+
+				/// @brief Whether games that are over start again
+				///
+				/// When false, a game that is over stays over: step() skips
+				/// it until reset().
+				///
+				/// @param enable true to restart the games that end (default)
+				void setAutoReset(bool enable) {
+					autoReset = enable;
+				}
+
+				/// @brief runs one frame of every game, without key events
+				void step() {
+					static const std::vector<InputEvent> none;
+					forEachGame([this](size_t i) {
+						stepGame(i, none);
+					});
+				}
+
+				/**
+				 * @brief runs one frame of every game
+				 *
+				 * @param events key events of each game for this frame, in
+				 * order
+				 * @throw std::invalid_argument if events does not have one
+				 * entry per game
+				 */
+				void step(const std::vector<std::vector<InputEvent>>& events) {
+					if (events.size() != games.size())
+						throw std::invalid_argument("GameBatch::step: one list of events per game");
+					forEachGame([this, &events](size_t i) {
+						stepGame(i, events[i]);
+					});
+				}
+
+				/// @brief puts every game back in its initial state
+				void reset() {
+					forEachGame([this](size_t i) {
+						games[i]->restore(initial[i]);
+						games[i]->observe(&observations[i * boardSize]);
+						done[i] = 0;
+					});
+				}
+
+				/// @brief puts game i back in its initial state
+				void reset(size_t i) {
+					games.at(i)->restore(initial[i]);
+					games[i]->observe(&observations[i * boardSize]);
+					done[i] = 0;
+				}
+
+				///@return the boards after the last step, games first, see
+				/// getObservationShape()
+				const unsigned char* getObservations() const {
+					return observations.data();
+				}
+
+				///@return the dimensions of getObservations(): games,
+				/// planes (background colors, symbol colors, symbols), rows
+				/// and columns
+				std::array<size_t, 4> getObservationShape() const {
+					const Game& g = *games.front();
+					return {{games.size(), 3, (size_t) g.getBoardHeight(), (size_t) g.getBoardWidth()}};
+				}
+
+				///@return for each game, 1 if it ended during the last step
+				const unsigned char* getDone() const {
+					return done.data();
+				}
+		};
+	}
+}
+
+#endif
@@ -5,9 +5,15 @@ using namespace std;
 #ifndef GAME_GRID_H
 #define GAME_GRID_H 1
 
-#include "Grid.h"
+#include "DataStructure.h"
 #include "Color.h"
 #include "base64.h"
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <cstring>
 
 namespace bridges {
 	namespace game {
@@ -388,6 +394,21 @@ namespace bridges {
 		 *
 		 *	This class is part of the Bridges Game API
 		 *
+		 * The cells are stored as three planes of bytes (background
+		 * colors, foreground colors and symbols), which are the arrays
+		 * the representation sends, so a frame is encoded without
+		 * gathering the cells. The grid also keeps the list of the cells
+		 * modified since the last frame: with setDeltaFrames(), a frame
+		 * in which a small part of the board changed only sends these
+		 * cells.
+		 *
+		 * snapshot() captures the cells without copying them: the grid
+		 * and its snapshots share the planes until the grid is modified.
+		 * Copies of the grid share them the same way.
+		 *
+		 * grid[row][col] accesses a cell as with Grid<GameCell>, through
+		 * a CellRef; get() returns a copy of the cell.
+		 *
 		 * @sa See the detailed Bridges game tutorial for examples at
 		 * https://bridgesuncc.github.io/tutorials/NonBlockingGame.html
 		 *
@@ -395,19 +416,166 @@ namespace bridges {
 		 * @date 2018, 2019, 12/28/20
 		 *
 		 */
-		class GameGrid : public Grid<GameCell> {
+		class GameGrid : public datastructure::DataStructure {
 			private:
 				std::string encoding = "raw";
 
-				void initializeGrid() {
-					for (int i = 0; i < gridSize[0]; i++) {
-						for (int j = 0; j < gridSize[1]; j++) {
-							setBGColor(i, j, NamedColor::black);
-							setFGColor(i, j, NamedColor::black);
-							setSymbol(i, j, NamedSymbol::none);
-						}
+				int gridSize[2];
+
+				// one byte per cell, row-major
+				struct Planes {
+					std::vector<unsigned char> bg;
+					std::vector<unsigned char> fg;
+					std::vector<unsigned char> symbols;
+				};
+				// shared with the snapshots of the grid until the grid or
+				// the snapshots are modified (copy on write)
+				std::shared_ptr<Planes> planes;
+
+				bool deltaFrames = false;
+				int keyframeInterval = 60;
+
+				// cells modified since the last frame; updated by the (const)
+				// frame representation, which is produced once per frame
+				mutable std::vector<unsigned int> changedCells;
+				mutable std::vector<unsigned char> changedFlags;
+				mutable bool keyframeNeeded = true;
+				mutable int framesSinceKeyframe = 0;
+
+				void initializeGrid(int nbrow, int nbcol) {
+					if (nbrow <= 0 || nbcol <= 0 || (long) nbrow * nbcol > 1080L * 1920L)
+						throw std::invalid_argument("GameGrid dimensions must be positive and at most 1080 x 1920 cells");
+					gridSize[0] = nbrow;
+					gridSize[1] = nbcol;
+					size_t count = (size_t) nbrow * nbcol;
+					planes = std::make_shared<Planes>();
+					planes->bg.assign(count, static_cast<unsigned char>(NamedColor::black));
+					planes->fg.assign(count, static_cast<unsigned char>(NamedColor::black));
+					planes->symbols.assign(count, static_cast<unsigned char>(NamedSymbol::none));
+					changedFlags.assign(count, 0);
+					changedCells.clear();
+					changedCells.reserve(count);
+					keyframeNeeded = true;
+				}
+
+				unsigned int index(int row, int col) const {
+					if (row < 0 || col < 0 || row >= gridSize[0] || col >= gridSize[1])
+						throw std::out_of_range("invalid location in GameGrid");
+					return (unsigned int) row * gridSize[1] + col;
+				}
+
+				/// the planes, copied first if a snapshot shares them
+				Planes& writablePlanes() {
+					if (planes.use_count() > 1)
+						planes = std::make_shared<Planes>(*planes);
+					else
+						// the last snapshot may have been released by another
+						// thread: its reads happen before our writes
+						std::atomic_thread_fence(std::memory_order_acquire);
+					return *planes;
+				}
+
+				void markChanged(unsigned int idx) {
+					if (!changedFlags[idx]) {
+						changedFlags[idx] = 1;
+						changedCells.push_back(idx);
 					}
 				}
+
+				/// writes v in a plane and records the cell if it changed
+				void write(std::vector<unsigned char> Planes::* plane, unsigned int idx, unsigned char v) {
+					if (((*planes).*plane)[idx] == v)
+						return;
+					(writablePlanes().*plane)[idx] = v;
+					markChanged(idx);
+				}
+
+				static void appendBase64(std::string& out, const unsigned char* buf, size_t len) {
+					size_t pos = out.size();
+					out.resize(pos + base64::encodedLength(len));
+					out.resize(pos + base64::encode(buf, len, &out[pos]));
+				}
+
+				void appendHeader(std::string& out, const std::string& enc) const {
+					out += QUOTE + "encoding" + QUOTE + COLON + QUOTE + enc + QUOTE + COMMA;
+					out += QUOTE + "dimensions" + QUOTE + COLON +
+						OPEN_BOX + std::to_string(gridSize[0]) + "," + std::to_string(gridSize[1]) + CLOSE_BOX + COMMA;
+				}
+
+				/// appends "bg", "fg" and "symbols" from the planes
+				void appendPlanes(std::string& out, const unsigned char* bg, const unsigned char* fg,
+					const unsigned char* symbols, size_t count) const {
+					out += QUOTE + "bg" + QUOTE + COLON + QUOTE;
+					appendBase64(out, bg, count);
+					out += QUOTE + COMMA + QUOTE + "fg" + QUOTE + COLON + QUOTE;
+					appendBase64(out, fg, count);
+					out += QUOTE + COMMA + QUOTE + "symbols" + QUOTE + COLON + QUOTE;
+					appendBase64(out, symbols, count);
+					out += QUOTE;
+				}
+
+				void clearChanges() const {
+					for (unsigned int idx : changedCells)
+						changedFlags[idx] = 0;
+					changedCells.clear();
+				}
+
+				/// writes the indices of the changed cells (32-bit little-endian)
+				/// and their values, one entry per changed cell in each buffer
+				void fillDelta(unsigned char* idxbuf, unsigned char* bg, unsigned char* fg,
+					unsigned char* symbols) const {
+					for (size_t k = 0; k < changedCells.size(); ++k) {
+						unsigned int idx = changedCells[k];
+						for (int b = 0; b < 4; ++b)
+							idxbuf[4 * k + b] = (unsigned char) (idx >> (8 * b));
+						bg[k] = planes->bg[idx];
+						fg[k] = planes->fg[idx];
+						symbols[k] = planes->symbols[idx];
+					}
+				}
+
+				/// whether the next frame must hold the whole grid
+				bool nextFrameIsKeyframe() const {
+					return !deltaFrames || keyframeNeeded
+						|| framesSinceKeyframe + 1 >= keyframeInterval
+						|| 4 * changedCells.size() > planes->bg.size();
+				}
+
+				/// the next frame was produced: forgets the changed cells
+				void frameProduced(bool keyframe) const {
+					if (keyframe) {
+						keyframeNeeded = false;
+						framesSinceKeyframe = 0;
+					}
+					else
+						++framesSinceKeyframe;
+					clearChanges();
+				}
+
+				/**
+				 * The changed cells: "cells" holds their indices
+				 * (row * width + col) as 32-bit little-endian integers and
+				 * "bg", "fg", "symbols" their values, in the same order.
+				 */
+				string getDeltaRepresentation() const {
+					size_t n = changedCells.size();
+					std::vector<unsigned char> buf(7 * n);
+					unsigned char* idxbuf = buf.data();
+					unsigned char* bg = idxbuf + 4 * n;
+					unsigned char* fg = bg + n;
+					unsigned char* symbols = fg + n;
+					fillDelta(idxbuf, bg, fg, symbols);
+
+					std::string ret;
+					ret.reserve(128 + base64::encodedLength(4 * n) + 3 * base64::encodedLength(n));
+					appendHeader(ret, "delta");
+					ret += QUOTE + "cells" + QUOTE + COLON + QUOTE;
+					appendBase64(ret, idxbuf, 4 * n);
+					ret += QUOTE + COMMA;
+					appendPlanes(ret, bg, fg, symbols, n);
+					return ret + CLOSE_CURLY;
+				}
+
 			public:
 
 				/**
@@ -417,19 +585,19 @@ namespace bridges {
 				 *  @param color - Named Color enum argument to set the background at the chosen position
 				 */
 				void setBGColor(int row, int col, NamedColor color) {
-					(*this)[row][col].setBGColor(color);
+					write(&Planes::bg, index(row, col), static_cast<unsigned char>(color));
 				}
 
 				NamedColor getBGColor(int row, int col) const {
-					return (*this)[row][col].getBGColor();
+					return static_cast<NamedColor>(planes->bg[index(row, col)]);
 				}
 
 				NamedColor getFGColor(int row, int col) const {
-					return (*this)[row][col].getFGColor();
+					return static_cast<NamedColor>(planes->fg[index(row, col)]);
 				}
 
 				NamedSymbol getSymbol(int row, int col) const {
-					return (*this)[row][col].getSymbol();
+					return static_cast<NamedSymbol>(planes->symbols[index(row, col)]);
 				}
 
 				/**
@@ -439,7 +607,7 @@ namespace bridges {
 				 *  @param color - Named Color enum argument to set the foreground at the chosen position
 				 */
 				void setFGColor(int row, int col, NamedColor color) {
-					(*this)[row][col].setFGColor(color);
+					write(&Planes::fg, index(row, col), static_cast<unsigned char>(color));
 				}
 
 				/**
@@ -449,7 +617,7 @@ namespace bridges {
 				 *  @param symbol - the symbol to set
 				 */
 				void setSymbol(int row, int col, NamedSymbol symbol) {
-					(*this)[row][col].setSymbol(symbol);
+					write(&Planes::symbols, index(row, col), static_cast<unsigned char>(symbol));
 				}
 
 				/**
@@ -464,6 +632,288 @@ namespace bridges {
 					setSymbol(row, col, symbol);
 				}
 
+				/**
+				 * @brief Get a cell of the grid
+				 *
+				 * The grid stores planes of bytes rather than GameCell
+				 * objects, so the cell is returned by value: it can be bound
+				 * to a const reference as before, but modifying the grid
+				 * does not change it. Use grid[row][col] to modify a cell
+				 * in place.
+				 *
+				 * @param row, col - position of the cell
+				 * @return a copy of the cell
+				 */
+				GameCell get(int row, int col) const {
+					unsigned int idx = index(row, col);
+					return GameCell(static_cast<NamedColor>(planes->bg[idx]),
+							static_cast<NamedColor>(planes->fg[idx]),
+							static_cast<NamedSymbol>(planes->symbols[idx]));
+				}
+
+				/**
+				 * @brief Set a cell of the grid
+				 * @param row, col - position of the cell
+				 * @param cell - colors and symbol of the cell
+				 */
+				void set(int row, int col, const GameCell& cell) {
+					unsigned int idx = index(row, col);
+					write(&Planes::bg, idx, static_cast<unsigned char>(cell.getBGColor()));
+					write(&Planes::fg, idx, static_cast<unsigned char>(cell.getFGColor()));
+					write(&Planes::symbols, idx, static_cast<unsigned char>(cell.getSymbol()));
+				}
+
+				/**
+				 * @brief A cell of the grid, as returned by grid[row][col]
+				 *
+				 * Works as the GameCell& of the grid: the GameCell setters
+				 * and assigning a GameCell modify the cell of the grid, and
+				 * the modifications are recorded for delta frames. It
+				 * converts to a GameCell holding the current value.
+				 */
+				class CellRef {
+						friend class GameGrid;
+						GameGrid* grid;
+						unsigned int idx;
+						CellRef(GameGrid* grid, unsigned int idx) : grid(grid), idx(idx) {
+						}
+					public:
+						CellRef& operator= (const GameCell& cell) {
+							setBGColor(cell.getBGColor());
+							setFGColor(cell.getFGColor());
+							setSymbol(cell.getSymbol());
+							return *this;
+						}
+						CellRef& operator= (const CellRef& cell) {
+							return *this = (GameCell) cell;
+						}
+						operator GameCell() const {
+							return GameCell(getBGColor(), getFGColor(), getSymbol());
+						}
+						void setBGColor(NamedColor bg) {
+							grid->write(&Planes::bg, idx, static_cast<unsigned char>(bg));
+						}
+						void setFGColor(NamedColor fg) {
+							grid->write(&Planes::fg, idx, static_cast<unsigned char>(fg));
+						}
+						void setSymbol(NamedSymbol s) {
+							grid->write(&Planes::symbols, idx, static_cast<unsigned char>(s));
+						}
+						NamedColor getBGColor() const {
+							return static_cast<NamedColor>(grid->planes->bg[idx]);
+						}
+						NamedColor getFGColor() const {
+							return static_cast<NamedColor>(grid->planes->fg[idx]);
+						}
+						NamedSymbol getSymbol() const {
+							return static_cast<NamedSymbol>(grid->planes->symbols[idx]);
+						}
+				};
+
+				/// @brief A row of the grid, as returned by grid[row]
+				class RowRef {
+						friend class GameGrid;
+						GameGrid* grid;
+						int row;
+						RowRef(GameGrid* grid, int row) : grid(grid), row(row) {
+						}
+					public:
+						///@return the cell at column col of the row
+						CellRef operator[] (int col) const {
+							return CellRef(grid, grid->index(row, col));
+						}
+				};
+
+				/// @brief A row of a const grid, as returned by grid[row]
+				class ConstRowRef {
+						friend class GameGrid;
+						const GameGrid* grid;
+						int row;
+						ConstRowRef(const GameGrid* grid, int row) : grid(grid), row(row) {
+						}
+					public:
+						///@return a copy of the cell at column col of the row
+						GameCell operator[] (int col) const {
+							return grid->get(row, col);
+						}
+				};
+
+				/**
+				 * @brief Access a cell as grid[row][col], as with Grid
+				 *
+				 * @param row row of the cell
+				 * @return the row, whose operator[] gives the cell
+				 * @throw std::out_of_range when the cell is accessed, if the
+				 * position is not in the grid
+				 */
+				RowRef operator[] (int row) {
+					return RowRef(this, row);
+				}
+
+				/// @brief Access a cell as grid[row][col], as with Grid
+				///
+				/// @param row row of the cell
+				/// @return the row, whose operator[] gives a copy of the cell
+				ConstRowRef operator[] (int row) const {
+					return ConstRowRef(this, row);
+				}
+
+				/**
+				 * @brief Sets every cell of the grid
+				 * @param cell - colors and symbol of the cells
+				 */
+				void fill(const GameCell& cell) {
+					const unsigned int count = (unsigned int) planes->bg.size();
+					for (unsigned int idx = 0; idx < count; ++idx) {
+						write(&Planes::bg, idx, static_cast<unsigned char>(cell.getBGColor()));
+						write(&Planes::fg, idx, static_cast<unsigned char>(cell.getFGColor()));
+						write(&Planes::symbols, idx, static_cast<unsigned char>(cell.getSymbol()));
+					}
+				}
+
+				/**
+				 * @brief Copies the cells and the delta frame settings of
+				 * another grid of the same dimensions
+				 *
+				 * The cells that differ are recorded as modified, so the
+				 * next frame of this grid holds what changed since its
+				 * previous frame, whatever happened to the other grid in
+				 * between.
+				 *
+				 * @param other grid to copy
+				 * @throw std::invalid_argument if the dimensions differ
+				 */
+				void copyFrom(const GameGrid& other) {
+					if (other.gridSize[0] != gridSize[0] || other.gridSize[1] != gridSize[1])
+						throw std::invalid_argument("GameGrid::copyFrom: dimensions differ");
+					if (deltaFrames != other.deltaFrames || keyframeInterval != other.keyframeInterval)
+						setDeltaFrames(other.deltaFrames, other.keyframeInterval);
+					const unsigned int count = (unsigned int) planes->bg.size();
+					for (unsigned int idx = 0; idx < count; ++idx) {
+						write(&Planes::bg, idx, other.planes->bg[idx]);
+						write(&Planes::fg, idx, other.planes->fg[idx]);
+						write(&Planes::symbols, idx, other.planes->symbols[idx]);
+					}
+				}
+
+				/**
+				 * @brief Copies the cells and the delta frame settings of
+				 * another grid of the same dimensions, without recording
+				 * the cells as modified
+				 *
+				 * For buffers that are not sent themselves, such as the
+				 * frames handed to a sender thread, which compares them to
+				 * the last sent grid with copyFrom().
+				 *
+				 * @param other grid to copy
+				 * @throw std::invalid_argument if the dimensions differ
+				 */
+				void copyCells(const GameGrid& other) {
+					if (other.gridSize[0] != gridSize[0] || other.gridSize[1] != gridSize[1])
+						throw std::invalid_argument("GameGrid::copyCells: dimensions differ");
+					deltaFrames = other.deltaFrames;
+					keyframeInterval = other.keyframeInterval;
+					Planes& p = writablePlanes();
+					other.copyPlanes(p.bg.data(), p.fg.data(), p.symbols.data());
+				}
+
+				/// @brief The cells of a grid at some point of a game
+				///
+				/// A snapshot shares the memory of the grid it was taken from
+				/// until that grid is modified, so taking one is cheap. A
+				/// snapshot can be restored in any grid of the same
+				/// dimensions, from any thread.
+				class Snapshot {
+						friend class GameGrid;
+						std::shared_ptr<const Planes> planes;
+						int rows = 0;
+						int cols = 0;
+					public:
+						///@return whether the snapshot holds no grid
+						bool empty() const {
+							return !planes;
+						}
+				};
+
+				///@return the current cells of the grid
+				Snapshot snapshot() const {
+					Snapshot s;
+					s.planes = planes;
+					s.rows = gridSize[0];
+					s.cols = gridSize[1];
+					return s;
+				}
+
+				/**
+				 * @brief Sets the cells of the grid to those of a snapshot
+				 *
+				 * The grid shares the memory of the snapshot until it is
+				 * modified. The cells that differ are recorded as modified,
+				 * as in copyFrom().
+				 *
+				 * @param s snapshot to restore
+				 * @throw std::invalid_argument if the snapshot is empty or
+				 * its dimensions differ
+				 */
+				void restore(const Snapshot& s) {
+					if (s.empty() || s.rows != gridSize[0] || s.cols != gridSize[1])
+						throw std::invalid_argument("GameGrid::restore: dimensions differ");
+					if (s.planes == planes)
+						return;
+					const Planes& other = *s.planes;
+					const unsigned int count = (unsigned int) planes->bg.size();
+					for (unsigned int idx = 0; idx < count; ++idx)
+						if (planes->bg[idx] != other.bg[idx] || planes->fg[idx] != other.fg[idx]
+							|| planes->symbols[idx] != other.symbols[idx])
+							markChanged(idx);
+					planes = std::const_pointer_cast<Planes>(s.planes);
+				}
+
+				/**
+				 * @brief Get the dimensions of the grid
+				 * @return an array of the number of rows and of columns
+				 */
+				int const * getDimensions() const {
+					return gridSize;
+				}
+
+				/**
+				 * @brief Copies the cells, one byte per cell in row-major order
+				 *
+				 * @param bg receives the background colors, as NamedColor
+				 * @param fg receives the symbol colors, as NamedColor
+				 * @param symbols receives the symbols, as NamedSymbol
+				 */
+				void copyPlanes(unsigned char* bg, unsigned char* fg, unsigned char* symbols) const {
+					const size_t count = planes->bg.size();
+					std::memcpy(bg, planes->bg.data(), count);
+					std::memcpy(fg, planes->fg.data(), count);
+					std::memcpy(symbols, planes->symbols.data(), count);
+				}
+
+				///@return the number of cells modified since the last frame
+				size_t getChangedCellCount() const {
+					return changedCells.size();
+				}
+
+				/**
+				 * @brief Sends only the cells that changed between frames
+				 *
+				 * When at most a quarter of the cells changed since the
+				 * previous frame, getFrameRepresentation() produces a
+				 * "delta" frame holding these cells only. The first frame,
+				 * and then one every keyframeInterval frames, is complete.
+				 * Delta frames require a viewer that supports them.
+				 *
+				 * @param enable true to send delta frames (default is false)
+				 * @param keyframeInterval number of frames between two complete frames
+				 */
+				void setDeltaFrames(bool enable, int keyframeInterval = 60) {
+					deltaFrames = enable;
+					this->keyframeInterval = std::max(1, keyframeInterval);
+					keyframeNeeded = true;
+				}
+
 				virtual const string getDStype() const override {
 					return "GameGrid";
 				}
@@ -472,12 +922,53 @@ namespace bridges {
 				 * GameGrid constructors
 				 *
 				 **/
-				GameGrid (int nbrow = 10, int nbcol = 10)
-					: Grid<GameCell> (nbrow, nbcol) {
-					initializeGrid();
+				GameGrid (int nbrow = 10, int nbcol = 10) {
+					initializeGrid(nbrow, nbcol);
+				}
+
+				/**
+				 * @brief Copies the cells, dimensions and delta frame
+				 * settings of a grid
+				 *
+				 * The copy shares the memory of the cells with g until
+				 * either grid is modified, as a snapshot does. Its first
+				 * frame is a keyframe.
+				 *
+				 * @param g grid to copy
+				 */
+				GameGrid (const GameGrid& g)
+					: DataStructure(g), encoding(g.encoding), planes(g.planes),
+					  deltaFrames(g.deltaFrames), keyframeInterval(g.keyframeInterval) {
+					gridSize[0] = g.gridSize[0];
+					gridSize[1] = g.gridSize[1];
+					changedFlags.assign(planes->bg.size(), 0);
+					changedCells.reserve(planes->bg.size());
 				}
 
-				GameGrid (const GameGrid &) = delete;
+				/**
+				 * @brief Copies the cells, dimensions and delta frame
+				 * settings of a grid, see GameGrid(const GameGrid&)
+				 *
+				 * @param g grid to copy
+				 * @return this grid
+				 */
+				GameGrid& operator= (const GameGrid& g) {
+					if (this == &g)
+						return *this;
+					DataStructure::operator=(g);
+					encoding = g.encoding;
+					gridSize[0] = g.gridSize[0];
+					gridSize[1] = g.gridSize[1];
+					planes = g.planes;
+					deltaFrames = g.deltaFrames;
+					keyframeInterval = g.keyframeInterval;
+					changedFlags.assign(planes->bg.size(), 0);
+					changedCells.clear();
+					changedCells.reserve(planes->bg.size());
+					keyframeNeeded = true;
+					framesSinceKeyframe = 0;
+					return *this;
+				}
 
 				virtual ~GameGrid() = default;
 
@@ -486,30 +977,10 @@ namespace bridges {
 				//public:
 
 				string getRAWRepresentation() const {
-					using bridges::JSONUtil::JSONencode;
-
-					std::vector<unsigned char> bgbuf;
-					std::vector<unsigned char> fgbuf;
-					std::vector<unsigned char> symbolbuf;
-
-					for (int i = 0; i < gridSize[0]; i++) {
-						for (int j = 0; j < gridSize[1]; j++) {
-							bgbuf.push_back(static_cast<unsigned char>(getBGColor(i, j)));
-							fgbuf.push_back(static_cast<unsigned char>(getFGColor(i, j)));
-							symbolbuf.push_back(static_cast<unsigned char>(getSymbol(i, j)));
-						}
-					}
-
-					std::string bgstr = base64::encode (&(bgbuf[0]), bgbuf.size());
-					std::string fgstr = base64::encode (&(fgbuf[0]), fgbuf.size());
-					std::string symbolstr = base64::encode (&(symbolbuf[0]), symbolbuf.size());
-
 					std::string ret;
+					ret.reserve(64 + 3 * base64::encodedLength(planes->bg.size()));
 					// Add the representation of the gamegrid
-					ret += QUOTE + "bg" + QUOTE + COLON + QUOTE + bgstr + QUOTE + COMMA;
-					ret += QUOTE + "fg" + QUOTE + COLON + QUOTE + fgstr + QUOTE + COMMA;
-					ret += QUOTE + "symbols" + QUOTE + COLON + QUOTE + symbolstr + QUOTE;
-
+					appendPlanes(ret, planes->bg.data(), planes->fg.data(), planes->symbols.data(), planes->bg.size());
 					return ret;
 				}
 
@@ -521,18 +992,75 @@ namespace bridges {
 				 **/
 				virtual const string getDataStructureRepresentation () const override {
 					std::string json_str;
-					// specify the encoding
-					json_str = QUOTE + "encoding" + QUOTE + COLON + QUOTE + encoding + QUOTE + COMMA;
-
-					// specify the dimensions of the gamegrid
-					json_str += QUOTE + "dimensions" + QUOTE + COLON +
-						OPEN_BOX + std::to_string(gridSize[0]) + "," + std::to_string(gridSize[1]) + CLOSE_BOX + COMMA;
+					json_str.reserve(128 + 3 * base64::encodedLength(planes->bg.size()));
+					// specify the encoding and the dimensions of the gamegrid
+					appendHeader(json_str, encoding);
 
 					json_str += getRAWRepresentation();
 
 					return json_str + CLOSE_CURLY;
 				}
 
+				/**
+				 * @brief the representation of the next frame of a game
+				 *
+				 * Same as getDataStructureRepresentation(), or the cells
+				 * modified since the previous frame when delta frames are
+				 * enabled and few cells changed. Either way, the modified
+				 * cells are forgotten.
+				 *
+				 * @return the JSON representation of the frame
+				 **/
+				string getFrameRepresentation() const {
+					bool keyframe = nextFrameIsKeyframe();
+					std::string ret = keyframe ? getDataStructureRepresentation()
+						: getDeltaRepresentation();
+					frameProduced(keyframe);
+					return ret;
+				}
+
+				/// @brief the content of a frame as raw buffers, one byte per
+				/// cell, for transports that send binary data
+				struct FrameBuffers {
+					/// whether the buffers hold the whole grid, row-major;
+					/// otherwise they hold the changed cells only
+					bool keyframe = true;
+					/// delta frames: the indices of the changed cells
+					/// (row * width + col), 32-bit little-endian
+					std::string cells;
+					std::string bg;
+					std::string fg;
+					std::string symbols;
+				};
+
+				/**
+				 * @brief the next frame of a game, as getFrameRepresentation()
+				 * but in raw buffers instead of JSON and base64
+				 *
+				 * @param frame receives the frame; its buffers are reused
+				 **/
+				void getFrameBuffers(FrameBuffers& frame) const {
+					bool keyframe = nextFrameIsKeyframe();
+					frame.keyframe = keyframe;
+					if (keyframe) {
+						frame.cells.clear();
+						frame.bg.assign((const char*) planes->bg.data(), planes->bg.size());
+						frame.fg.assign((const char*) planes->fg.data(), planes->fg.size());
+						frame.symbols.assign((const char*) planes->symbols.data(), planes->symbols.size());
+					}
+					else {
+						size_t n = changedCells.size();
+						frame.cells.resize(4 * n);
+						frame.bg.resize(n);
+						frame.fg.resize(n);
+						frame.symbols.resize(n);
+						if (n > 0)
+							fillDelta((unsigned char*) &frame.cells[0], (unsigned char*) &frame.bg[0],
+								(unsigned char*) &frame.fg[0], (unsigned char*) &frame.symbols[0]);
+					}
+					frameProduced(keyframe);
+				}
+
 		};
 	}
 } // end namespace bridges
@@ -0,0 +1,81 @@
+#ifndef GAME_TRANSPORT_H
+#define GAME_TRANSPORT_H
+
+#include <Bridges.h>
+#include <GameGrid.h>
+#include <Scene.h>
+#include <FramePacer.h>
+#include <InputEvent.h>
+#include <string>
+
+namespace bridges {
+	namespace game {
+
+		///@brief This is meant to be an internal class, not something
+		/// that the library user will use. Provides support for input
+		/// handling for the Game API
+		class KeypressListener {
+			public:
+				virtual ~KeypressListener() = default;
+
+				/// @brief called for each key going up or down
+				///
+				/// By default, calls keyup() or keydown() with the event as
+				/// JSON, as the server sent it.
+				virtual void keyEvent(const InputEvent& e) {
+					std::string json = std::string("{\"type\":\"")
+						+ (e.pressed ? "keydown" : "keyup")
+						+ "\",\"key\":\"" + keyName(e.key) + "\"}";
+					if (e.pressed)
+						keydown(json);
+					else
+						keyup(json);
+				}
+
+				virtual void keyup(std::string JSONmessage) {
+				}
+				virtual void keydown(std::string JSONmessage) {
+				}
+		};
+
+		///@brief This is meant to be an internal class, not something
+		/// that the library user will use
+		///
+		/// Where the frames of a game go and where its key events come
+		/// from. SocketConnection talks to the Bridges games server;
+		/// HeadlessTransport keeps everything in the process, to run
+		/// games without network.
+		class GameTransport {
+			public:
+				virtual ~GameTransport() = default;
+
+				/// @brief whether frames are displayed to a player
+				///
+				/// A live game runs at its frame rate and drops the frames
+				/// it cannot send in time; a game that is not live runs as
+				/// fast as possible and sends every frame.
+				virtual bool isLive() const = 0;
+
+				/// @brief listener gets notified of all the key events
+				virtual void registerKeyListener(KeypressListener* listener) = 0;
+
+				/// @brief called by the game loop at the start of each frame
+				/// @param frame number of the frame, from 0
+				virtual void frameStart(long frame) {
+				}
+
+				/// @brief whether to send frames as binary data rather than
+				/// JSON, when the transport supports it
+				virtual void setBinaryFrames(bool enable) {
+				}
+
+				/// @param stats where to record the encode and emit times, may be null
+				virtual void sendDataToServer(const GameGrid& gg, FrameStats* stats = nullptr) = 0;
+
+				/// @param stats where to record the encode and emit times, may be null
+				virtual void sendSceneDataToServer(const Scene& s, FrameStats* stats = nullptr) = 0;
+		};
+	}
+}
+
+#endif
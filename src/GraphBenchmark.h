@@ -2,6 +2,11 @@
 #define GRAPH_BENCHMARK_H
 
 #include <GraphAdjList.h>
+#include <BenchmarkResults.h>
+#include <SweepScheduler.h>
+#include <RunWatchdog.h>
+#include <chrono>
+#include <limits>
 
 namespace bridges {
 	namespace benchmark {
@@ -15,10 +20,88 @@ namespace bridges {
 		class GraphBenchmark {
 			protected:
 				double time_cap;
+				int repetitions;
+				BenchmarkResults* results;
+				double time_budget;
+				bool watchdog;
+
 				GraphBenchmark()
-					: time_cap (std::numeric_limits<double>::max())
+					: time_cap (std::numeric_limits<double>::max()),
+					  repetitions(1), results(nullptr), time_budget(0.),
+					  watchdog(false)
 				{}
 
+				///@return a scheduler tracking the time budget and the time cap of a sweep
+				SweepScheduler newSweep() const {
+					SweepScheduler sweep(1., std::numeric_limits<double>::max(),
+						time_budget > 0. ? time_budget : std::numeric_limits<double>::max());
+					sweep.setMaxRunTime(time_cap);
+					return sweep;
+				}
+
+				/**
+				 * @brief whether a graph of that many edges should be run
+				 *
+				 * The graphs grow along the sweep, so a graph predicted not to
+				 * fit in the time cap or in the remaining budget ends it.
+				 **/
+				bool affordable(const SweepScheduler& sweep, long edgeCount) const {
+					if (time_budget > 0. && sweep.remainingBudget() <= 0.)
+						return false;
+					return sweep.affordable((double)edgeCount);
+				}
+
+				/**
+				 * @brief times runOnce() repetitions times, and records the
+				 * measurements if results are recorded.
+				 *
+				 * With the watchdog on, each run happens in a child process
+				 * that is killed when it exceeds the time cap or the
+				 * remaining budget.
+				 *
+				 * @return the median runtime in seconds, or a negative value
+				 * if a run was aborted
+				 **/
+				template <typename Func>
+				double timeRuns(const std::string& algoName, double x,
+					SweepScheduler& sweep, Func runOnce) {
+					auto timeOnce = [&]() {
+						std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+
+						runOnce();
+
+						std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
+
+						std::chrono::duration<double> elapsed_seconds = end - start;
+						return (double)elapsed_seconds.count();
+					};
+
+					BenchmarkPoint pt;
+					pt.x = x;
+					for (int rep = 0; rep < repetitions; ++rep) {
+						double timeLimit = time_cap;
+						if (time_budget > 0.)
+							timeLimit = std::min(timeLimit, std::max(0., sweep.remainingBudget()));
+
+						double elapsed;
+						if (watchdog && timeLimit < std::numeric_limits<double>::max()) {
+							if (!RunWatchdog::run(timeLimit, timeOnce, elapsed)) {
+								std::cerr << algoName << " aborted on " << x << " edges\n";
+								return -1.;
+							}
+						}
+						else
+							elapsed = timeOnce();
+						pt.samples.push_back(elapsed);
+					}
+
+					if (results)
+						for (double t : pt.samples)
+							results->addSample(algoName, x, t);
+					sweep.record(x, pt.median());
+					return pt.median();
+				}
+
 				///@returns a triplet: the graph, the number of vertices, and the number of edges
 				std::tuple<long, long> generateWikidataMovieActor (int yearmin, int yearmax, GraphAdjList<std::string>& moviegraph) {
 					DataSource ds;
@@ -113,6 +196,62 @@ namespace bridges {
 					return time_cap;
 				}
 
+				/**
+				 * @brief Sets how many times the algorithm is run on each graph
+				 *
+				 * The plotted runtime is the median of the runs. Several runs
+				 * are needed for BenchmarkComparison to test the significance
+				 * of a difference.
+				 *
+				 * @param r number of runs per graph (default is 1)
+				 **/
+				void setRepetitions(int r) {
+					if (r <= 0)
+						throw std::string("repetitions should be positive");
+					repetitions = r;
+				}
+
+				/**
+				 * @brief Records all the measurements of the following runs
+				 *
+				 * Points are identified by the number of edges of the graph.
+				 *
+				 * @param r results to record to; it must outlive the
+				 * benchmark runs
+				 **/
+				void recordResults(BenchmarkResults& r) {
+					results = &r;
+				}
+
+				/**
+				 * @brief sets a total time for the benchmark of one algorithm
+				 *
+				 * The runtimes measured so far are used to predict the
+				 * runtime on the next graph, which is skipped (and the
+				 * benchmark ends) if it is not predicted to fit in what is
+				 * left of the budget or in the time cap.
+				 *
+				 * @param budget_in_s time budget in seconds (0, the default, means no budget)
+				 **/
+				void setTimeBudget(double budget_in_s) {
+					time_budget = budget_in_s;
+				}
+
+				/**
+				 * @brief Aborts the runs that take too long
+				 *
+				 * When on, a run that exceeds the time cap, or what is left
+				 * of the time budget, is killed: it is not plotted and the
+				 * benchmark ends. The runs happen in a child process, so the
+				 * algorithm can not have side effects visible from the
+				 * benchmark. Runs can not be aborted on Windows.
+				 *
+				 * @param w true to abort the runs that take too long
+				 **/
+				void setWatchdog(bool w) {
+					watchdog = w;
+				}
+
 		};
 	}
 }
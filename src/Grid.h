@@ -4,7 +4,16 @@
 
 #include "DataStructure.h"
 #include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
 #include "base64.h"
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 using namespace std;
 
@@ -29,26 +38,113 @@ namespace bridges {
 		template <typename E>
 		class Grid : public  DataStructure {
 
+			public:
+				/**
+				 * @brief A view on one row of a Grid
+				 *
+				 * It is a pointer to the contiguous cells of the row and does
+				 * not check its indices. It is invalidated when the grid is
+				 * resized or destroyed.
+				 *
+				 * @param T E or const E
+				 */
+				template <typename T>
+				class RowView {
+						T* first;
+						int length;
+					public:
+						RowView(T* f, int l)
+							: first(f), length(l)
+						{}
+
+						T& operator[] (int col) const {
+							return first[col];
+						}
+
+						T* begin() const {
+							return first;
+						}
+
+						T* end() const {
+							return first + length;
+						}
+
+						T* data() const {
+							return first;
+						}
+
+						int size() const {
+							return length;
+						}
+				};
+
 			private:
+				/// cells are aligned on cache lines
+				static const size_t alignment = 64;
+
 				void allocateGrid() {
-					int rows = gridSize[0];
-					int cols = gridSize[1];
-					grid = new E*[rows];
-					for (int j = 0; j < rows; j++)  {
-						grid[j] = new E[cols];
+					size_t count = cellCount();
+					if (count == 0)
+						return;
+
+					void* mem = nullptr;
+					size_t bytes = count * sizeof(E);
+#ifdef _WIN32
+					mem = _aligned_malloc(bytes, alignment);
+#else
+					if (posix_memalign(&mem, alignment, bytes) != 0)
+						mem = nullptr;
+#endif
+					if (mem == nullptr)
+						throw std::bad_alloc();
+
+					E* cells = static_cast<E*>(mem);
+					size_t built = 0;
+					try {
+						for (; built < count; ++built)
+							new (cells + built) E();
+					}
+					catch (...) {
+						while (built > 0)
+							cells[--built].~E();
+						freeMemory(mem);
+						throw;
 					}
+					grid = cells;
 				}
 
 				void deallocateGrid() {
 					if (grid) {
-						for (int i = 0; i < gridSize[0]; i++)  {
-							delete[] grid[i];
-						}
-						delete[] grid;
+						size_t count = cellCount();
+						for (size_t i = 0; i < count; ++i)
+							grid[i].~E();
+						freeMemory(grid);
 					}
 					grid = nullptr;
 				}
 
+				static void freeMemory(void* mem) {
+#ifdef _WIN32
+					_aligned_free(mem);
+#else
+					free(mem);
+#endif
+				}
+
+				/// copies the cells of a grid of the same dimensions
+				void copyCells(const Grid& g) {
+					copyCells(g.grid, std::integral_constant<bool, std::is_trivially_copyable<E>::value>());
+				}
+
+				void copyCells(const E* from, std::true_type) {
+					if (cellCount() > 0)
+						std::memcpy(static_cast<void*>(grid), from, cellCount() * sizeof(E));
+				}
+
+				void copyCells(const E* from, std::false_type) {
+					std::copy(from, from + cellCount(), grid);
+				}
+
 				void checkRowCol(int row, int col) const {
 					if (row < 0 || col < 0 || row >= gridSize[0] || col >= gridSize[1])
 						throw "invalid location in Grid";
@@ -56,11 +152,17 @@ namespace bridges {
 				}
 
 			protected:
-				E  **grid = nullptr;
+				/// cells in row-major order: (row, col) is grid[row * gridSize[1] + col]
+				E* grid = nullptr;
 
 				int gridSize[2];
 				int maxGridSize[2]  = {1080, 1920};
 
+				/// number of cells
+				size_t cellCount() const {
+					return (size_t) gridSize[0] * (size_t) gridSize[1];
+				}
+
 			public:
 				/**
 				 * @brief Return the data structure type
@@ -106,11 +208,22 @@ namespace bridges {
 				 */
 				Grid(const Grid& g)
 					: Grid(g.gridSize[0], g.gridSize[1]) {
-					for (int i = 0; i < gridSize[0]; i++) {
-						for (int j = 0; j < gridSize[1]; j++) {
-							set (i, j, g.get(i, j));
-						}
-					}
+					copyCells(g);
+				}
+
+				/**
+				 * @brief Move constructor, takes the cells of g
+				 *
+				 * g is left empty (0 x 0).
+				 * @param g input grid
+				 */
+				Grid(Grid&& g) noexcept
+					: grid(g.grid) {
+					gridSize[0] = g.gridSize[0];
+					gridSize[1] = g.gridSize[1];
+					g.grid = nullptr;
+					g.gridSize[0] = 0;
+					g.gridSize[1] = 0;
 				}
 
 				/**
@@ -124,35 +237,52 @@ namespace bridges {
 				 * copy constructor
 				 */
 				Grid& operator=(const Grid& g) {
+					if (this == &g)
+						return *this;
 					if (this->gridSize[0] != g.gridSize[0] ||
 						this->gridSize[1] != g.gridSize[1] ) {
-						deallocateGrid();
 						setDimensions(g.gridSize[0], g.gridSize[1]);
 					}
-					for (int i = 0; i < gridSize[0]; i++) {
-						for (int j = 0; j < gridSize[1]; j++) {
-							set (i, j, g.get(i, j));
-						}
-					}
+					copyCells(g);
 
 					return *this;
 				}
 
+				/**
+				 * move assignment, takes the cells of g
+				 */
+				Grid& operator=(Grid&& g) noexcept {
+					if (this == &g)
+						return *this;
+					deallocateGrid();
+					grid = g.grid;
+					gridSize[0] = g.gridSize[0];
+					gridSize[1] = g.gridSize[1];
+					g.grid = nullptr;
+					g.gridSize[0] = 0;
+					g.gridSize[1] = 0;
+					return *this;
+				}
+
 				/**
 				 * @brief Construct the grid given the dimensions
 				 *
+				 * The content of the grid is lost.
+				 *
 				 * @param rows height of grid
 				 * @param cols width of grid
+				 * @throw std::invalid_argument if the grid is larger than
+				 * 1080 x 1920, the largest grid the server displays
 				 */
 				void setDimensions(int rows, int cols) {
+					if (rows < 0 || cols < 0 || rows > maxGridSize[0] || cols > maxGridSize[1])
+						throw std::invalid_argument("Grid Maximum Size (" + std::to_string(maxGridSize[0])
+							+ " x " + std::to_string(maxGridSize[1]) + ") exceeded! Provided Size: "
+							+ std::to_string(rows) + " x " + std::to_string(cols)
+							+ ". Use a TiledColorGrid for larger images.");
+					deallocateGrid();
 					gridSize[0] = rows;
 					gridSize[1] = cols;
-					if (rows > maxGridSize[0] || cols > maxGridSize[1]) {
-						cerr << "Grid Maximum Size (1080 x 1920) exceeded!\n"
-							<< "Provided Size: " << rows << " x " << cols
-							<< ".  Aborting" << endl << endl;
-						exit(-1);
-					}
 					allocateGrid ();
 				}
 
@@ -174,7 +304,7 @@ namespace bridges {
 				E const& get(int row, int col) const {
 					checkRowCol(row, col);
 
-					return grid[row][col];
+					return grid[row * gridSize[1] + col];
 				}
 				// set the (row, col) element in the grid
 				/**
@@ -186,7 +316,77 @@ namespace bridges {
 				void set(int row, int col, E val) {
 					checkRowCol(row, col);
 
-					grid[row][col]  = val;
+					grid[row * gridSize[1] + col]  = val;
+				}
+
+				/**
+				 * @brief Get the (row, col) element without checking the
+				 * location
+				 *
+				 * Faster than get() in loops that already stay in the grid.
+				 * @param row height of grid
+				 * @param col width of grid
+				 * @return the element at row, col
+				 */
+				E const& getUnchecked(int row, int col) const {
+					return grid[row * gridSize[1] + col];
+				}
+
+				/// @brief mutable version of getUnchecked()
+				E& getUnchecked(int row, int col) {
+					return grid[row * gridSize[1] + col];
+				}
+
+				/**
+				 * @brief Set the (row, col) element without checking the
+				 * location
+				 * @param row height of grid
+				 * @param col width of grid
+				 * @param val value to be set
+				 */
+				void setUnchecked(int row, int col, const E& val) {
+					grid[row * gridSize[1] + col] = val;
+				}
+
+				/**
+				 * @brief View on a row of the grid
+				 *
+				 * The row is checked, the columns of the view are not.
+				 * @param row row of the grid
+				 * @return the cells of the row
+				 */
+				RowView<E> row(int row) {
+					checkRowCol(row, 0);
+					return RowView<E>(grid + (size_t) row * gridSize[1], gridSize[1]);
+				}
+
+				/// @brief const version of row()
+				RowView<const E> row(int row) const {
+					checkRowCol(row, 0);
+					return RowView<const E>(grid + (size_t) row * gridSize[1], gridSize[1]);
+				}
+
+				/**
+				 * @brief the cells of the grid in row-major order
+				 *
+				 * (row, col) is at index row * width + col
+				 * @return pointer to the first cell
+				 */
+				E* data() {
+					return grid;
+				}
+
+				/// @brief const version of data()
+				const E* data() const {
+					return grid;
+				}
+
+				/**
+				 * @brief set all the cells of the grid to a value
+				 * @param val value to be set
+				 */
+				void fill(const E& val) {
+					std::fill(grid, grid + cellCount(), val);
 				}
 
 				/**
@@ -228,7 +428,7 @@ namespace bridges {
 
 						E & operator[] (int col)  {
 							gr.checkRowCol(row, col);
-							return gr.grid[row][col];
+							return gr.grid[row * gr.gridSize[1] + col];
 						}
 				};
 
@@ -0,0 +1,209 @@
+#ifndef HEADLESS_TRANSPORT_H
+#define HEADLESS_TRANSPORT_H
+
+#include <GameTransport.h>
+#include <InputLog.h>
+#include <deque>
+#include <map>
+#include <list>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include <stdexcept>
+
+namespace bridges {
+	namespace game {
+
+		/**
+		 * @brief Runs a game without the Bridges games server.
+		 *
+		 * Frames are kept in memory (the last few, or none) and can be
+		 * written to a file, one JSON frame per line. Key events come
+		 * from a script: each event is delivered at the start of a given
+		 * frame. Events can also be injected with pressKey() while the
+		 * game runs, for instance by an agent playing the game; they are
+		 * delivered at the start of the next frame, by the game thread.
+		 *
+		 * A headless game is not live: it does not wait between frames,
+		 * so it runs as fast as the game loop allows.
+		 *
+		 * \code{.cpp}
+		 * auto headless = std::make_shared<HeadlessTransport>(16);
+		 * headless->addKeyEvent(10, Key::Up, true);
+		 * headless->addKeyEvent(12, Key::Up, false);
+		 * my_game g(headless);
+		 * g.start();
+		 * std::cout << headless->getFrames().back() << std::endl;
+		 * \endcode
+		 *
+		 * loadScript() reads scripts in the format of InputLog, so the
+		 * input of a recorded game can be played again.
+		 *
+		 * This class is not meant to be used directly by students.
+		 **/
+		class HeadlessTransport : public GameTransport {
+				// the listeners and the injected events are guarded by _lock,
+				// pressKey() may be called from any thread
+				std::mutex _lock;
+				std::list<KeypressListener*> key_listeners;
+				std::vector<InputEvent> injected;
+				std::vector<InputEvent> delivering;
+				// only touched by the game thread
+				std::multimap<long, InputEvent> script;
+
+				size_t keepFrames;
+				std::deque<std::string> frames;
+				std::ofstream recording;
+				long sentFrames = 0;
+
+				void record(std::string&& json) {
+					if (recording.is_open())
+						recording << json << '\n';
+					if (keepFrames == 0)
+						return;
+					if (frames.size() == keepFrames)
+						frames.pop_front();
+					frames.push_back(std::move(json));
+				}
+
+				bool recordsFrames() const {
+					return keepFrames > 0 || recording.is_open();
+				}
+
+			public:
+				/// @param keepFrames number of frames kept in memory, the
+				/// most recent ones; 0 to keep none
+				explicit HeadlessTransport(size_t keepFrames = 0)
+					: keepFrames(keepFrames) {
+				}
+
+				virtual bool isLive() const override {
+					return false;
+				}
+
+				virtual void registerKeyListener(KeypressListener* listener) override {
+					std::lock_guard< std::mutex > guard( _lock );
+					key_listeners.push_back(listener);
+				}
+
+				/// @brief delivers the scripted events of this frame and of
+				/// the frames before it that were not delivered yet, then the
+				/// events injected by pressKey() since the previous frame
+				///
+				/// Called by the game thread, so the listeners only ever get
+				/// events from that thread.
+				virtual void frameStart(long frame) override {
+					delivering.clear();
+					while (!script.empty() && script.begin()->first <= frame) {
+						InputEvent e = script.begin()->second;
+						e.time = std::chrono::steady_clock::now();
+						delivering.push_back(e);
+						script.erase(script.begin());
+					}
+					std::lock_guard< std::mutex > guard( _lock );
+					delivering.insert(delivering.end(), injected.begin(), injected.end());
+					injected.clear();
+					for (const InputEvent& e : delivering)
+						for (auto& l : key_listeners)
+							l->keyEvent(e);
+				}
+
+				/**
+				 * @brief schedules a key event
+				 * @param frame frame at the start of which the event happens
+				 * @param key the key
+				 * @param pressed true for the key going down, false for up
+				 */
+				void addKeyEvent(long frame, Key key, bool pressed) {
+					if (key == Key::Unknown)
+						throw std::invalid_argument("unknown key in a game script");
+					InputEvent e;
+					e.key = key;
+					e.pressed = pressed;
+					script.emplace(frame, e);
+				}
+
+				/**
+				 * @brief schedules the key events of a script file
+				 * @param filename the script, see the class description
+				 * @throw std::runtime_error if the file can not be read or a
+				 * line is not an event
+				 */
+				void loadScript(const std::string& filename) {
+					InputLog log;
+					log.load(filename);
+					for (const auto& e : log.getEntries())
+						script.emplace(e.frame, e.event);
+				}
+
+				/// @brief delivers a key event to the game at the start of its
+				/// next frame
+				///
+				/// Can be called from any thread.
+				void pressKey(Key key, bool pressed) {
+					InputEvent e;
+					e.key = key;
+					e.pressed = pressed;
+					e.time = std::chrono::steady_clock::now();
+					std::lock_guard< std::mutex > guard( _lock );
+					injected.push_back(e);
+				}
+
+				/**
+				 * @brief writes all the following frames to a file
+				 * @param filename where to write, one frame per line
+				 * @throw std::runtime_error if the file can not be opened
+				 */
+				void recordTo(const std::string& filename) {
+					recording.close();
+					recording.open(filename);
+					if (!recording)
+						throw std::runtime_error("can not record the game to " + filename);
+				}
+
+				///@return the last frames sent, oldest first
+				const std::deque<std::string>& getFrames() const {
+					return frames;
+				}
+
+				///@return the number of frames sent
+				long getFrameCount() const {
+					return sentFrames;
+				}
+
+				/// Frames are only encoded if they are kept or recorded. The
+				/// changes of the grid or scene accumulate meanwhile, so a
+				/// delta frame is always relative to the previous recorded
+				/// frame.
+				virtual void sendDataToServer(const GameGrid& gg, FrameStats* stats = nullptr) override {
+					++sentFrames;
+					if (!recordsFrames())
+						return;
+					auto begin = FramePacer::clock::now();
+					std::string json = "{" + gg.getFrameRepresentation();
+					auto encoded = FramePacer::clock::now();
+					record(std::move(json));
+					if (stats != nullptr) {
+						stats->recordEncode(encoded - begin);
+						stats->recordEmit(FramePacer::clock::now() - encoded);
+					}
+				}
+
+				virtual void sendSceneDataToServer(const Scene& s, FrameStats* stats = nullptr) override {
+					++sentFrames;
+					if (!recordsFrames())
+						return;
+					auto begin = FramePacer::clock::now();
+					std::string json = "{" + s.getFrameRepresentation();
+					auto encoded = FramePacer::clock::now();
+					record(std::move(json));
+					if (stats != nullptr) {
+						stats->recordEncode(encoded - begin);
+						stats->recordEmit(FramePacer::clock::now() - encoded);
+					}
+				}
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,525 @@
+#ifndef IMAGE_FILE_H
+#define IMAGE_FILE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "ColorGrid.h"
+
+namespace bridges {
+	namespace datastructure {
+
+		/**
+		 * @brief Reads and writes ColorGrids as image files
+		 *
+		 * Supported formats are the Netpbm formats PGM and PPM (P2, P3,
+		 * P5, P6), PAM (P7, grayscale or RGB, with or without alpha) and
+		 * uncompressed 24 and 32-bit BMP. read() recognizes the format
+		 * from the first bytes of the file; write() picks it from the
+		 * extension (.ppm, .pam or .bmp).
+		 *
+		 * Files are mapped in memory when the platform allows it, and the
+		 * pixels are decoded straight into the buffer of the ColorGrid, so
+		 * a directory of images can be processed locally without going
+		 * through the server.
+		 *
+		 * \code{.cpp}
+		 * ColorGrid cg = ImageFile::read("lena.ppm");
+		 * cg.convolve({0, -1, 0, -1, 5, -1, 0, -1, 0}, 3);
+		 * ImageFile::write(cg, "lena-sharp.bmp");
+		 * \endcode
+		 *
+		 * Images larger than a ColorGrid (1080 x 1920) can not be read.
+		 * All the errors of read() and write(), including truncated
+		 * files and oversized images, are reported as
+		 * std::runtime_error.
+		 **/
+		class ImageFile {
+			private:
+				/// the content of a file, mapped in memory if possible
+				class FileBuffer {
+						const unsigned char* ptr = nullptr;
+						size_t len = 0;
+						bool mapped = false;
+						std::vector<unsigned char> copy;
+
+					public:
+						explicit FileBuffer(const std::string& filename) {
+#ifndef _WIN32
+							int fd = open(filename.c_str(), O_RDONLY);
+							if (fd < 0)
+								throw std::runtime_error("can not open " + filename);
+							struct stat st;
+							if (fstat(fd, &st) == 0 && st.st_size > 0) {
+								void* m = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+								if (m != MAP_FAILED) {
+									ptr = static_cast<const unsigned char*>(m);
+									len = (size_t) st.st_size;
+									mapped = true;
+								}
+							}
+							close(fd);
+							if (mapped)
+								return;
+#endif
+							std::ifstream in(filename, std::ios::binary);
+							if (!in)
+								throw std::runtime_error("can not open " + filename);
+							copy.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+							ptr = copy.data();
+							len = copy.size();
+						}
+
+						FileBuffer(const FileBuffer&) = delete;
+						FileBuffer& operator= (const FileBuffer&) = delete;
+
+						~FileBuffer() {
+#ifndef _WIN32
+							if (mapped)
+								munmap(const_cast<unsigned char*>(ptr), len);
+#endif
+						}
+
+						const unsigned char* data() const {
+							return ptr;
+						}
+						size_t size() const {
+							return len;
+						}
+				};
+
+				/// reads the tokens of a Netpbm header, skipping comments
+				class HeaderReader {
+						const unsigned char* p;
+						const unsigned char* end;
+
+					public:
+						HeaderReader(const unsigned char* begin, const unsigned char* end)
+							: p(begin), end(end) {
+						}
+
+						void skipSpace() {
+							while (p < end && (std::isspace(*p) || *p == '#')) {
+								if (*p == '#')
+									while (p < end && *p != '\n')
+										++p;
+								else
+									++p;
+							}
+						}
+
+						std::string token() {
+							skipSpace();
+							const unsigned char* b = p;
+							while (p < end && !std::isspace(*p) && *p != '#')
+								++p;
+							if (b == p)
+								throw std::runtime_error("truncated image header");
+							return std::string(b, p);
+						}
+
+						int number() {
+							std::string t = token();
+							for (char c : t)
+								if (!std::isdigit((unsigned char) c))
+									throw std::runtime_error("invalid number " + t + " in image header");
+							if (t.size() > 9)
+								throw std::runtime_error("number " + t + " too large in image header");
+							return std::stoi(t);
+						}
+
+						/// binary data starts after the single whitespace that ends the header
+						const unsigned char* binaryStart() {
+							if (p >= end || !std::isspace(*p))
+								throw std::runtime_error("truncated image header");
+							return p + 1;
+						}
+
+						const unsigned char* position() const {
+							return p;
+						}
+				};
+
+				static uint32_t pack(int r, int g, int b, int a) {
+					return (uint32_t) r | ((uint32_t) g << 8) | ((uint32_t) b << 16) | ((uint32_t) a << 24);
+				}
+
+				static uint16_t readLE16(const unsigned char* p) {
+					return (uint16_t) (p[0] | (p[1] << 8));
+				}
+
+				static uint32_t readLE32(const unsigned char* p) {
+					return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+				}
+
+				static void writeLE16(std::vector<unsigned char>& out, uint16_t v) {
+					out.push_back((unsigned char) v);
+					out.push_back((unsigned char) (v >> 8));
+				}
+
+				static void writeLE32(std::vector<unsigned char>& out, uint32_t v) {
+					for (int i = 0; i < 4; ++i)
+						out.push_back((unsigned char) (v >> (8 * i)));
+				}
+
+				static ColorGrid makeGrid(int height, int width, const std::string& filename) {
+					if (height <= 0 || width <= 0)
+						throw std::runtime_error("invalid image dimensions in " + filename);
+					try {
+						return ColorGrid(height, width);
+					}
+					catch (const std::invalid_argument& e) {
+						// reading fails the same way for every bad file
+						throw std::runtime_error(std::string(e.what()) + " Image: " + filename);
+					}
+				}
+
+				/**
+				 * Decodes Netpbm samples (channels per pixel, 1 or 2 bytes
+				 * each) into the pixels of cg
+				 *
+				 * 1 channel is gray, 2 gray and alpha, 3 RGB and 4 RGBA.
+				 **/
+				static void decodeSamples(ColorGrid& cg, const unsigned char* p, const unsigned char* end,
+					int channels, int maxval, bool ascii, const std::string& filename) {
+					Color* px = cg.data();
+					const size_t count = (size_t) cg.getHeight() * cg.getWidth();
+					const size_t samples = count * channels;
+
+					std::vector<int> values;
+					if (ascii) {
+						HeaderReader rd(p, end);
+						values.resize(samples);
+						for (size_t i = 0; i < samples; ++i)
+							values[i] = rd.number();
+					}
+					else {
+						const size_t bytes = samples * (maxval > 255 ? 2 : 1);
+						if ((size_t) (end - p) < bytes)
+							throw std::runtime_error("truncated pixel data in " + filename);
+					}
+
+					// the common case, 8-bit binary RGB(A), needs no rescaling
+					if (!ascii && maxval == 255 && channels >= 3) {
+						for (size_t i = 0; i < count; ++i, p += channels)
+							px[i] = Color::fromRGBA(pack(p[0], p[1], p[2], channels == 4 ? p[3] : 255));
+						return;
+					}
+
+					// rescale the samples from [0, maxval] to [0, 255]
+					std::vector<unsigned char> scale;
+					if (maxval <= 255) {
+						scale.resize(maxval + 1);
+						for (int v = 0; v <= maxval; ++v)
+							scale[v] = (unsigned char) ((v * 255 + maxval / 2) / maxval);
+					}
+					size_t k = 0;
+					auto next = [&]() -> int {
+						int v;
+						if (ascii)
+							v = values[k++];
+						else if (maxval > 255) {
+							v = (p[0] << 8) | p[1];
+							p += 2;
+						}
+						else
+							v = *p++;
+						if (v > maxval)
+							throw std::runtime_error("sample larger than maxval in " + filename);
+						return maxval <= 255 ? scale[v] : (int) ((v * 255L + maxval / 2) / maxval);
+					};
+					for (size_t i = 0; i < count; ++i) {
+						int r, g, b, a = 255;
+						if (channels <= 2) {
+							r = g = b = next();
+							if (channels == 2)
+								a = next();
+						}
+						else {
+							r = next();
+							g = next();
+							b = next();
+							if (channels == 4)
+								a = next();
+						}
+						px[i] = Color::fromRGBA(pack(r, g, b, a));
+					}
+				}
+
+				/// P2, P3, P5 and P6
+				static ColorGrid readPNM(const FileBuffer& f, const std::string& filename) {
+					HeaderReader rd(f.data(), f.data() + f.size());
+					std::string magic = rd.token();
+					int width = rd.number();
+					int height = rd.number();
+					int maxval = rd.number();
+					if (maxval <= 0 || maxval > 65535)
+						throw std::runtime_error("invalid maxval in " + filename);
+					bool ascii = magic == "P2" || magic == "P3";
+					int channels = (magic == "P2" || magic == "P5") ? 1 : 3;
+					const unsigned char* p = ascii ? rd.position() : rd.binaryStart();
+					ColorGrid cg = makeGrid(height, width, filename);
+					decodeSamples(cg, p, f.data() + f.size(), channels, maxval, ascii, filename);
+					return cg;
+				}
+
+				/// P7
+				static ColorGrid readPAM(const FileBuffer& f, const std::string& filename) {
+					HeaderReader rd(f.data(), f.data() + f.size());
+					rd.token();
+					int width = -1, height = -1, depth = -1, maxval = -1;
+					for (;;) {
+						std::string key = rd.token();
+						if (key == "ENDHDR")
+							break;
+						if (key == "WIDTH")
+							width = rd.number();
+						else if (key == "HEIGHT")
+							height = rd.number();
+						else if (key == "DEPTH")
+							depth = rd.number();
+						else if (key == "MAXVAL")
+							maxval = rd.number();
+						else if (key == "TUPLTYPE")
+							rd.token();
+						else
+							throw std::runtime_error("unknown PAM header field " + key + " in " + filename);
+					}
+					if (depth < 1 || depth > 4 || maxval <= 0 || maxval > 65535)
+						throw std::runtime_error("unsupported PAM depth or maxval in " + filename);
+					const unsigned char* p = rd.binaryStart();
+					ColorGrid cg = makeGrid(height, width, filename);
+					decodeSamples(cg, p, f.data() + f.size(), depth, maxval, false, filename);
+					return cg;
+				}
+
+				/// uncompressed 24 and 32-bit BMP
+				static ColorGrid readBMP(const FileBuffer& f, const std::string& filename) {
+					const unsigned char* d = f.data();
+					if (f.size() < 54)
+						throw std::runtime_error("truncated BMP header in " + filename);
+					uint32_t offset = readLE32(d + 10);
+					uint32_t dibSize = readLE32(d + 14);
+					int width = (int) readLE32(d + 18);
+					int height = (int) readLE32(d + 22);
+					int bpp = readLE16(d + 28);
+					uint32_t compression = readLE32(d + 30);
+
+					// masks of BI_BITFIELDS follow the 40-byte header
+					uint32_t masks[4] = {0x00FF0000u, 0x0000FF00u, 0x000000FFu, 0u};
+					if (compression == 3 && bpp == 32) {
+						if (f.size() < 14 + 40 + 12)
+							throw std::runtime_error("truncated BMP header in " + filename);
+						for (int c = 0; c < 3; ++c)
+							masks[c] = readLE32(d + 54 + 4 * c);
+						if (dibSize >= 56 && f.size() >= 14 + 56)
+							masks[3] = readLE32(d + 66);
+					}
+					else if (compression != 0 || (bpp != 24 && bpp != 32))
+						throw std::runtime_error("only uncompressed 24 and 32-bit BMP are supported: " + filename);
+
+					int shifts[4];
+					for (int c = 0; c < 4; ++c) {
+						shifts[c] = 0;
+						if (masks[c] == 0)
+							continue;
+						while (!((masks[c] >> shifts[c]) & 1))
+							++shifts[c];
+						if ((masks[c] >> shifts[c]) != 0xFF)
+							throw std::runtime_error("only 8-bit BMP channels are supported: " + filename);
+					}
+
+					// positive heights are stored bottom-up
+					bool bottomUp = height > 0;
+					if (height == std::numeric_limits<int>::min())
+						throw std::runtime_error("invalid image dimensions in " + filename);
+					height = std::abs(height);
+					ColorGrid cg = makeGrid(height, width, filename);
+					const size_t stride = ((size_t) width * bpp / 8 + 3) & ~(size_t) 3;
+					if (offset > f.size() || (f.size() - offset) / stride < (size_t) height)
+						throw std::runtime_error("truncated pixel data in " + filename);
+
+					Color* px = cg.data();
+					for (int i = 0; i < height; ++i) {
+						const unsigned char* row = d + offset + stride * (bottomUp ? height - 1 - i : i);
+						Color* out = px + (size_t) i * width;
+						if (bpp == 24) {
+							for (int j = 0; j < width; ++j, row += 3)
+								out[j] = Color::fromRGBA(pack(row[2], row[1], row[0], 255));
+						}
+						else {
+							for (int j = 0; j < width; ++j, row += 4) {
+								uint32_t v = readLE32(row);
+								int a = masks[3] ? (int) ((v >> shifts[3]) & 0xFF) : 255;
+								out[j] = Color::fromRGBA(pack((v >> shifts[0]) & 0xFF,
+											(v >> shifts[1]) & 0xFF, (v >> shifts[2]) & 0xFF, a));
+							}
+						}
+					}
+					return cg;
+				}
+
+				static void writeFile(const std::vector<unsigned char>& bytes, const std::string& filename) {
+					std::ofstream out(filename, std::ios::binary);
+					if (!out)
+						throw std::runtime_error("can not open " + filename + " for writing");
+					out.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize) bytes.size());
+					if (!out)
+						throw std::runtime_error("can not write " + filename);
+				}
+
+				static std::string extension(const std::string& filename) {
+					size_t dot = filename.find_last_of('.');
+					std::string ext = dot == std::string::npos ? "" : filename.substr(dot + 1);
+					for (char& c : ext)
+						c = (char) std::tolower((unsigned char) c);
+					return ext;
+				}
+
+			public:
+				/**
+				 * @brief Reads an image file into a ColorGrid
+				 *
+				 * @param filename PGM, PPM, PAM or BMP file
+				 * @return the image
+				 * @throw std::runtime_error if the file can not be read, its
+				 * format is not supported or the image is larger than a
+				 * ColorGrid
+				 **/
+				static ColorGrid read(const std::string& filename) {
+					FileBuffer f(filename);
+					const unsigned char* d = f.data();
+					if (f.size() >= 2 && d[0] == 'P' && (d[1] == '2' || d[1] == '3' || d[1] == '5' || d[1] == '6'))
+						return readPNM(f, filename);
+					if (f.size() >= 2 && d[0] == 'P' && d[1] == '7')
+						return readPAM(f, filename);
+					if (f.size() >= 2 && d[0] == 'B' && d[1] == 'M')
+						return readBMP(f, filename);
+					throw std::runtime_error("unsupported image format: " + filename);
+				}
+
+				/**
+				 * @brief Writes a ColorGrid as a binary PPM (P6) file
+				 *
+				 * PPM has no alpha channel, it is dropped.
+				 **/
+				static void writePPM(const ColorGrid& cg, const std::string& filename) {
+					const int h = cg.getHeight(), w = cg.getWidth();
+					std::string header = "P6\n" + std::to_string(w) + " " + std::to_string(h) + "\n255\n";
+					std::vector<unsigned char> bytes(header.begin(), header.end());
+					size_t pos = bytes.size();
+					bytes.resize(pos + (size_t) h * w * 3);
+					const Color* px = cg.data();
+					for (size_t i = 0; i < (size_t) h * w; ++i) {
+						uint32_t v = px[i].getRGBA();
+						bytes[pos++] = (unsigned char) v;
+						bytes[pos++] = (unsigned char) (v >> 8);
+						bytes[pos++] = (unsigned char) (v >> 16);
+					}
+					writeFile(bytes, filename);
+				}
+
+				/// @brief Writes a ColorGrid as a PAM (P7, RGB_ALPHA) file
+				static void writePAM(const ColorGrid& cg, const std::string& filename) {
+					const int h = cg.getHeight(), w = cg.getWidth();
+					std::string header = "P7\nWIDTH " + std::to_string(w) + "\nHEIGHT " + std::to_string(h)
+						+ "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+					std::vector<unsigned char> bytes(header.begin(), header.end());
+					size_t pos = bytes.size();
+					bytes.resize(pos + (size_t) h * w * 4);
+					const Color* px = cg.data();
+					for (size_t i = 0; i < (size_t) h * w; ++i) {
+						uint32_t v = px[i].getRGBA();
+						for (int c = 0; c < 4; ++c)
+							bytes[pos++] = (unsigned char) (v >> (8 * c));
+					}
+					writeFile(bytes, filename);
+				}
+
+				/**
+				 * @brief Writes a ColorGrid as a 32-bit BMP file
+				 *
+				 * The pixels are stored top-down with an alpha channel
+				 * (BITMAPV4HEADER with bit fields).
+				 **/
+				static void writeBMP(const ColorGrid& cg, const std::string& filename) {
+					const int h = cg.getHeight(), w = cg.getWidth();
+					const uint32_t headers = 14 + 108;
+					const uint32_t pixelBytes = (uint32_t) h * w * 4;
+					std::vector<unsigned char> bytes;
+					bytes.reserve(headers + pixelBytes);
+					bytes.push_back('B');
+					bytes.push_back('M');
+					writeLE32(bytes, headers + pixelBytes);
+					writeLE32(bytes, 0);
+					writeLE32(bytes, headers);
+					writeLE32(bytes, 108);
+					writeLE32(bytes, (uint32_t) w);
+					writeLE32(bytes, (uint32_t) (-h)); // top-down
+					writeLE16(bytes, 1);
+					writeLE16(bytes, 32);
+					writeLE32(bytes, 3); // BI_BITFIELDS
+					writeLE32(bytes, pixelBytes);
+					writeLE32(bytes, 2835); // 72 dpi
+					writeLE32(bytes, 2835);
+					writeLE32(bytes, 0);
+					writeLE32(bytes, 0);
+					writeLE32(bytes, 0x00FF0000u);
+					writeLE32(bytes, 0x0000FF00u);
+					writeLE32(bytes, 0x000000FFu);
+					writeLE32(bytes, 0xFF000000u);
+					writeLE32(bytes, 0x73524742u); // LCS_sRGB
+					bytes.resize(headers, 0); // endpoints and gamma
+					size_t pos = bytes.size();
+					bytes.resize(pos + pixelBytes);
+					const Color* px = cg.data();
+					for (size_t i = 0; i < (size_t) h * w; ++i) {
+						uint32_t v = px[i].getRGBA();
+						bytes[pos++] = (unsigned char) (v >> 16);
+						bytes[pos++] = (unsigned char) (v >> 8);
+						bytes[pos++] = (unsigned char) v;
+						bytes[pos++] = (unsigned char) (v >> 24);
+					}
+					writeFile(bytes, filename);
+				}
+
+				/**
+				 * @brief Writes a ColorGrid as an image file
+				 *
+				 * @param cg the image
+				 * @param filename name of the file; its extension (.ppm,
+				 * .pam or .bmp) selects the format
+				 * @throw std::runtime_error if the extension is not supported
+				 * or the file can not be written
+				 **/
+				static void write(const ColorGrid& cg, const std::string& filename) {
+					std::string ext = extension(filename);
+					if (ext == "ppm")
+						writePPM(cg, filename);
+					else if (ext == "pam")
+						writePAM(cg, filename);
+					else if (ext == "bmp")
+						writeBMP(cg, filename);
+					else
+						throw std::runtime_error("unsupported image extension: " + filename);
+				}
+		};
+	}
+}
+
+#endif
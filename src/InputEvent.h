@@ -0,0 +1,96 @@
+#ifndef INPUT_EVENT_GAME_H
+#define INPUT_EVENT_GAME_H
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+namespace bridges {
+	namespace game {
+
+		/// @brief The keys games can read
+		enum class Key {
+			Up, Down, Left, Right,
+			W, A, S, D, Q, Space,
+			Unknown
+		};
+
+		/// number of keys games can read, Key::Unknown excluded
+		const int keyCount = (int) Key::Unknown;
+
+		///@brief This is meant to be an internal class, not something
+		/// that the library user will use
+		///
+		/// A key going down or up, as received from the server.
+		struct InputEvent {
+			Key key = Key::Unknown;
+			bool pressed = false;
+			/// when the event was received
+			std::chrono::steady_clock::time_point time;
+		};
+
+		///@brief This is meant to be an internal class, not something
+		/// that the library user will use
+		///
+		/// What happened to a key during a frame: a press and a release
+		/// within the same frame are both seen, even though the key is
+		/// up again at the end of the frame.
+		struct KeyActivity {
+			/// whether the key is down at the end of the frame
+			bool down = false;
+			/// whether the key went down during the frame
+			bool pressed = false;
+			/// whether the key went up during the frame
+			bool released = false;
+		};
+
+		/**
+		 * @param name name of the key in a browser KeyboardEvent
+		 * @param len length of name
+		 * @return the key, Key::Unknown if games do not read it
+		 */
+		inline Key keyFromName(const char* name, size_t len) {
+			static const struct {
+				const char* name;
+				Key key;
+			} names[] = {
+				{"ArrowUp", Key::Up}, {"ArrowDown", Key::Down},
+				{"ArrowLeft", Key::Left}, {"ArrowRight", Key::Right},
+				{"w", Key::W}, {"a", Key::A}, {"s", Key::S}, {"d", Key::D},
+				{"q", Key::Q}, {" ", Key::Space}
+			};
+			for (const auto& n : names)
+				if (std::strlen(n.name) == len && std::memcmp(n.name, name, len) == 0)
+					return n.key;
+			return Key::Unknown;
+		}
+
+		/// @return the name of the key in game scripts and input logs
+		inline const char* keyScriptName(Key k) {
+			static const char* const names[] = {
+				"up", "down", "left", "right", "w", "a", "s", "d", "q", "space", ""
+			};
+			return names[(int) k];
+		}
+
+		/// @return the key named name in game scripts and input logs,
+		/// Key::Unknown if there is none
+		inline Key keyFromScriptName(const std::string& name) {
+			for (int k = 0; k < keyCount; ++k)
+				if (name == keyScriptName((Key) k))
+					return (Key) k;
+			return Key::Unknown;
+		}
+
+		/// @return the name of the key in a browser KeyboardEvent
+		inline const char* keyName(Key k) {
+			static const char* const names[] = {
+				"ArrowUp", "ArrowDown", "ArrowLeft", "ArrowRight",
+				"w", "a", "s", "d", "q", " ", ""
+			};
+			return names[(int) k];
+		}
+	}
+}
+
+#endif
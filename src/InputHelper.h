@@ -2,6 +2,11 @@
 #define INPUTHELPER_GAME_H
 
 #include <GameBase.h>
+#include <InputEvent.h>
+#include <SPSCRing.h>
+#include <atomic>
+#include <array>
+#include <vector>
 
 namespace bridges {
 	namespace game {
@@ -21,101 +26,161 @@ namespace bridges {
 		class InputHelper: public KeypressListener {
 				bool debug = false;
 
-				bool up = false;
-				bool down = false;
-				bool right = false;
-				bool left = false;
-				bool w = false;
-				bool a = false;
-				bool s = false;
-				bool d = false;
-				bool q = false;
-				bool space = false;
+				// events go from the socket thread to the game thread
+				// without locks; a frame rarely sees more than a few
+				SPSCRing<InputEvent, 256> events;
+				std::atomic<long> lost{0};
+
+			public:
+				/// what happened to each key during the frame
+				typedef std::array<KeyActivity, keyCount> KeyState;
 
 			private:
-				void handleKey(std::string JSONmessage) {
-					using namespace rapidjson;
-					// ...
-					rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator> alloc;
-					Document msg(&alloc);
-					msg.Parse(JSONmessage.c_str());
+				// only touched by the game thread, in update()
+				KeyState keys;
+				std::chrono::steady_clock::time_point lastEvent[keyCount];
+				std::vector<InputEvent> frameEvents;
 
-					std::string type = msg["type"].GetString();
-
-					bool setto = (type.compare("keydown") == 0);
-
-					std::string key = msg["key"].GetString();
-
-					if (key.compare("ArrowUp") == 0)
-						up = setto;
-					else if (key.compare("ArrowDown") == 0)
-						down = setto;
-					else if (key.compare("ArrowLeft") == 0)
-						left = setto;
-					else if (key.compare("ArrowRight") == 0)
-						right = setto;
-					else if (key.compare("w") == 0)
-						w = setto;
-					else if (key.compare("a") == 0)
-						a = setto;
-					else if (key.compare("s") == 0)
-						s = setto;
-					else if (key.compare("d") == 0)
-						d = setto;
-					else if (key.compare("q") == 0)
-						q = setto;
-					else if (key.compare(" ") == 0)
-						space = setto;
+			protected:
+				/// called by the socket thread
+				virtual void keyEvent(const InputEvent& e) override {
+					if (debug)
+						std::cerr << "InputHelper::keyEvent(" << keyName(e.key) << ", "
+							<< e.pressed << ")\n";
+					if (e.key == Key::Unknown)
+						return;
+					if (!events.push(e))
+						lost.fetch_add(1, std::memory_order_relaxed);
 				}
 
-			protected:
 				virtual void keyup(std::string JSONmessage) override {
-					if (debug)
-						std::cerr << "InputHelper::keyup(\"" << JSONmessage << "\")\n";
-					handleKey(JSONmessage);
+					handleKey(JSONmessage, false);
 				}
 
 				virtual void keydown(std::string JSONmessage) override {
-					if (debug)
-						std::cerr << "InputHelper::keydown(\"" << JSONmessage << "\")\n";
-					handleKey(JSONmessage);
+					handleKey(JSONmessage, true);
+				}
+
+			private:
+				void applyFrameEvents() {
+					for (auto& k : keys) {
+						k.pressed = false;
+						k.released = false;
+					}
+					for (const InputEvent& e : frameEvents) {
+						KeyActivity& k = keys[(int) e.key];
+						k.down = e.pressed;
+						if (e.pressed)
+							k.pressed = true;
+						else
+							k.released = true;
+						lastEvent[(int) e.key] = e.time;
+					}
+				}
+
+				void handleKey(const std::string& JSONmessage, bool pressed) {
+					rapidjson::Document msg;
+					msg.Parse(JSONmessage.c_str());
+					if (msg.HasParseError() || !msg.IsObject() || !msg.HasMember("key")
+						|| !msg["key"].IsString())
+						return;
+					InputEvent e;
+					e.key = keyFromName(msg["key"].GetString(), msg["key"].GetStringLength());
+					e.pressed = pressed;
+					e.time = std::chrono::steady_clock::now();
+					keyEvent(e);
 				}
 
 			public:
+				/// @brief applies the key events received since the last call
+				///
+				/// Called by the game thread once per frame, before the game
+				/// reads the keys. A key pressed and released between two
+				/// calls reads as pressed for this frame.
+				void update() {
+					frameEvents.clear();
+					InputEvent e;
+					while (events.pop(e))
+						frameEvents.push_back(e);
+					applyFrameEvents();
+				}
+
+				/// @brief applies the given key events instead of those
+				/// received, to replay a game
+				void update(const std::vector<InputEvent>& replayed) {
+					frameEvents = replayed;
+					applyFrameEvents();
+				}
+
+				///@return the events applied by the last update(), in order
+				const std::vector<InputEvent>& getFrameEvents() const {
+					return frameEvents;
+				}
+
+				///@return what happened to every key during the frame
+				const KeyState& getKeyState() const {
+					return keys;
+				}
+
+				/// @brief restores the keys as returned by getKeyState()
+				void setKeyState(const KeyState& state) {
+					keys = state;
+				}
+
+				///@return what happened to key k during the frame
+				const KeyActivity& activity(Key k) const {
+					return keys[(int) k];
+				}
+
+				///@return whether key k was down at some point during the frame
+				bool isPressed(Key k) const {
+					return keys[(int) k].down || keys[(int) k].pressed;
+				}
+
+				///@return when the last event of key k was received
+				std::chrono::steady_clock::time_point lastEventTime(Key k) const {
+					return lastEvent[(int) k];
+				}
+
+				///@return the number of events dropped because the game did not
+				/// call update() for too long
+				long getLostEvents() const {
+					return lost.load(std::memory_order_relaxed);
+				}
 
 				bool keyUp() const {
-					return up;
+					return isPressed(Key::Up);
 				}
 
 				bool keyDown() const {
-					return down;
+					return isPressed(Key::Down);
 				}
 
 				bool keyLeft() const {
-					return left;
+					return isPressed(Key::Left);
 				}
 
 				bool keyRight() const {
-					return right;
+					return isPressed(Key::Right);
 				}
 
 				bool keyW() const {
-					return w;
+					return isPressed(Key::W);
 				}
 				bool keyA() const {
-					return a;
+					return isPressed(Key::A);
 				}
 				bool keyS() const {
-					return s;
+					return isPressed(Key::S);
 				}
 				bool keyD() const {
-					return d;
+					return isPressed(Key::D);
 				}
 				bool keyQ() const {
-					return q;
+					return isPressed(Key::Q);
 				}
 				bool keySpace() const {
-					return space;
+					return isPressed(Key::Space);
 				}
 
 		};
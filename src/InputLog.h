@@ -0,0 +1,142 @@
+#ifndef INPUT_LOG_GAME_H
+#define INPUT_LOG_GAME_H
+
+#include <InputEvent.h>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace bridges {
+	namespace game {
+
+		/**
+		 * @brief The key events of a game, by frame.
+		 *
+		 * A game records the events it applies at each frame; replaying
+		 * them from a snapshot of the game taken at the same frame
+		 * reproduces the game, as long as the game only depends on its
+		 * state and its input.
+		 *
+		 * The file format of save() and load() is one event per line:
+		 * the frame, the key (up, down, left, right, w, a, s, d, q or
+		 * space) and "down" or "up". Lines starting with # are ignored.
+		 * It is also the script format of HeadlessTransport.
+		 *
+		 * This class is not meant to be used directly by students.
+		 **/
+		class InputLog {
+			public:
+				struct Entry {
+					long frame;
+					InputEvent event;
+				};
+
+			private:
+				// sorted by frame; events of a frame in the order they happened
+				std::vector<Entry> entries;
+
+				static bool beforeFrame(const Entry& e, long frame) {
+					return e.frame < frame;
+				}
+
+				static bool frameBefore(long frame, const Entry& e) {
+					return frame < e.frame;
+				}
+
+			public:
+				/// @brief adds an event after the events already logged for its frame
+				void record(long frame, const InputEvent& e) {
+					Entry entry{frame, e};
+					if (entries.empty() || entries.back().frame <= frame)
+						entries.push_back(entry);
+					else
+						entries.insert(std::upper_bound(entries.begin(), entries.end(), frame, frameBefore),
+							entry);
+				}
+
+				/// @brief forgets the events of frame and of the frames after it
+				void truncate(long frame) {
+					entries.erase(std::lower_bound(entries.begin(), entries.end(), frame, beforeFrame),
+						entries.end());
+				}
+
+				/// @param frame the frame
+				/// @param out receives the events of the frame, in order
+				void eventsAt(long frame, std::vector<InputEvent>& out) const {
+					out.clear();
+					for (auto it = std::lower_bound(entries.begin(), entries.end(), frame, beforeFrame);
+						it != entries.end() && it->frame == frame; ++it)
+						out.push_back(it->event);
+				}
+
+				///@return the events, sorted by frame
+				const std::vector<Entry>& getEntries() const {
+					return entries;
+				}
+
+				///@return the number of events
+				size_t size() const {
+					return entries.size();
+				}
+
+				void clear() {
+					entries.clear();
+				}
+
+				/**
+				 * @brief writes the log to a file
+				 * @throw std::runtime_error if the file can not be written
+				 */
+				void save(const std::string& filename) const {
+					std::ofstream out(filename);
+					if (!out)
+						throw std::runtime_error("can not write input log " + filename);
+					for (const Entry& e : entries)
+						out << e.frame << ' ' << keyScriptName(e.event.key) << ' '
+							<< (e.event.pressed ? "down" : "up") << '\n';
+				}
+
+				/**
+				 * @brief adds the events of a file to the log
+				 * @throw std::runtime_error if the file can not be read or a
+				 * line is not an event
+				 */
+				void load(const std::string& filename) {
+					std::ifstream in(filename);
+					if (!in)
+						throw std::runtime_error("can not open input log " + filename);
+					std::string line;
+					int lineno = 0;
+					while (std::getline(in, line)) {
+						++lineno;
+						std::istringstream ss(line);
+						long frame;
+						std::string key, state;
+						if (!(ss >> frame)) {
+							ss.clear();
+							std::string first;
+							if (!(ss >> first) || first[0] == '#')
+								continue;
+							throw std::runtime_error(filename + ":" + std::to_string(lineno)
+								+ ": expected a frame number");
+						}
+						Key k = Key::Unknown;
+						if (ss >> key >> state)
+							k = keyFromScriptName(key);
+						if (k == Key::Unknown || (state != "down" && state != "up"))
+							throw std::runtime_error(filename + ":" + std::to_string(lineno)
+								+ ": expected \"frame key down|up\"");
+						InputEvent e;
+						e.key = k;
+						e.pressed = (state == "down");
+						record(frame, e);
+					}
+				}
+		};
+	}
+}
+
+#endif
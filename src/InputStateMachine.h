@@ -2,6 +2,7 @@
 #define INPUTSTATEMACHINE_GAME_H
 
 #include <functional>
+#include <InputEvent.h>
 
 namespace bridges {
 	namespace game {
@@ -35,9 +36,34 @@ namespace bridges {
 
 				}
 
+				/// a state machine fed with update(const KeyActivity&)
+				InputStateMachine()
+					: InputStateMachine(nullptr) {
+				}
+
+				/// advances one frame, reading the key with the function
+				/// given at construction
 				void update() {
-					bool currentState = rawState();
+					step(rawState());
+				}
 
+				/// @brief advances one frame from the key events of the frame
+				///
+				/// A press shorter than a frame still goes through
+				/// JUST_PRESSED, and a release followed by a new press within
+				/// a frame is a new press.
+				void update(const KeyActivity& a) {
+					bool wasPressed = (s == JUST_PRESSED || s == STILL_PRESSED);
+					if (wasPressed && a.released && a.pressed) {
+						s = JUST_PRESSED;
+						f = FIRE;
+						return;
+					}
+					step(a.down || a.pressed);
+				}
+
+			private:
+				void step(bool currentState) {
 					//update cycle state
 					switch (s) {
 						case JUST_PRESSED:
@@ -107,6 +133,7 @@ namespace bridges {
 
 				}
 
+			public:
 				bool justPressed() const {
 					return s == JUST_PRESSED;
 				}
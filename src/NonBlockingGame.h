@@ -4,6 +4,9 @@
 #include <GameBase.h>
 #include <InputHelper.h>
 #include <InputStateMachine.h>
+#include <FramePacer.h>
+#include <InputLog.h>
+#include <array>
 
 namespace bridges {
 	namespace game {
@@ -180,8 +183,6 @@ namespace bridges {
 				using GameBase::render;
 				using GameBase::registerKeyListener;
 
-				typedef std::chrono::steady_clock localclock;
-
 				InputHelper ih;
 				InputStateMachine upSM;
 				InputStateMachine downSM;
@@ -196,42 +197,73 @@ namespace bridges {
 				InputStateMachine sSM;
 				InputStateMachine dSM;
 
-				double fps = 30.;
+				FramePacer pacer;
 
-				localclock::time_point timeOfLastFrame;
+				long frame = 0;
+				bool initialized = false;
+				bool logInput = false;
+				InputLog inputLog;
 
-				void handleFrameRate() {
-					using std::chrono::seconds;
-					using std::chrono::microseconds;
-					using std::chrono::duration_cast;
+				std::array<InputStateMachine*, keyCount> stateMachines() {
+					return {{
+							&upSM, &downSM, &leftSM, &rightSM,
+							&wSM, &aSM, &sSM, &dSM, &qSM, &spaceSM
+						}
+					};
+				}
 
-					microseconds frametime = duration_cast<microseconds>(seconds(1l)) / (int)fps;
+				void ensureInitialized() {
+					if (!initialized) {
+						initialized = true;
+						initialize();
+					}
+				}
 
-					localclock::time_point theoretical_next_frame = timeOfLastFrame + frametime;
+				/// runs one frame, with the events received or, if replayed
+				/// is not null, with these events
+				void runFrame(const std::vector<InputEvent>* replayed) {
+					auto begin = FramePacer::clock::now();
+					if (replayed != nullptr)
+						ih.update(*replayed);
+					else {
+						frameStart(frame);
+						ih.update();
+					}
+					if (logInput)
+						for (const InputEvent& e : ih.getFrameEvents())
+							inputLog.record(frame, e);
+					updateInputState();
+					gameLoop();
+					getFrameStats().recordUpdate(FramePacer::clock::now() - begin);
+					render();
+					++frame;
+				}
 
-					auto wait_time = theoretical_next_frame - localclock::now();
+				void updateInputState() {
+					upSM.update(ih.activity(Key::Up));
+					downSM.update(ih.activity(Key::Down));
+					leftSM.update(ih.activity(Key::Left));
+					rightSM.update(ih.activity(Key::Right));
 
-					if (wait_time.count() > 0) {
-						microseconds wait_time_in_us = duration_cast<microseconds>(wait_time);
-						usleep(wait_time_in_us.count());
-					}
+					qSM.update(ih.activity(Key::Q));
+					spaceSM.update(ih.activity(Key::Space));
 
-					timeOfLastFrame = localclock::now();
+					wSM.update(ih.activity(Key::W));
+					aSM.update(ih.activity(Key::A));
+					sSM.update(ih.activity(Key::S));
+					dSM.update(ih.activity(Key::D));
 				}
 
-				void updateInputState() {
-					upSM.update();
-					downSM.update();
-					leftSM.update();
-					rightSM.update();
+				void setup(int nbRow, int nbCol) {
+					if (debug)
+						std::cerr << "nbRow: " << nbRow << " nbCol: " <<
+							nbCol << std::endl;
 
-					qSM.update();
-					spaceSM.update();
+					if (nbRow * nbCol > 48 * 48) {
+						throw "NonBlockingGame can not have a grid of more than 48x48 (or a combination(so 24x96 is ok; 32x96 is not)";
+					}
 
-					wSM.update();
-					aSM.update();
-					sSM.update();
-					dSM.update();
+					registerKeyListener(&ih);
 				}
 
 			public:
@@ -245,28 +277,21 @@ namespace bridges {
 					std::string apikey, int nbRow = 10, int nbCol = 10)
 					: GameBase(assignmentID, username, apikey, nbRow, nbCol),
 					  ih(),
-					  upSM([this]() ->bool {return this->ih.keyUp();}),
-					  downSM([this]() ->bool {return this->ih.keyDown();}),
-					  leftSM([this]() ->bool {return this->ih.keyLeft();}),
-					  rightSM([this]() ->bool {return this->ih.keyRight();}),
-
-					  qSM([this]() ->bool {return this->ih.keyQ();}),
-					  spaceSM([this]() ->bool {return this->ih.keySpace();}),
-
-					  wSM([this]() ->bool {return this->ih.keyW();}),
-					  aSM([this]() ->bool {return this->ih.keyA();}),
-					  sSM([this]() ->bool {return this->ih.keyS();}),
-					  dSM([this]() ->bool {return this->ih.keyD();}) {
-					if (debug)
-						std::cerr << "nbRow: " << nbRow << " nbCol: " <<
-							nbCol << std::endl;
-
-					if (nbRow * nbCol > 48 * 48) {
-						throw "NonBlockingGame can not have a grid of more than 48x48 (or a combination(so 24x96 is ok; 32x96 is not)";
-					}
-
-					registerKeyListener(&ih);
+					  pacer(30., &getFrameStats()) {
+					setup(nbRow, nbCol);
+				}
 
+				/// constructor of a game that does not use the Bridges games
+				/// server, for instance to run it headless
+				/// @param transport     where frames go and key events come from
+				/// @param nbRow         GameGrid height
+				/// @param nbCol         GameGrid width
+				NonBlockingGame(std::shared_ptr<GameTransport> transport,
+					int nbRow = 10, int nbCol = 10)
+					: GameBase(transport, nbRow, nbCol),
+					  ih(),
+					  pacer(30., &getFrameStats()) {
+					setup(nbRow, nbCol);
 				}
 
 				virtual ~NonBlockingGame() = default;
@@ -274,8 +299,10 @@ namespace bridges {
 				/// @brief Call this function from main to start the game. Runs
 				/// exactly once.
 				void start() {
-					timeOfLastFrame = localclock::now();
-					initialize();
+					ensureInitialized();
+					// a game nobody watches runs as fast as it can
+					pacer.setPaced(isLive());
+					pacer.start();
 
 					long framelimit = -1; //negative means no limit
 					{
@@ -287,36 +314,193 @@ namespace bridges {
 							std::cerr << "Setting framelimit to " << framelimit << std::endl;
 						}
 					}
-					long frame = 0;
 					while (!gameover()) {
-						updateInputState();
-						gameLoop();
-						render();
-						handleFrameRate();
-						frame++;
+						runFrame(nullptr);
+						pacer.wait();
 						if (framelimit > 0 && frame > framelimit)
 							quit();
 					}
 				}
 
+				/// @brief The state of a game at the start of a frame
+				///
+				/// The board is shared with the game until it changes, so a
+				/// snapshot is cheap to take and to keep. A snapshot can be
+				/// restored in the game it comes from, to rewind it, or in
+				/// another instance of the same game, to try several inputs
+				/// from the same point, possibly in parallel.
+				struct Snapshot {
+					long frame = 0;
+					bool over = false;
+					GameGrid::Snapshot board;
+					InputHelper::KeyState keys;
+					std::array<InputStateMachine, keyCount> machines;
+					/// from saveState()
+					std::shared_ptr<const void> state;
+				};
+
+				///@return the number of the next frame, from 0
+				long getFrameNumber() const {
+					return frame;
+				}
+
+				///@return whether the game called quit()
+				bool isGameOver() const {
+					return gameover();
+				}
+
+				using GameBase::getBoardWidth;
+				using GameBase::getBoardHeight;
+
+				/// @brief copies the board, for instance as the observation
+				/// of an agent playing the game
+				///
+				/// @param out receives the background colors, then the symbol
+				/// colors, then the symbols, each getBoardHeight() x
+				/// getBoardWidth() bytes in row-major order
+				void observe(unsigned char* out) const {
+					copyBoard(out);
+				}
+
+				/// @brief the current state of the game, see Snapshot
+				///
+				/// The fields of the game itself are only captured if the
+				/// game implements saveState().
+				Snapshot snapshot() {
+					ensureInitialized();
+					Snapshot s;
+					s.frame = frame;
+					s.over = gameover();
+					s.board = getBoardSnapshot();
+					s.keys = ih.getKeyState();
+					auto machines = stateMachines();
+					for (int k = 0; k < keyCount; ++k)
+						s.machines[k] = *machines[k];
+					s.state = saveState();
+					return s;
+				}
+
+				/// @brief puts the game back in the state of a snapshot
+				///
+				/// With input logging, the events logged after the frame of
+				/// the snapshot are forgotten.
+				///
+				/// @param s a snapshot of this game or of another instance of
+				/// the same game, with a board of the same size
+				void restore(const Snapshot& s) {
+					ensureInitialized();
+					restoreBoard(s.board, s.over);
+					ih.setKeyState(s.keys);
+					auto machines = stateMachines();
+					for (int k = 0; k < keyCount; ++k)
+						*machines[k] = s.machines[k];
+					restoreState(s.state);
+					frame = s.frame;
+					if (logInput)
+						inputLog.truncate(frame);
+				}
+
+				/**
+				 * @brief Runs one frame with the given key events, as fast
+				 * as possible, instead of the events received
+				 *
+				 * Starting from the same snapshot, the same events give the
+				 * same game, provided gameLoop() only depends on the state
+				 * of the game (no rand() or clock).
+				 *
+				 * @param events key events of the frame, in order
+				 */
+				void step(const std::vector<InputEvent>& events = std::vector<InputEvent>()) {
+					ensureInitialized();
+					runFrame(&events);
+				}
+
+				/**
+				 * @brief Replays logged key events up to a frame
+				 *
+				 * Runs the frames from the current one to lastFrame included
+				 * with step(), taking the events of each frame from the log.
+				 * Stops early if the game is over.
+				 *
+				 * @param log key events by frame, for instance from
+				 * getInputLog() of an earlier run
+				 * @param lastFrame last frame to run
+				 */
+				void replay(const InputLog& log, long lastFrame) {
+					std::vector<InputEvent> events;
+					while (frame <= lastFrame && !gameover()) {
+						log.eventsAt(frame, events);
+						step(events);
+					}
+				}
+
+				/// @brief Whether to log the key events applied at each frame
+				///
+				/// @param enable true to log the events in getInputLog()
+				void setInputLogging(bool enable) {
+					logInput = enable;
+				}
+
+				///@return the key events applied, by frame, while logging
+				const InputLog& getInputLog() const {
+					return inputLog;
+				}
+
 			protected:
+				/**
+				 * @brief Captures the fields of the game for snapshot()
+				 *
+				 * Games with state beyond the board override this function
+				 * and restoreState(). The returned object must not change
+				 * afterwards, since several games may restore it:
+				 *
+				 * \code{.cpp}
+				 * struct State { int score; int x, y; };
+				 * std::shared_ptr<const void> saveState() const override {
+				 *   return std::make_shared<State>(State{score, x, y});
+				 * }
+				 * void restoreState(const std::shared_ptr<const void>& s) override {
+				 *   const State& st = *std::static_pointer_cast<const State>(s);
+				 *   score = st.score; x = st.x; y = st.y;
+				 * }
+				 * \endcode
+				 *
+				 * @return the fields of the game, nullptr by default
+				 */
+				virtual std::shared_ptr<const void> saveState() const {
+					return nullptr;
+				}
+
+				/// @brief Restores the fields of the game from saveState()
+				///
+				/// @param state an object returned by saveState()
+				virtual void restoreState(const std::shared_ptr<const void>& state) {
+				}
+
 				/// @brief What frame rate is the game running at?
 				///
 				/// @return the target framerate. The game could be somewhat
 				/// slower depending on how computationally expensive the
 				/// gameloop is and on the speed of the network.
 				double getFrameRate() const {
-					return fps;
-				}
-		  void setFrameRate(int fps) {
-		    if (fps > 60) {
-		      throw "fps limited to 60";
-		    }
-		    if (fps <= 0) {
-		      throw "fps should be positive";
-		    }
-		    this->fps = fps;
-		  }
+					return pacer.getFrameRate();
+				}
+
+				/// @brief Set the target frame rate
+				///
+				/// The frames are due at fixed times, so a slow frame does
+				/// not delay the following ones. The game can run faster than
+				/// the 60 frames per second the browser displays, for instance
+				/// to simulate quickly: frames that cannot be sent in time are
+				/// dropped.
+				///
+				/// @param fps frames per second
+				void setFrameRate(double fps) {
+					if (fps <= 0) {
+						throw "fps should be positive";
+					}
+					pacer.setFrameRate(fps);
+				}
 
 				///@brief Is Left currently pressed?
 				///
@@ -3,6 +3,7 @@
 
 #include <GameBase3D.h>
 #include <InputHelper.h>
+#include <FramePacer.h>
 
 namespace bridges {
 	namespace game {
@@ -23,32 +24,9 @@ namespace bridges {
 				using GameBase3D::render;
 				using GameBase3D::registerKeyListener;
 
-				typedef std::chrono::steady_clock localclock;
-
 				InputHelper ih;
 
-				double fps = 30.;
-
-				localclock::time_point timeOfLastFrame;
-
-				void handleFrameRate() {
-					using std::chrono::seconds;
-					using std::chrono::microseconds;
-					using std::chrono::duration_cast;
-
-					microseconds frametime = duration_cast<microseconds>(seconds(1l)) / (int)fps;
-
-					localclock::time_point theoretical_next_frame = timeOfLastFrame + frametime;
-
-					auto wait_time = theoretical_next_frame - localclock::now();
-
-					if (wait_time.count() > 0) {
-						microseconds wait_time_in_us = duration_cast<microseconds>(wait_time);
-						usleep(wait_time_in_us.count());
-					}
-
-					timeOfLastFrame = localclock::now();
-				}
+				FramePacer pacer;
 
 			public:
 				/// constructor
@@ -59,7 +37,18 @@ namespace bridges {
 				/// @param nbCol         GameGrid width
 				NonBlockingGame3D(int assignmentID, std::string username,
 					std::string apikey)
-					: GameBase3D(assignmentID, username, apikey) {
+					: GameBase3D(assignmentID, username, apikey),
+					  pacer(30., &getFrameStats()) {
+
+					registerKeyListener(&ih);
+				}
+
+				/// constructor of a game that does not use the Bridges games
+				/// server, for instance to run it headless
+				/// @param transport     where frames go and key events come from
+				NonBlockingGame3D(std::shared_ptr<GameTransport> transport)
+					: GameBase3D(transport),
+					  pacer(30., &getFrameStats()) {
 
 					registerKeyListener(&ih);
 				}
@@ -68,13 +57,17 @@ namespace bridges {
 
 				/// @brief Call this function from main to start the game. Runs
 				/// exactly once.
+				///
+				/// Calls gameLoop() and sends the scene at each frame until
+				/// the game calls quit() (or FORCE_BRIDGES_FRAMELIMIT frames
+				/// ran), then returns.
 				void start() {
-					timeOfLastFrame = localclock::now();
 					initialize();
+					pacer.setPaced(isLive());
+					pacer.start();
 
 					render();
 
-					exit(0);
 					long framelimit = -1; //negative means no limit
 					{
 						char* str_limit = getenv("FORCE_BRIDGES_FRAMELIMIT");
@@ -87,9 +80,13 @@ namespace bridges {
 					}
 					long frame = 0;
 					while (!gameover()) {
+						auto begin = FramePacer::clock::now();
+						frameStart(frame);
+						ih.update();
 						gameLoop();
+						getFrameStats().recordUpdate(FramePacer::clock::now() - begin);
 						render();
-						handleFrameRate();
+						pacer.wait();
 						frame++;
 						if (framelimit > 0 && frame > framelimit)
 							quit();
@@ -103,7 +100,17 @@ namespace bridges {
 				/// slower depending on how computationally expensive the
 				/// gameloop is and on the speed of the network.
 				double getFrameRate() const {
-					return fps;
+					return pacer.getFrameRate();
+				}
+
+				/// @brief Set the target frame rate
+				///
+				/// @param fps frames per second
+				void setFrameRate(double fps) {
+					if (fps <= 0) {
+						throw "fps should be positive";
+					}
+					pacer.setFrameRate(fps);
 				}
 
 				///@brief Is Left currently pressed?
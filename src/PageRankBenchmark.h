@@ -62,6 +62,11 @@ namespace bridges {
 					std::vector<double> vtxCounts;
 					std::vector<double> edgeCounts;
 
+					if (results)
+						results->setMetadata("benchmark", "PageRankBenchmark");
+
+					SweepScheduler sweep = newSweep();
+
 					for (int years = 0; years < 120; years = 1.2 * years + 1) {
 						int year = 2019 - years;
 						std::cerr << "*" << std::flush;
@@ -70,21 +75,22 @@ namespace bridges {
 						long edgeCount;
 						std::tie(vertexCount, edgeCount) = generateWikidataMovieActor(year, 2019, graph);
 
-						std::unordered_map<std::string, double> pr;
-
-						std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
-
-						pralgo(graph, pr);
+						if (!affordable(sweep, edgeCount))
+							break;
 
-						std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
+						double elapsed = timeRuns(algoName, (double)edgeCount, sweep, [&]() {
+							std::unordered_map<std::string, double> pr;
 
-						std::chrono::duration<double> elapsed_seconds = end - start;
+							pralgo(graph, pr);
+						});
+						if (elapsed < 0.)
+							break;
 
-						time.push_back ((double)elapsed_seconds.count() );
+						time.push_back (elapsed);
 						vtxCounts.push_back ( (double)vertexCount );
 						edgeCounts.push_back ( (double)edgeCount );
 
-						if (elapsed_seconds.count() > time_cap) {
+						if (elapsed > time_cap) {
 							break;
 						}
 					}
@@ -0,0 +1,147 @@
+#ifndef RUN_WATCHDOG_H
+#define RUN_WATCHDOG_H
+
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <iostream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+namespace bridges {
+	namespace benchmark {
+
+		/**
+		 * @brief Runs a function with a time limit, aborting it when the
+		 * limit is exceeded.
+		 *
+		 * A thread can not be safely interrupted in C++, so the function
+		 * runs in a forked child process (which sees a copy of the
+		 * memory of the benchmark, so the input does not need to be
+		 * transferred). A watchdog thread kills the child when the
+		 * deadline passes. The function returns its result (a trivially
+		 * copyable value, typically a runtime) through a pipe.
+		 *
+		 * Memory is shared copy-on-write with the child, so its first
+		 * write to each page takes a fault that copies the page; a timed
+		 * function should write to its input before starting its clock,
+		 * as SortingBenchmark does. The child still starts with cold
+		 * caches and TLB, and the memory it allocates is new to it, so
+		 * watched runs can be slightly slower than runs in-process.
+		 *
+		 * On platforms without fork() (Windows), the function runs
+		 * in-process and can not be aborted.
+		 *
+		 * This class is not meant to be used directly by students.
+		 **/
+		class RunWatchdog {
+			public:
+				/**
+				 * @brief Runs f() with a time limit
+				 *
+				 * @param timeout time limit in seconds
+				 * @param f function to run; its return value is stored in out
+				 * @param out result of f() if it completed
+				 * @return true if f() completed, false if it was aborted
+				 **/
+				template <typename T, typename Func>
+				static bool run(double timeout, Func f, T& out) {
+					static_assert(std::is_trivially_copyable<T>::value,
+						"the result of a watched run must be trivially copyable");
+#ifdef _WIN32
+					out = f();
+					return true;
+#else
+					int fds[2];
+					if (pipe(fds) != 0) {
+						std::cerr << "RunWatchdog: can not create pipe, running without watchdog\n";
+						out = f();
+						return true;
+					}
+
+					std::cout << std::flush;
+					std::cerr << std::flush;
+
+					pid_t pid = fork();
+					if (pid < 0) {
+						close(fds[0]);
+						close(fds[1]);
+						std::cerr << "RunWatchdog: can not fork, running without watchdog\n";
+						out = f();
+						return true;
+					}
+
+					if (pid == 0) { //child
+						close(fds[0]);
+						T res = f();
+						const char* p = reinterpret_cast<const char*>(&res);
+						size_t left = sizeof(T);
+						while (left > 0) {
+							ssize_t w = write(fds[1], p, left);
+							if (w <= 0)
+								_exit(1);
+							p += w;
+							left -= w;
+						}
+						_exit(0);
+					}
+
+					//parent
+					close(fds[1]);
+
+					std::mutex m;
+					std::condition_variable cv;
+					bool done = false;
+					bool killed = false;
+
+					std::thread watchdog([&]() {
+						std::unique_lock<std::mutex> lk(m);
+						auto deadline = std::chrono::steady_clock::now() +
+							std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+								std::chrono::duration<double>(timeout));
+						if (!cv.wait_until(lk, deadline, [&]() {
+						return done;
+					})) {
+							kill(pid, SIGKILL);
+							killed = true;
+						}
+					});
+
+					char* p = reinterpret_cast<char*>(&out);
+					size_t got = 0;
+					while (got < sizeof(T)) {
+						ssize_t r = read(fds[0], p + got, sizeof(T) - got);
+						if (r <= 0)
+							break;
+						got += r;
+					}
+					close(fds[0]);
+
+					//the child is not reaped yet, so the watchdog can not kill
+					//an unrelated process that reused its pid
+					{
+						std::lock_guard<std::mutex> lk(m);
+						done = true;
+					}
+					cv.notify_all();
+					watchdog.join();
+
+					int status;
+					waitpid(pid, &status, 0);
+
+					return !killed && got == sizeof(T)
+						&& WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+				}
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace bridges {
+
+	/**
+	 * @brief A fixed size queue between exactly one producer thread and
+	 * one consumer thread, without locks.
+	 *
+	 * The producer only writes the tail index and the consumer only
+	 * writes the head index, so push() and pop() never wait for each
+	 * other. When the queue is full, push() fails instead of blocking.
+	 *
+	 * This class is not meant to be used directly by students.
+	 *
+	 * @param T type of the elements, copied in and out of the queue
+	 * @param Capacity number of slots, a power of 2
+	 **/
+	template <typename T, std::size_t Capacity>
+	class SPSCRing {
+			static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+				"the capacity of an SPSCRing must be a power of 2");
+
+			T slots[Capacity];
+			// head and tail grow forever and are masked to index slots;
+			// they live on different cache lines so that the two threads
+			// do not invalidate each other's line on every operation.
+			// Padding rather than alignas: before C++17, new ignores
+			// over-alignment, and the games holding a ring are often
+			// allocated with new.
+			char padSlots[64];
+			std::atomic<std::size_t> head{0};
+			char padHead[64];
+			std::atomic<std::size_t> tail{0};
+			char padTail[64];
+
+		public:
+			/**
+			 * @brief adds an element, from the producer thread
+			 * @return false if the queue is full
+			 */
+			bool push(const T& value) {
+				std::size_t t = tail.load(std::memory_order_relaxed);
+				if (t - head.load(std::memory_order_acquire) == Capacity)
+					return false;
+				slots[t & (Capacity - 1)] = value;
+				tail.store(t + 1, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * @brief removes the oldest element, from the consumer thread
+			 * @param value receives the element
+			 * @return false if the queue is empty
+			 */
+			bool pop(T& value) {
+				std::size_t h = head.load(std::memory_order_relaxed);
+				if (h == tail.load(std::memory_order_acquire))
+					return false;
+				value = slots[h & (Capacity - 1)];
+				head.store(h + 1, std::memory_order_release);
+				return true;
+			}
+
+			///@return whether the queue is empty, exact only from the consumer thread
+			bool empty() const {
+				return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+			}
+	};
+}
+
+#endif
@@ -5,10 +5,17 @@
 #include <string>
 #include <list>
 #include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
 
 #include "Camera.h"
 #include "TerrainMesh.h"
 #include "DataStructure.h"
+#include "base64.h"
 
 namespace bridges  {
 	class Scene: public DataStructure {
@@ -17,6 +24,16 @@ namespace bridges  {
 			std::unordered_map<string, TerrainMesh> terrains;
 			Camera  camera;
 
+			bool packedMeshes = false;
+
+			bool deltaFrames = false;
+			int keyframeInterval = 60;
+			// updated by the frames, which are produced from a const scene
+			mutable bool keyframeNeeded = true;
+			mutable int framesSinceKeyframe = 0;
+			// version of each mesh in the last frame, by name
+			mutable std::unordered_map<string, unsigned long> sentVersions;
+
 		public:
 			Scene() {
 				float pos[] = {0., 0., 0.};
@@ -46,7 +63,7 @@ namespace bridges  {
 			/**
 			 * 	@brief get the current camera
 			 */
-			Camera getCamera () {
+			Camera getCamera () const {
 				return camera;
 			}
 
@@ -54,7 +71,7 @@ namespace bridges  {
 			 * @brief add function for TerrainMesh objects
 			 */
 			void add(TerrainMesh terrain) {
-				terrains[terrain.getName()] = terrain;
+				terrains[terrain.getName()] = std::move(terrain);
 			}
 
 			/**
@@ -64,97 +81,322 @@ namespace bridges  {
 				return terrains[mesh_name];
 			}
 
+			/**
+			 * @brief the TerrainMesh objects of the scene, by name
+			 */
+			const std::unordered_map<string, TerrainMesh>& getTerrains() const {
+				return terrains;
+			}
+
 			/**
 			 * @brief remove function for TerrainMesh objects
+			 *
+			 * @param mesh_name name of the mesh to remove
+			 * @return whether the scene had such a mesh
 			 */
-			//			void remove(TerrainMesh scene_object) {
-			//				terrains.remove(scene_object);
-			// 			}
+			bool remove(const string& mesh_name) {
+				return terrains.erase(mesh_name) > 0;
+			}
+
+			/**
+			 * @brief Sends the mesh arrays as packed 32-bit floats
+			 *
+			 * The vertices and colors of each mesh are sent as base64
+			 * strings of little-endian IEEE 754 floats, marked with
+			 * "encoding":"float32", instead of arrays of decimal numbers.
+			 * This is about 3 times smaller and much faster to produce
+			 * and to parse. Packed meshes require a viewer that supports
+			 * them.
+			 *
+			 * @param enable true to pack the meshes (default is false)
+			 */
+			void setPackedMeshes(bool enable) {
+				packedMeshes = enable;
+			}
+
+			///@return whether the mesh arrays are sent as packed floats
+			bool getPackedMeshes() const {
+				return packedMeshes;
+			}
+
+			/**
+			 * @brief Only sends the meshes that changed between frames
+			 *
+			 * A frame produced by getFrameRepresentation() then holds the
+			 * meshes modified since the previous frame, and lists the
+			 * names of the other meshes in "keep": the viewer keeps these
+			 * as they are and drops the meshes that are in neither list.
+			 * The first frame, and then one every keyframeInterval frames,
+			 * holds all the meshes and no "keep" list.
+			 *
+			 * A mesh counts as modified when one of its setters or
+			 * non-const getters was called, see TerrainMesh::markChanged().
+			 *
+			 * @param enable true to send delta frames (default is false)
+			 * @param keyframeInterval number of frames between two complete frames
+			 */
+			void setDeltaFrames(bool enable, int keyframeInterval = 60) {
+				deltaFrames = enable;
+				this->keyframeInterval = std::max(1, keyframeInterval);
+				keyframeNeeded = true;
+			}
+
+			/**
+			 * @brief Continues the frames of another scene
+			 *
+			 * Takes the encoding settings of previous and what its frames
+			 * sent, so that when this scene replaces previous in a game,
+			 * the meshes the two scenes share are not sent again.
+			 *
+			 * @param previous scene whose frames this scene continues
+			 */
+			void continueFrames(const Scene& previous) {
+				packedMeshes = previous.packedMeshes;
+				deltaFrames = previous.deltaFrames;
+				keyframeInterval = previous.keyframeInterval;
+				keyframeNeeded = previous.keyframeNeeded;
+				framesSinceKeyframe = previous.framesSinceKeyframe;
+				sentVersions = previous.sentVersions;
+			}
+
+			/**
+			 * @brief the floats as 32-bit little-endian IEEE 754 numbers
+			 *
+			 * This is the content of the mesh arrays of packed and binary
+			 * frames.
+			 */
+			static std::string packFloat32(const std::vector<float>& values) {
+				std::string buf(4 * values.size(), '\0');
+				for (size_t i = 0; i < values.size(); ++i) {
+					uint32_t bits;
+					std::memcpy(&bits, &values[i], 4);
+					for (int b = 0; b < 4; ++b)
+						buf[4 * i + b] = (char) (bits >> (8 * b));
+				}
+				return buf;
+			}
+
+			/**
+			 * @brief This is meant to be used by the game transports, not by
+			 * students
+			 *
+			 * Chooses the meshes of the next frame, and records them as
+			 * sent.
+			 *
+			 * @param send receives the meshes to send
+			 * @param keep receives the names of the meshes the viewer keeps
+			 * @return true if the frame holds all the meshes, false for a
+			 * delta frame
+			 */
+			bool nextFrameMeshes(std::vector<const TerrainMesh*>& send,
+				std::vector<std::string>& keep) const {
+				send.clear();
+				keep.clear();
+				bool keyframe = !deltaFrames || keyframeNeeded
+					|| framesSinceKeyframe + 1 >= keyframeInterval;
+				std::unordered_map<string, unsigned long> sent;
+				sent.reserve(terrains.size());
+				for (const auto& t : terrains) {
+					const TerrainMesh& tr = t.second;
+					auto it = sentVersions.find(tr.getName());
+					if (!keyframe && it != sentVersions.end() && it->second == tr.getVersion())
+						keep.push_back(tr.getName());
+					else
+						send.push_back(&tr);
+					sent[tr.getName()] = tr.getVersion();
+				}
+				sentVersions.swap(sent);
+				if (keyframe) {
+					keyframeNeeded = false;
+					framesSinceKeyframe = 0;
+				}
+				else
+					++framesSinceKeyframe;
+				return keyframe;
+			}
 
 			virtual const string getDataStructureRepresentation() const
 			override {
-
 				std::string scene_json = OPEN_CURLY;
+				size_t size = 256;
+				for (const auto& t : terrains)
+					size += representationSize(t.second);
+				scene_json.reserve(size);
+				appendHeader(scene_json);
+				bool first = true;
+				for (const auto& t : terrains) {
+					if (!first)
+						scene_json += ',';
+					first = false;
+					appendMesh(scene_json, t.second);
+				}
+				scene_json += "]}";
+				return scene_json;
+			}
+
+			/**
+			 * @brief the representation of the next frame of a game
+			 *
+			 * The scene as in getDataStructureRepresentation(), without
+			 * its opening brace, or only the modified meshes when delta
+			 * frames are enabled. Either way, the meshes are recorded as
+			 * sent.
+			 *
+			 * @return the JSON representation of the frame
+			 **/
+			string getFrameRepresentation() const {
+				std::vector<const TerrainMesh*> send;
+				std::vector<std::string> keep;
+				bool keyframe = nextFrameMeshes(send, keep);
+
+				std::string ret;
+				size_t size = 256 + 32 * keep.size();
+				for (const TerrainMesh* tr : send)
+					size += representationSize(*tr);
+				ret.reserve(size);
+				appendHeader(ret);
+				for (size_t i = 0; i < send.size(); ++i) {
+					if (i > 0)
+						ret += ',';
+					appendMesh(ret, *send[i]);
+				}
+				ret += ']';
+				if (!keyframe) {
+					ret += ",\"keep\":[";
+					for (size_t i = 0; i < keep.size(); ++i) {
+						if (i > 0)
+							ret += ',';
+						ret += QUOTE + keep[i] + QUOTE;
+					}
+					ret += ']';
+				}
+				ret += '}';
+				return ret;
+			}
+
+		private:
+			// what std::to_string() writes, without the temporary string
+			static void appendFloat(std::string& out, float f) {
+				char buf[64];
+				int n = std::snprintf(buf, sizeof(buf), "%f", (double) f);
+				out.append(buf, n);
+			}
+
+			static void appendPacked(std::string& out, const std::vector<float>& values) {
+				std::string bytes = packFloat32(values);
+				size_t pos = out.size();
+				out.resize(pos + base64::encodedLength(bytes.size()));
+				if (!bytes.empty())
+					base64::encode((const BYTE*) bytes.data(), bytes.size(), &out[pos]);
+			}
+
+			// a guess of the size of the mesh in the representation, so
+			// that the string is not reallocated while it is built
+			size_t representationSize(const TerrainMesh& tr) const {
+				size_t floats = tr.getVertices().size() + tr.getColors().size();
+				return 128 + (packedMeshes ? 6 * floats : 10 * floats);
+			}
+
+			// the camera, the lights and the start of the mesh array
+			void appendHeader(std::string& out) const {
 				float pos[3];
-				// add camera
 				camera.getPosition(pos);
-				scene_json +=
-					QUOTE + "camera" + QUOTE + COLON +
-					OPEN_CURLY +
-					QUOTE + "name" + QUOTE  +  COLON +
-					QUOTE + camera.getType() + QUOTE  + COMMA +
+				out += QUOTE + "camera" + QUOTE + COLON + OPEN_CURLY +
+					QUOTE + "name" + QUOTE + COLON +
+					QUOTE + camera.getType() + QUOTE + COMMA +
 					QUOTE + "fov" + QUOTE + COLON +
 					QUOTE + std::to_string(camera.getFov()) + QUOTE + COMMA +
-					QUOTE + "position" + QUOTE + COLON +
-					OPEN_BOX +
-					std::to_string(pos[0]) + COMMA +
-					std::to_string(pos[1]) + COMMA +
-					std::to_string(pos[2])  +
-					CLOSE_BOX +
-					CLOSE_CURLY + COMMA;
+					QUOTE + "position" + QUOTE + COLON + OPEN_BOX;
+				for (int i = 0; i < 3; ++i) {
+					if (i > 0)
+						out += ',';
+					appendFloat(out, pos[i]);
+				}
+				out += CLOSE_BOX + CLOSE_CURLY + COMMA;
 
 				// add lights
-				scene_json += QUOTE + "lights" + QUOTE + COLON +
-					OPEN_BOX + CLOSE_BOX + COMMA;
-
-				// add terrain meshes
-				scene_json +=
-					QUOTE + "meshes" + QUOTE + COLON + OPEN_BOX;
-				for (auto t : terrains) {
-					// get vertices of this mesh
-					TerrainMesh tr = t.second;
-					vector<float> verts = tr.getVertices();
-					vector<float> colors = tr.getColors();
-					scene_json += OPEN_CURLY +
-						QUOTE + "name" + QUOTE + COLON + QUOTE + tr.getName() + QUOTE + COMMA +
-						QUOTE + "type" + QUOTE + COLON + QUOTE + tr.getType() + QUOTE + COMMA +
-						QUOTE + "rows" + QUOTE + COLON + QUOTE + std::to_string(tr.getRows()) + QUOTE + COMMA +
-						QUOTE + "cols" + QUOTE + COLON + QUOTE + std::to_string(tr.getCols()) + QUOTE + COMMA +
-
-						// terrain vertices
-						QUOTE + "vertices" + QUOTE + COLON;
-
-					scene_json += OPEN_BOX;			//vertices start
-					// list vertices one row at a time
-					int k = 0;
-					for (int i = 0; i < tr.getRows(); i++) {
-						scene_json += OPEN_BOX;	// row start
-						for (int j = 0; j < tr.getCols(); j++) {
-							scene_json += std::to_string(verts[k++]) + COMMA;
-						}
-						// remove the last comma
-						scene_json.erase(scene_json.size() - 1);
-						scene_json += CLOSE_BOX + COMMA; // row end
+				out += QUOTE + "lights" + QUOTE + COLON + OPEN_BOX + CLOSE_BOX + COMMA;
+
+				// terrain meshes follow
+				out += QUOTE + "meshes" + QUOTE + COLON + OPEN_BOX;
+			}
+
+			void appendMesh(std::string& out, const TerrainMesh& tr) const {
+				const vector<float>& verts = tr.getVertices();
+				const vector<float>& colors = tr.getColors();
+				int rows = std::max(0, tr.getRows());
+				int cols = std::max(0, tr.getCols());
+				size_t count = (size_t) rows * cols;
+				if (verts.size() < count || colors.size() < 4 * count)
+					throw std::out_of_range("TerrainMesh " + tr.getName()
+						+ ": fewer vertices or colors than rows * cols");
+
+				out += OPEN_CURLY +
+					QUOTE + "name" + QUOTE + COLON + QUOTE + tr.getName() + QUOTE + COMMA +
+					QUOTE + "type" + QUOTE + COLON + QUOTE + tr.getType() + QUOTE + COMMA;
+
+				if (tr.hasPlacement()) {
+					out += QUOTE + "origin" + QUOTE + COLON + OPEN_BOX;
+					appendFloat(out, tr.getOriginX());
+					out += ',';
+					appendFloat(out, tr.getOriginZ());
+					out += CLOSE_BOX + COMMA + QUOTE + "spacing" + QUOTE + COLON;
+					appendFloat(out, tr.getSpacing());
+					out += COMMA;
+				}
+
+				if (packedMeshes) {
+					out += QUOTE + "encoding" + QUOTE + COLON + QUOTE + "float32" + QUOTE + COMMA +
+						QUOTE + "rows" + QUOTE + COLON + std::to_string(rows) + COMMA +
+						QUOTE + "cols" + QUOTE + COLON + std::to_string(cols) + COMMA +
+						QUOTE + "vertices" + QUOTE + COLON + QUOTE;
+					appendPacked(out, verts);
+					out += QUOTE + COMMA + QUOTE + "colors" + QUOTE + COLON + QUOTE;
+					appendPacked(out, colors);
+					out += QUOTE + CLOSE_CURLY;
+					return;
+				}
+
+				out += QUOTE + "rows" + QUOTE + COLON + QUOTE + std::to_string(rows) + QUOTE + COMMA +
+					QUOTE + "cols" + QUOTE + COLON + QUOTE + std::to_string(cols) + QUOTE + COMMA;
+
+				// terrain vertices, one row at a time
+				out += QUOTE + "vertices" + QUOTE + COLON + OPEN_BOX;
+				size_t k = 0;
+				for (int i = 0; i < rows; i++) {
+					if (i > 0)
+						out += ',';
+					out += '[';
+					for (int j = 0; j < cols; j++) {
+						if (j > 0)
+							out += ',';
+						appendFloat(out, verts[k++]);
 					}
-					// remove the last comma
-					scene_json.erase(scene_json.size() - 1);
-					scene_json += CLOSE_BOX + COMMA;	//end of vertices
-					// terrain colors
-					scene_json += QUOTE + "colors" + QUOTE + COLON;
-					scene_json += OPEN_BOX;				//colors start
-
-					// list colors one row at a time
-					k = 0;
-					for (int i = 0; i < tr.getRows(); i++) {
-						scene_json += OPEN_BOX;	// row start
-						for (int j = 0; j < tr.getCols(); j++) {
-							string col_str = std::to_string(colors[k])
-								+ COMMA + std::to_string(colors[k + 1])
-								+ COMMA + std::to_string(colors[k + 2])
-								+ COMMA + std::to_string(colors[k + 3]);
-							scene_json += OPEN_BOX + col_str + CLOSE_BOX +
-								COMMA;
-							k += 4;
+					out += ']';
+				}
+				out += CLOSE_BOX + COMMA;
+
+				// terrain colors, one row at a time, 4 components per vertex
+				out += QUOTE + "colors" + QUOTE + COLON + OPEN_BOX;
+				k = 0;
+				for (int i = 0; i < rows; i++) {
+					if (i > 0)
+						out += ',';
+					out += '[';
+					for (int j = 0; j < cols; j++) {
+						if (j > 0)
+							out += ',';
+						out += '[';
+						for (int c = 0; c < 4; ++c) {
+							if (c > 0)
+								out += ',';
+							appendFloat(out, colors[k++]);
 						}
-						// remove the last comma
-						scene_json.erase(scene_json.size() - 1);
-						scene_json += CLOSE_BOX + COMMA; // row (colors) end
+						out += ']';
 					}
-					// remove the last comma
-					scene_json.erase(scene_json.size() - 1);
-					scene_json += CLOSE_BOX + CLOSE_CURLY + CLOSE_BOX + CLOSE_CURLY;
+					out += ']';
 				}
-				return scene_json;
+				out += CLOSE_BOX + CLOSE_CURLY;
 			}
 	};
 }
@@ -94,6 +94,11 @@ namespace bridges {
 					double reflat = 40.74; //New York City, NC
 					double reflong = -73.98;
 
+					if (results)
+						results->setMetadata("benchmark", "ShortestPathBenchmark");
+
+					SweepScheduler sweep = newSweep();
+
 					for (double radius = 0.02; radius < 0.15; radius += 0.02) {
 						std::cerr << "*" << std::flush;
 						//std::tie(vertexCount, edgeCount)= generateWikidataMovieActor(year, 2019, graph);
@@ -108,22 +113,23 @@ namespace bridges {
 
 						int root = getCenter(osm_data, graph, reflat, reflong);
 
-						std::unordered_map<int, double> level;
-						std::unordered_map<int, int> parent;
-
-						std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
-
-						spalgo(graph, root, level, parent);
+						if (!affordable(sweep, edgeCount))
+							break;
 
-						std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
+						double elapsed = timeRuns(algoName, (double)edgeCount, sweep, [&]() {
+							std::unordered_map<int, double> level;
+							std::unordered_map<int, int> parent;
 
-						std::chrono::duration<double> elapsed_seconds = end - start;
+							spalgo(graph, root, level, parent);
+						});
+						if (elapsed < 0.)
+							break;
 
-						time.push_back ((double)elapsed_seconds.count() );
+						time.push_back (elapsed);
 						vtxCounts.push_back ( (double)vertexCount );
 						edgeCounts.push_back ( (double)edgeCount );
 
-						if (elapsed_seconds.count() > time_cap) {
+						if (elapsed > time_cap) {
 							break;
 						}
 					}
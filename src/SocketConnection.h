@@ -13,14 +13,13 @@
 //////////////////////////////////////////////////////
 
 #include "sio_client.h"
-#include "internal/sio_packet.h"
 #include <Bridges.h>
-#include <GameGrid.h>
-#include <Scene.h>
+#include <GameTransport.h>
 #include <list>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 #include <functional>
 
 #include <unistd.h>
@@ -28,15 +27,6 @@
 namespace bridges {
 	namespace game {
 
-		///@brief This is meant to be an internal class, not something
-		/// that the library user will use. Provides support for input
-		/// handling for the Game API
-		class KeypressListener {
-			public:
-				virtual void keyup(std::string JSONmessage) = 0;
-				virtual void keydown(std::string JSONmessage) = 0;
-		};
-
 		///@brief This is meant to be an internal class, not something
 		/// that the library user will use
 		///
@@ -45,7 +35,7 @@ namespace bridges {
 		///
 		/// @author Erik Saule, David Burlinson
 		/// @date 2019, 12/29/20
-		class SocketConnection {
+		class SocketConnection : public GameTransport {
 				bool debug = false;
 				bool debugVerbose = false;
 				sio::client client;
@@ -60,43 +50,110 @@ namespace bridges {
 
 				std::list<KeypressListener*> key_listeners;
 
+				// set by the game thread, read by the thread sending frames
+				std::atomic<bool> binaryFrames{false};
+
 			private:
-				///This is a trick to convert a SocketIO message back to a JSON object (which it was originally.)
-				///This will make the future interface a lot easier to manage.
-				std::string getJSON( sio::message::ptr msg ) {
-					//This function is from SocketIO's issues.
-					static sio::packet_manager manager;
-					static std::mutex packetLock;
-					std::lock_guard< std::mutex > guard( packetLock );
-
-					std::stringstream ss;
-					sio::packet packet( "/", msg );
-					manager.encode( packet, [&](bool isBinary, std::shared_ptr<const std::string> const & json) {
-						ss << *json;
-						assert( !isBinary );
-					});
-					manager.reset();
-
-					// Need to strip off the message type flags (typically '42',
-					// but there are other possible combinations).
-					std::string result = ss.str();
-					std::size_t indexList = result.find( '[' );
-					std::size_t indexObject = result.find( '{' );
-					std::size_t indexString = result.find( '"' );
-					std::size_t index = indexList;
-					if ( indexObject != std::string::npos && indexObject < index )
-						index = indexObject;
-					if ( indexString != std::string::npos && indexString < index )
-						index = indexString;
-
-					if ( index == std::string::npos ) {
-						std::cerr << "Error decoding json object" << std::endl << " Body: " << result << std::endl;
-						return "";
-					}
-					return result.substr(index);
+				static sio::message::ptr binary(std::string&& buf) {
+					return sio::binary_message::create(std::make_shared<const std::string>(std::move(buf)));
 				}
 
 			public:
+				/**
+				 * @brief the frame of the grid, with the cells as binary
+				 * attachments
+				 *
+				 * "encoding" is "raw" or "delta", "dimensions" holds the
+				 * rows and columns, "bg", "fg" and "symbols" one byte per
+				 * cell. Delta frames also have "cells", the indices of the
+				 * changed cells as 32-bit little-endian integers.
+				 *
+				 * This is meant to be used by the transport, not by
+				 * students.
+				 **/
+				static sio::message::ptr getGridMessage(const GameGrid& gg) {
+					GameGrid::FrameBuffers frame;
+					gg.getFrameBuffers(frame);
+
+					auto msg = sio::object_message::create();
+					auto& fields = msg->get_map();
+					fields["encoding"] = sio::string_message::create(frame.keyframe ? "raw" : "delta");
+					auto dims = sio::array_message::create();
+					dims->get_vector().push_back(sio::int_message::create(gg.getDimensions()[0]));
+					dims->get_vector().push_back(sio::int_message::create(gg.getDimensions()[1]));
+					fields["dimensions"] = dims;
+					if (!frame.keyframe)
+						fields["cells"] = binary(std::move(frame.cells));
+					fields["bg"] = binary(std::move(frame.bg));
+					fields["fg"] = binary(std::move(frame.fg));
+					fields["symbols"] = binary(std::move(frame.symbols));
+					return msg;
+				}
+
+				/**
+				 * @brief the scene, with the mesh arrays as binary attachments
+				 *
+				 * "camera" has its "name", "fov" and "position", "meshes"
+				 * the meshes of the frame, whose "vertices" and "colors"
+				 * are little-endian 32-bit floats (Scene::packFloat32()).
+				 * Delta frames also list the names of the unchanged meshes
+				 * in "keep".
+				 *
+				 * This is meant to be used by the transport, not by
+				 * students.
+				 **/
+				static sio::message::ptr getSceneMessage(const Scene& s) {
+					auto msg = sio::object_message::create();
+					auto& fields = msg->get_map();
+
+					Camera camera = s.getCamera();
+					float pos[3];
+					camera.getPosition(pos);
+					auto cam = sio::object_message::create();
+					cam->get_map()["name"] = sio::string_message::create(camera.getType());
+					cam->get_map()["fov"] = sio::int_message::create(camera.getFov());
+					auto position = sio::array_message::create();
+					for (float p : pos)
+						position->get_vector().push_back(sio::double_message::create(p));
+					cam->get_map()["position"] = position;
+					fields["camera"] = cam;
+
+					fields["lights"] = sio::array_message::create();
+
+					// all the meshes or, with delta frames, the modified ones
+					std::vector<const TerrainMesh*> send;
+					std::vector<std::string> keep;
+					bool keyframe = s.nextFrameMeshes(send, keep);
+
+					auto meshes = sio::array_message::create();
+					for (const TerrainMesh* t : send) {
+						const TerrainMesh& tr = *t;
+						auto mesh = sio::object_message::create();
+						auto& m = mesh->get_map();
+						m["name"] = sio::string_message::create(tr.getName());
+						m["type"] = sio::string_message::create(tr.getType());
+						m["rows"] = sio::int_message::create(tr.getRows());
+						m["cols"] = sio::int_message::create(tr.getCols());
+						if (tr.hasPlacement()) {
+							auto origin = sio::array_message::create();
+							origin->get_vector().push_back(sio::double_message::create(tr.getOriginX()));
+							origin->get_vector().push_back(sio::double_message::create(tr.getOriginZ()));
+							m["origin"] = origin;
+							m["spacing"] = sio::double_message::create(tr.getSpacing());
+						}
+						m["vertices"] = binary(Scene::packFloat32(tr.getVertices()));
+						m["colors"] = binary(Scene::packFloat32(tr.getColors()));
+						meshes->get_vector().push_back(mesh);
+					}
+					fields["meshes"] = meshes;
+					if (!keyframe) {
+						auto kept = sio::array_message::create();
+						for (const auto& name : keep)
+							kept->get_vector().push_back(sio::string_message::create(name));
+						fields["keep"] = kept;
+					}
+					return msg;
+				}
 
 				//Bridges object should have been initialized with correct
 				//credentials and server at this point.
@@ -125,34 +182,55 @@ namespace bridges {
 
 				}
 
-				void registerKeyListener(KeypressListener* p) {
+				virtual bool isLive() const override {
+					return true;
+				}
+
+				virtual void registerKeyListener(KeypressListener* p) override {
 					std::lock_guard< std::mutex > guard( _lock );
 
 					key_listeners.push_back(p);
 				}
 
-				void forwardKeyUp(sio::event & e) {
-					std::lock_guard< std::mutex > guard( _lock );
+				/// @brief reads a key event straight from the socket.io object
+				/// {"type": ..., "key": ...} the server sends
+				///
+				/// @return false if the message is not a key games read
+				static bool decodeKey(const sio::message::ptr& msg, bool pressed, InputEvent& ev) {
+					if (!msg || msg->get_flag() != sio::message::flag_object)
+						return false;
+					const auto& fields = msg->get_map();
+					auto key = fields.find("key");
+					if (key == fields.end() || !key->second
+						|| key->second->get_flag() != sio::message::flag_string)
+						return false;
+					const std::string& name = key->second->get_string();
+					ev.key = keyFromName(name.data(), name.size());
+					ev.pressed = pressed;
+					ev.time = std::chrono::steady_clock::now();
+					return ev.key != Key::Unknown;
+				}
 
-					std::string jsonmsg = getJSON(e.get_message());
+				void forwardKey(sio::event & e, bool pressed) {
+					InputEvent ev;
+					if (!decodeKey(e.get_message(), pressed, ev))
+						return;
 
 					if (debug)
-						std::cerr << "forwardKeyUp:" << e.get_nsp() << " " << e.get_name() << " : " << jsonmsg << "\n";
+						std::cerr << (pressed ? "forwardKeyDown:" : "forwardKeyUp:") << e.get_nsp()
+							<< " " << e.get_name() << " : " << keyName(ev.key) << "\n";
 
+					std::lock_guard< std::mutex > guard( _lock );
 					for (auto& ptr : key_listeners)
-						ptr->keyup(jsonmsg);
+						ptr->keyEvent(ev);
 				}
 
-				void forwardKeyDown(sio::event & e) {
-					std::lock_guard< std::mutex > guard( _lock );
-
-					std::string jsonmsg = getJSON(e.get_message());
-
-					if (debug)
-						std::cerr << "forwardKeyDown:" << e.get_nsp() << " " << e.get_name() << " : " << jsonmsg << "\n";
+				void forwardKeyUp(sio::event & e) {
+					forwardKey(e, false);
+				}
 
-					for (auto& ptr : key_listeners)
-						ptr->keydown(jsonmsg);
+				void forwardKeyDown(sio::event & e) {
+					forwardKey(e, true);
 				}
 
 				~SocketConnection() {
@@ -232,7 +310,7 @@ namespace bridges {
 
 				void on_announcement (std::string const& name, sio::message::ptr const& data, bool isAck, sio::message::list &ack_resp) {
 					if (debug)
-						std::cerr << "announcement something\n";
+						std::cerr << "announcement " << name << "\n";
 				}
 
 				void wait_on_connection () {
@@ -252,20 +330,58 @@ namespace bridges {
 
 				}
 
-				void sendDataToServer(const GameGrid& gg) {
+				/// @brief sends the frames as socket.io objects whose buffers
+				/// (cells, mesh vertices and colors) are binary attachments,
+				/// on the "gamegrid:recv:binary" and "scene:recv:binary"
+				/// events, instead of JSON strings with base64 buffers
+				virtual void setBinaryFrames(bool enable) override {
+					binaryFrames = enable;
+				}
+
+				/// @param stats where to record the encode and emit times, may be null
+				virtual void sendDataToServer(const GameGrid& gg, FrameStats* stats = nullptr) override {
 					if (debug && debugVerbose)
 						std::cerr << "Sending GameGrid\n";
-					std::string gridjson = "{" + gg.getDataStructureRepresentation();
-
-					current_socket->emit("gamegrid:recv", gridjson);
+					auto begin = FramePacer::clock::now();
+					decltype(begin) encoded;
+					if (binaryFrames) {
+						sio::message::ptr msg = getGridMessage(gg);
+						encoded = FramePacer::clock::now();
+						current_socket->emit("gamegrid:recv:binary", msg);
+					}
+					else {
+						// the whole grid or, with delta frames, the modified cells
+						std::string gridjson = "{" + gg.getFrameRepresentation();
+						encoded = FramePacer::clock::now();
+						current_socket->emit("gamegrid:recv", gridjson);
+					}
+					if (stats != nullptr) {
+						stats->recordEncode(encoded - begin);
+						stats->recordEmit(FramePacer::clock::now() - encoded);
+					}
 				}
 
-				void sendSceneDataToServer(const Scene& s) {
+				/// @param stats where to record the encode and emit times, may be null
+				virtual void sendSceneDataToServer(const Scene& s, FrameStats* stats = nullptr) override {
 					if (debug && debugVerbose)
 						std::cerr << "Sending Scene\n";
-					std::string scenejson = "{" + s.getDataStructureRepresentation();
-
-					current_socket->emit("scene:recv", scenejson);
+					auto begin = FramePacer::clock::now();
+					decltype(begin) encoded;
+					if (binaryFrames) {
+						sio::message::ptr msg = getSceneMessage(s);
+						encoded = FramePacer::clock::now();
+						current_socket->emit("scene:recv:binary", msg);
+					}
+					else {
+						// the whole scene or, with delta frames, the modified meshes
+						std::string scenejson = "{" + s.getFrameRepresentation();
+						encoded = FramePacer::clock::now();
+						current_socket->emit("scene:recv", scenejson);
+					}
+					if (stats != nullptr) {
+						stats->recordEncode(encoded - begin);
+						stats->recordEmit(FramePacer::clock::now() - encoded);
+					}
 				}
 		};
 	}
@@ -2,7 +2,13 @@
 #define SORTINGBENCHMARK_H
 
 #include <LineChart.h>
+#include <SortingInputGenerator.h>
+#include <BenchmarkResults.h>
+#include <SweepScheduler.h>
+#include <RunWatchdog.h>
 #include <limits>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 #include <chrono>
 #include <stdlib.h>
@@ -28,9 +34,22 @@ namespace bridges {
 		 * sampling with linearRange() or a purely geometric one with
 		 * geometricRange().
 		 *
+		 * Alternatively, adaptiveRange() gives the benchmark a total time
+		 * budget: the sizes are then picked by a SweepScheduler from the
+		 * runtimes measured so far, so that a slow algorithm does not
+		 * start a run that can not complete in time while a fast one gets
+		 * a dense sweep up to the largest size. setWatchdog() makes the
+		 * benchmark abort a run that exceeds the time cap (or the
+		 * remaining budget) instead of waiting for it.
+		 *
 		 * The sorting algorithms must have for prototype:
 		 *  void (*sort)(int* array, int arraysize);
-		 * and can be passed to the run function for being benchmarked. A typical use would look something like
+		 * and can be passed to the run function for being benchmarked.
+		 * Other key types are supported by using them in place of int:
+		 * 64-bit integers, double, std::string or std::pair<key, value>
+		 * (sorted on key). The arrays are produced by a
+		 * SortingInputGenerator whose distribution is picked with
+		 * setGenerator(). A typical use would look something like
 		 *
 		 * \code{.cpp}
 		 * void mysort(int* array, int arraysize);
@@ -54,73 +73,92 @@ namespace bridges {
 				double geoBase;
 				double time_cap;
 				std::string generatorType;
-
-				void generateRandom(int* arr, int n) {
-					for (int i = 0; i < n; i++) {
-						arr[i] = ((double)rand()) / RAND_MAX * (2 * n);
-					}
+				uint64_t seed;
+				double zipfExponent;
+				long kSortedness;
+				int repetitions;
+				BenchmarkResults* results;
+				double time_budget;
+				bool watchdog;
+
+				struct Measurement {
+					double elapsed;
+					bool correct;
+				};
+
+				template <typename Key>
+				void setupGenerator(SortingInputGenerator<Key>& gen) const {
+					gen.setSeed(seed);
+					gen.setZipfExponent(zipfExponent);
+					gen.setKSortedness(kSortedness);
 				}
 
-				void generateInOrder(int* arr, int n) {
-					for (int i = 0; i < n; i++) {
-						arr[i] = i;
-					}
-				}
-				void generateReverseOrder(int* arr, int n) {
-					for (int i = 0; i < n; i++) {
-						arr[i] = n - i;
-					}
-				}
-				void generateFewValues(int* arr, int n) {
-					for (int i = 0; i < n; i++) {
-						arr[i] = ((double)rand()) / RAND_MAX * (4);
-					}
-				}
-				void generateAlmostSorted(int* arr, int n) {
-					if (n < 20) {
-						generateRandom(arr, n);
-					}
-					else {
-						int i;
-						for (i = 0; i < n - 20; i++) {
-							arr[i] = i;
-						}
-						for (; i < n; i++) {
-							arr[i] = ((double)rand()) / RAND_MAX * (2 * n);
+				template <typename Key>
+				bool check (const Key* arr, int n) {
+					bool ok = true;
+					for (int i = 1; i < n; ++i) {
+						if (!SortingInputGenerator<Key>::inOrder(arr[i - 1], arr[i])) {
+							ok = false;
 						}
 					}
+					return ok;
 				}
 
-				void generate(int* arr, int n) {
-					if (generatorType == "random") {
-						generateRandom(arr, n);
-					}
-					else if (generatorType == "inorder") {
-						generateInOrder(arr, n);
-					}
-					else if (generatorType == "reverseorder") {
-						generateReverseOrder(arr, n);
-					}
-					else if (generatorType == "fewdifferentvalues") {
-						generateFewValues(arr, n);
-					}
-					else if (generatorType == "almostsorted") {
-						generateAlmostSorted(arr, n);
-					}
-					else {
-						throw std::string("unknown generator");
-					}
-
+				///@return the size following n, or a size larger than maxSize at the end of the sweep
+				int nextSize(const SweepScheduler& sweep, int n) const {
+					if (time_budget <= 0.)
+						return std::max((int)(geoBase * n) + increment, n + 1);
+					double next = sweep.next();
+					if (next < 0.)
+						return std::numeric_limits<int>::max();
+					return std::max((int)next, n + 1);
 				}
 
-				bool check (int* arr, int n) {
-					bool ok = true;
-					for (int i = 1; i < n; ++i) {
-						if (arr[i] < arr[i - 1]) {
-							ok = false;
-						}
+				/**
+				 * @brief sorts arr once and times it
+				 *
+				 * With the watchdog on, the sort runs in a child process
+				 * that is killed after timeLimit seconds.
+				 *
+				 * @return false if the run was aborted
+				 **/
+				template <typename Key>
+				bool measure(const std::string& algoName, void (*runnable)(Key*, int),
+					Key* arr, int n, double timeLimit, double& elapsed) {
+					auto sortOnce = [&]() {
+						// in the child of the watchdog, the first write to each
+						// page of arr copies it; do it before the clock starts
+						volatile char* bytes = reinterpret_cast<volatile char*>(arr);
+						for (size_t off = 0; off < n * sizeof(Key); off += 4096)
+							bytes[off] = bytes[off];
+
+						std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+
+						runnable(arr, n);
+
+						std::chrono::time_point<std::chrono::steady_clock> end = std::chrono::steady_clock::now();
+
+						std::chrono::duration<double> elapsed_seconds = end - start;
+
+						Measurement m;
+						m.elapsed = elapsed_seconds.count();
+						m.correct = check(arr, n);
+						return m;
+					};
+
+					Measurement m;
+					if (watchdog && timeLimit < std::numeric_limits<double>::max()) {
+						if (!RunWatchdog::run(timeLimit, sortOnce, m))
+							return false;
 					}
-					return ok;
+					else
+						m = sortOnce();
+
+					if (!m.correct) {
+						std::cerr << "Sorting algorithm " << algoName << " is incorrect\n";
+					}
+					elapsed = m.elapsed;
+					return true;
 				}
 
 			public:
@@ -136,13 +174,30 @@ namespace bridges {
 					increment = 1;
 					geoBase = 1.;
 					time_cap = std::numeric_limits<double>::max();
+					seed = 42;
+					zipfExponent = 1.;
+					kSortedness = 0;
+					repetitions = 1;
+					results = nullptr;
+					time_budget = 0.;
+					watchdog = false;
 					setGenerator("random");
 				}
 
 				/**
+				 * @brief Sets the distribution of the arrays to sort.
 				 *
-				 *  @param generatorName possible values are "random", "inorder", "reverseorder", "fewdifferentvalues", "almostsorted"
-
+				 * "random" draws values uniformly in [0; 2n), "inorder" and
+				 * "reverseorder" are sorted sequences, "fewdifferentvalues"
+				 * uses only 4 values, "almostsorted" is sorted but for its
+				 * last 20 elements, "zipf" follows a Zipf law (see
+				 * setZipfExponent()), "organpipe" goes up then down,
+				 * "sawtooth" repeats increasing runs of about sqrt(n)
+				 * elements, "duplicates" uses about sqrt(n) distinct values,
+				 * and "ksorted" has no element further than k positions from
+				 * its sorted position (see setKSortedness()).
+				 *
+				 * @param generatorName possible values are "random", "inorder", "reverseorder", "fewdifferentvalues", "almostsorted", "zipf", "organpipe", "sawtooth", "duplicates", "ksorted"
 				 **/
 				void setGenerator(const std::string& generatorName) {
 					generatorType = generatorName;
@@ -151,6 +206,41 @@ namespace bridges {
 				std::string getGenerator() const {
 					return generatorType;
 				}
+
+				/**
+				 * @brief Sets the seed of the generated arrays.
+				 *
+				 * Two runs with the same seed and generator sort the same
+				 * arrays.
+				 *
+				 * @param s new seed
+				 **/
+				void setSeed(uint64_t s) {
+					seed = s;
+				}
+
+				/**
+				 * @brief Sets the exponent of the "zipf" generator
+				 *
+				 * @param e exponent of the Zipf law (default is 1.0)
+				 * @throw std::invalid_argument if e is not positive
+				 **/
+				void setZipfExponent(double e) {
+					if (!(e > 0.))
+						throw std::invalid_argument("zipf exponent should be positive");
+					zipfExponent = e;
+				}
+
+				/**
+				 * @brief Sets how far from its place an element can be in the
+				 * "ksorted" generator
+				 *
+				 * @param k maximum displacement (0, the default, means log2 of the array size)
+				 **/
+				void setKSortedness(long k) {
+					kSortedness = k;
+				}
+
 				/**
 				 * @brief Puts a cap on the largest array to be used
 				 *
@@ -241,42 +331,142 @@ namespace bridges {
 				}
 
 				/**
-				 * @brief benchmark one implementation
+				 * @brief The benchmark will pick the sizes in a range to fit
+				 * in a total time.
 				 *
-				 * @param algoName screen name of the algorithm to be used in the visualization
-				 * @param runnable pointer to the sorting function to benchmark
-				 **/
-				void run(std::string algoName, void (*runnable)(int*, int)) {
-					std::vector<double> time;
-					std::vector<double> xData;
-
-					//	System.out.println(geoBase);
-					//	System.out.println(increment);
-
-					for (int n = baseSize; n <= maxSize;
-						n = std::max((int)(geoBase * n) + increment, n + 1)) {
+				 * The first size is baseSize, the following ones are
+				 * chosen from a power law fitted on the runtimes measured so
+				 * far: as many sizes as the budget allows up to maxSize, or
+				 * the largest sizes predicted to fit when maxSize is out of
+				 * reach. The time cap still applies to each run.
+				 *
+				 * @param baseSize lower bound of the range sampled
+				 * @param maxSize upper bound of the range sampled
+				 * @param budget_in_s total time of the benchmark of one algorithm, in seconds
+				 */
+				void adaptiveRange(int baseSize, int maxSize, double budget_in_s) {
+					setBaseSize (baseSize);
+					setMaxSize (maxSize);
+					setTimeBudget (budget_in_s);
+				}
 
-						//System.out.println(n);
-						std::vector<int> arr(n);
+				/**
+				 * @brief sets a total time for the benchmark of one algorithm
+				 *
+				 * @param budget_in_s time budget in seconds (0, the default, means the sizes follow the linear or geometric progression)
+				 **/
+				void setTimeBudget(double budget_in_s) {
+					time_budget = budget_in_s;
+				}
 
-						generate(&arr[0], n);
+				/**
+				 * @brief Aborts the runs that take too long
+				 *
+				 * When on, a run that exceeds the time cap, or what is left
+				 * of the time budget, is killed: it is not plotted and the
+				 * benchmark ends. The runs happen in a child process, so the
+				 * sorting function can not have side effects visible from
+				 * the benchmark. Runs can not be aborted on Windows.
+				 *
+				 * @param w true to abort the runs that take too long
+				 **/
+				void setWatchdog(bool w) {
+					watchdog = w;
+				}
 
-						std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+				/**
+				 * @brief Sets how many times each size is run
+				 *
+				 * The plotted runtime is the median of the runs. Several runs
+				 * are needed for BenchmarkComparison to test the significance
+				 * of a difference.
+				 *
+				 * @param r number of runs per size (default is 1)
+				 **/
+				void setRepetitions(int r) {
+					if (r <= 0)
+						throw std::string("repetitions should be positive");
+					repetitions = r;
+				}
 
-						runnable(&arr[0], n);
+				/**
+				 * @brief Records all the measurements of the following runs
+				 *
+				 * @param r results to record to; it must outlive the
+				 * benchmark runs
+				 **/
+				void recordResults(BenchmarkResults& r) {
+					results = &r;
+					results->setMetadata("benchmark", "SortingBenchmark");
+				}
 
-						std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
+				/**
+				 * @brief benchmark one implementation that sorts ints
+				 *
+				 * Not a template, so that captureless lambdas and overloaded
+				 * function names convert to the function pointer.
+				 *
+				 * @param algoName screen name of the algorithm to be used in the visualization
+				 * @param runnable pointer to the sorting function to benchmark
+				 **/
+				void run(std::string algoName, void (*runnable)(int*, int)) {
+					run<int>(algoName, runnable);
+				}
 
-						std::chrono::duration<double> elapsed_seconds = end - start;
+				/**
+				 * @brief benchmark one implementation
+				 *
+				 * @param algoName screen name of the algorithm to be used in the visualization
+				 * @param runnable pointer to the sorting function to benchmark
+				 **/
+				template <typename Key>
+				void run(std::string algoName, void (*runnable)(Key*, int)) {
+					std::vector<double> time;
+					std::vector<double> xData;
 
-						if (! check(&arr[0], n)) {
-							std::cerr << "Sorting algorithm " << algoName << " is incorrect\n";
+					SortingInputGenerator<Key> gen;
+					setupGenerator(gen);
+					if (results)
+						results->setMetadata("generator", generatorType);
+
+					SweepScheduler sweep(baseSize, maxSize,
+						time_budget > 0. ? time_budget : std::numeric_limits<double>::max());
+					sweep.setMaxRunTime(time_cap);
+
+					for (int n = baseSize; n <= maxSize; n = nextSize(sweep, n)) {
+						//not a vector to avoid value-initializing the array
+						std::unique_ptr<Key[]> arr(new Key[n]);
+
+						BenchmarkPoint pt;
+						pt.x = n;
+						bool aborted = false;
+						for (int rep = 0; rep < repetitions && !aborted; ++rep) {
+							gen.generate(generatorType, &arr[0], n);
+
+							double timeLimit = time_cap;
+							if (time_budget > 0.)
+								timeLimit = std::min(timeLimit, std::max(0., sweep.remainingBudget()));
+
+							double elapsed;
+							if (measure(algoName, runnable, &arr[0], n, timeLimit, elapsed))
+								pt.samples.push_back(elapsed);
+							else
+								aborted = true;
 						}
+						if (aborted) {
+							std::cerr << algoName << " aborted on size " << n << "\n";
+							break;
+						}
+
+						if (results)
+							for (double t : pt.samples)
+								results->addSample(algoName, n, t);
 
-						time.push_back ((double)elapsed_seconds.count() );
+						sweep.record(n, pt.median());
+						time.push_back (pt.median());
 						xData.push_back ( (double)n );
 
-						if (elapsed_seconds.count() > time_cap) {
+						if (pt.median() > time_cap) {
 							break;
 						}
 					}
@@ -0,0 +1,403 @@
+#ifndef SORTING_INPUT_GENERATOR_H
+#define SORTING_INPUT_GENERATOR_H
+
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <type_traits>
+
+namespace bridges {
+	namespace benchmark {
+
+		/**
+		 * @brief Small and fast seeded pseudo random number generator.
+		 *
+		 * This is xoshiro256** (https://prng.di.unimi.it/) seeded through
+		 * splitmix64. It satisfies the UniformRandomBitGenerator
+		 * requirements so it can be used with the <random>
+		 * distributions. It is not meant for cryptography; it is meant
+		 * to fill large benchmark arrays quickly and reproducibly.
+		 *
+		 * This class is not meant to be used directly by students.
+		 **/
+		class Xoshiro256 {
+			private:
+				uint64_t s[4];
+
+				static uint64_t rotl(uint64_t x, int k) {
+					return (x << k) | (x >> (64 - k));
+				}
+
+			public:
+				typedef uint64_t result_type;
+
+				///@brief splitmix64 step, also used to derive independent seeds
+				static uint64_t splitmix64(uint64_t& x) {
+					uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+					z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+					z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+					return z ^ (z >> 31);
+				}
+
+				explicit Xoshiro256(uint64_t seed = 0) {
+					this->seed(seed);
+				}
+
+				void seed(uint64_t seed) {
+					for (int i = 0; i < 4; ++i)
+						s[i] = splitmix64(seed);
+				}
+
+				static constexpr result_type min() {
+					return 0;
+				}
+
+				static constexpr result_type max() {
+					return ~(result_type)0;
+				}
+
+				result_type operator()() {
+					const uint64_t result = rotl(s[1] * 5, 7) * 9;
+					const uint64_t t = s[1] << 17;
+
+					s[2] ^= s[0];
+					s[3] ^= s[1];
+					s[1] ^= s[2];
+					s[0] ^= s[3];
+					s[2] ^= t;
+					s[3] = rotl(s[3], 45);
+
+					return result;
+				}
+
+				///@return a double uniformly drawn in [0; 1)
+				double nextDouble() {
+					return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+				}
+
+				///@return an integer uniformly drawn in [0; range)
+				uint64_t nextBounded(uint64_t range) {
+					if (range <= 0xffffffffULL) //multiply-shift, no division
+						return (((*this)() >> 32) * range) >> 32;
+					return (uint64_t) (nextDouble() * range);
+				}
+		};
+
+		/**
+		 * @brief Turns the integer produced by a distribution into a key
+		 * of the benchmarked type.
+		 *
+		 * The mapping is order preserving, so a distribution that
+		 * produces sorted integers produces sorted keys. Supported key
+		 * types are the integral types, the floating point types,
+		 * std::string and std::pair<Key, Value> (whose key part is
+		 * generated and whose value part records the position of the
+		 * element in the original array).
+		 *
+		 * @param v value produced by the distribution, in [0; bound)
+		 * @param index position of the element in the array
+		 * @param bound exclusive upper bound of the values
+		 **/
+		template <typename Key, typename Enable = void>
+		struct SortingKey;
+
+		template <typename Key>
+		struct SortingKey<Key, typename std::enable_if<std::is_arithmetic<Key>::value>::type> {
+			static Key make(uint64_t v, uint64_t, uint64_t) {
+				return (Key) v;
+			}
+			static bool less(const Key& a, const Key& b) {
+				return a < b;
+			}
+		};
+
+		template <>
+		struct SortingKey<std::string> {
+			static std::string make(uint64_t v, uint64_t, uint64_t bound) {
+				//zero padded to a fixed width so that lexicographic order is
+				//numerical order
+				char buf[24];
+				int width = 1;
+				for (uint64_t b = bound; b >= 10; b /= 10)
+					++width;
+				buf[width] = '\0';
+				for (int i = width - 1; i >= 0; --i) {
+					buf[i] = '0' + (char) (v % 10);
+					v /= 10;
+				}
+				return std::string(buf, width);
+			}
+			static bool less(const std::string& a, const std::string& b) {
+				return a < b;
+			}
+		};
+
+		template <typename K, typename V>
+		struct SortingKey<std::pair<K, V>> {
+			static std::pair<K, V> make(uint64_t v, uint64_t index, uint64_t bound) {
+				return std::pair<K, V>(SortingKey<K>::make(v, index, bound),
+						SortingKey<V>::make(index, index, bound));
+			}
+			///only the key part matters for ordering
+			static bool less(const std::pair<K, V>& a, const std::pair<K, V>& b) {
+				return SortingKey<K>::less(a.first, b.first);
+			}
+		};
+
+		/**
+		 * @brief Generates the input arrays of SortingBenchmark.
+		 *
+		 * Supported distributions are "random", "inorder",
+		 * "reverseorder", "fewdifferentvalues", "almostsorted", "zipf",
+		 * "organpipe", "sawtooth", "duplicates" and "ksorted".
+		 *
+		 * Arrays are filled by chunks of fixed size, each chunk drawing
+		 * from its own generator derived from the seed. Large arrays are
+		 * filled by several threads, and the content of the array only
+		 * depends on the seed, never on the number of threads.
+		 *
+		 * This class is not meant to be used directly by students.
+		 **/
+		template <typename Key>
+		class SortingInputGenerator {
+			private:
+				uint64_t seed;
+				int nbThreads;
+				double zipfExponent;
+				long kSortedness;
+
+				static const long chunkSize = 1 << 16;
+				static const long parallelThreshold = 1 << 20;
+
+				static uint64_t isqrt(uint64_t n) {
+					return std::max<uint64_t>(1, (uint64_t) std::sqrt((double) n));
+				}
+
+				/// calls f(begin, end, rng) on chunks of [0; n). Chunks are
+				/// multiple of grain elements.
+				template <typename Func>
+				void forChunks(long n, long grain, Func f) const {
+					long chunk = std::max(grain, chunkSize - chunkSize % grain);
+					long nbChunks = (n + chunk - 1) / chunk;
+
+					auto doChunk = [&](long c) {
+						uint64_t sd = seed ^ (0x632be59bd9b4e019ULL * (uint64_t) (c + 1));
+						Xoshiro256 rng(Xoshiro256::splitmix64(sd));
+						long begin = c * chunk;
+						f(begin, std::min(n, begin + chunk), rng);
+					};
+
+					int threads = nbThreads;
+					if (threads <= 0)
+						threads = std::max(1u, std::thread::hardware_concurrency());
+					if (n < parallelThreshold || threads == 1 || nbChunks == 1) {
+						for (long c = 0; c < nbChunks; ++c)
+							doChunk(c);
+						return;
+					}
+
+					threads = (int) std::min<long>(threads, nbChunks);
+					std::vector<std::thread> workers;
+					for (int t = 0; t < threads; ++t) {
+						workers.emplace_back([&, t]() {
+							for (long c = t; c < nbChunks; c += threads)
+								doChunk(c);
+						});
+					}
+					for (auto& w : workers)
+						w.join();
+				}
+
+				template <typename ValueFunc>
+				void fill(Key* arr, long n, uint64_t bound, ValueFunc value) const {
+					forChunks(n, 1, [&](long begin, long end, Xoshiro256 & rng) {
+						for (long i = begin; i < end; ++i)
+							arr[i] = SortingKey<Key>::make(value(i, rng), i, bound);
+					});
+				}
+
+				/**
+				 * Zipf sampler over [1; n] using rejection-inversion
+				 * (Hormann and Derflinger, 1996). Constant expected time
+				 * per sample, no table.
+				 **/
+				class ZipfSampler {
+						double n;
+						double s;
+						double hIntegralX1;
+						double hIntegralN;
+						double sVal;
+
+						static double helper1(double x) {
+							return std::abs(x) > 1e-8 ? std::log1p(x) / x
+								: 1. - x * (0.5 - x * (1. / 3. - 0.25 * x));
+						}
+						static double helper2(double x) {
+							return std::abs(x) > 1e-8 ? std::expm1(x) / x
+								: 1. + x * 0.5 * (1. + x * 1. / 3. * (1. + 0.25 * x));
+						}
+						double h(double x) const {
+							return std::exp(-s * std::log(x));
+						}
+						double hIntegral(double x) const {
+							double logX = std::log(x);
+							return helper2((1. - s) * logX) * logX;
+						}
+						double hIntegralInverse(double x) const {
+							double t = std::max(-1., x * (1. - s));
+							return std::exp(helper1(t) * x);
+						}
+
+					public:
+						ZipfSampler(uint64_t n, double exponent)
+							: n((double)n), s(exponent) {
+							hIntegralX1 = hIntegral(1.5) - 1.;
+							hIntegralN = hIntegral(this->n + 0.5);
+							sVal = 2. - hIntegralInverse(hIntegral(2.5) - h(2.));
+						}
+
+						uint64_t operator() (Xoshiro256& rng) const {
+							while (true) {
+								double u = hIntegralN + rng.nextDouble() * (hIntegralX1 - hIntegralN);
+								double x = hIntegralInverse(u);
+								double k = std::floor(x + 0.5);
+								k = std::min(std::max(k, 1.), n);
+								if (k - x <= sVal || u >= hIntegral(k + 0.5) - h(k))
+									return (uint64_t) k;
+							}
+						}
+				};
+
+			public:
+				SortingInputGenerator()
+					: seed(42), nbThreads(0), zipfExponent(1.), kSortedness(0) {
+				}
+
+				///@brief seed of the generated arrays
+				void setSeed(uint64_t s) {
+					seed = s;
+				}
+
+				uint64_t getSeed() const {
+					return seed;
+				}
+
+				///@brief number of threads used to fill large arrays (0 means all cores)
+				void setThreads(int t) {
+					nbThreads = t;
+				}
+
+				/**
+				 * @brief exponent of the "zipf" distribution (default 1.0)
+				 *
+				 * @throw std::invalid_argument if e is not positive
+				 **/
+				void setZipfExponent(double e) {
+					if (!(e > 0.)) // also rejects NaN
+						throw std::invalid_argument("zipf exponent should be positive");
+					zipfExponent = e;
+				}
+
+				/**
+				 * @brief maximum displacement of the elements in the "ksorted"
+				 * distribution.
+				 *
+				 * @param k displacement; 0 (default) uses log2(n)
+				 **/
+				void setKSortedness(long k) {
+					kSortedness = k;
+				}
+
+				///@return whether the key order test accepts a <= b
+				static bool inOrder(const Key& a, const Key& b) {
+					return !SortingKey<Key>::less(b, a);
+				}
+
+				/**
+				 * @brief fills arr with n elements of the given distribution
+				 *
+				 * @param generatorType name of the distribution
+				 * @param arr array to fill
+				 * @param n number of elements
+				 **/
+				void generate(const std::string& generatorType, Key* arr, long n) const {
+					uint64_t un = (uint64_t) std::max(n, 1l);
+
+					if (generatorType == "random") {
+						fill(arr, n, 2 * un, [&](long, Xoshiro256 & rng) {
+							return rng.nextBounded(2 * un);
+						});
+					}
+					else if (generatorType == "inorder") {
+						fill(arr, n, un, [](long i, Xoshiro256&) {
+							return (uint64_t) i;
+						});
+					}
+					else if (generatorType == "reverseorder") {
+						fill(arr, n, un + 1, [&](long i, Xoshiro256&) {
+							return un - i;
+						});
+					}
+					else if (generatorType == "fewdifferentvalues") {
+						fill(arr, n, 4, [](long, Xoshiro256 & rng) {
+							return rng.nextBounded(4);
+						});
+					}
+					else if (generatorType == "almostsorted") {
+						fill(arr, n, 2 * un, [&](long i, Xoshiro256 & rng) {
+							return (n < 20 || i >= n - 20) ? rng.nextBounded(2 * un) : (uint64_t) i;
+						});
+					}
+					else if (generatorType == "zipf") {
+						ZipfSampler zipf(un, zipfExponent);
+						fill(arr, n, un + 1, [&](long, Xoshiro256 & rng) {
+							return zipf(rng);
+						});
+					}
+					else if (generatorType == "organpipe") {
+						fill(arr, n, un, [&](long i, Xoshiro256&) {
+							return (uint64_t) (i < n / 2 ? i : n - 1 - i);
+						});
+					}
+					else if (generatorType == "sawtooth") {
+						uint64_t period = isqrt(un);
+						fill(arr, n, period, [&](long i, Xoshiro256&) {
+							return (uint64_t) i % period;
+						});
+					}
+					else if (generatorType == "duplicates") {
+						uint64_t distinct = isqrt(un);
+						fill(arr, n, distinct, [&](long, Xoshiro256 & rng) {
+							return rng.nextBounded(distinct);
+						});
+					}
+					else if (generatorType == "ksorted") {
+						//sorted, then shuffled within blocks of k elements: no
+						//element is more than k-1 positions away from its place.
+						long k = kSortedness;
+						if (k <= 0)
+							k = std::max(1l, (long) std::log2((double) un));
+						forChunks(n, k, [&](long begin, long end, Xoshiro256 & rng) {
+							for (long i = begin; i < end; ++i)
+								arr[i] = SortingKey<Key>::make(i, i, un);
+							for (long b = begin; b < end; b += k) {
+								long e = std::min(end, b + k);
+								for (long i = e - 1; i > b; --i)
+									std::swap(arr[i], arr[b + (long) rng.nextBounded(i - b + 1)]);
+							}
+						});
+					}
+					else {
+						throw std::string("unknown generator");
+					}
+				}
+		};
+	}
+}
+
+#endif
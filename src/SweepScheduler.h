@@ -0,0 +1,219 @@
+#ifndef SWEEP_SCHEDULER_H
+#define SWEEP_SCHEDULER_H
+
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+namespace bridges {
+	namespace benchmark {
+
+		/**
+		 * @brief Picks the sizes of a benchmark sweep to fit a total time
+		 * budget.
+		 *
+		 * The runtime is modeled as a power law t = c * n^b fitted (least
+		 * squares in log-log space) on the last few measured points. The
+		 * exponent is kept within [1; 4]; with a single point the
+		 * runtime is assumed linear.
+		 *
+		 * At each step the scheduler spreads as many points as the
+		 * predicted cost allows (up to the maximum number of points)
+		 * geometrically between the last size and the maximum size. When
+		 * even reaching the maximum size is not affordable, it picks the
+		 * largest size whose predicted runtime fits in half of the
+		 * remaining budget (growing by at most a factor of 4 per point)
+		 * and stops when no larger size fits. So slow algorithms
+		 * never start an oversized run, and fast ones get dense sweeps.
+		 *
+		 * The budget counts wall clock time since the scheduler was
+		 * created, so input generation or graph loading count too.
+		 *
+		 * This class is not meant to be used directly by students.
+		 **/
+		class SweepScheduler {
+			private:
+				typedef std::chrono::steady_clock clock;
+
+				double minSize;
+				double maxSize;
+				double budget;
+				double maxRunTime;
+				int maxPoints;
+				double minGrowth;
+				double maxGrowth;
+				double safety;
+
+				clock::time_point startTime;
+				std::vector<double> sizes;
+				std::vector<double> times;
+
+				// log(c) and b of t = c * n^b
+				double logc;
+				double exponent;
+
+				void fit() {
+					const size_t fitWindow = 4;
+					// runtimes below this are timer noise for fitting purposes
+					const double minTime = 1e-7;
+
+					size_t first = sizes.size() > fitWindow ? sizes.size() - fitWindow : 0;
+					size_t k = sizes.size() - first;
+					if (k == 0)
+						return;
+					if (k == 1) {
+						exponent = 1.;
+					}
+					else {
+						double sx = 0., sy = 0., sxx = 0., sxy = 0.;
+						for (size_t i = first; i < sizes.size(); ++i) {
+							double x = std::log(sizes[i]);
+							double y = std::log(std::max(times[i], minTime));
+							sx += x;
+							sy += y;
+							sxx += x * x;
+							sxy += x * y;
+						}
+						double den = k * sxx - sx * sx;
+						exponent = (den > 0.) ? (k * sxy - sx * sy) / den : 1.;
+					}
+					exponent = std::min(4., std::max(1., exponent));
+					// anchor the curve on the last point, it is the most relevant
+					logc = std::log(std::max(times.back(), minTime)) - exponent * std::log(sizes.back());
+				}
+
+				/// predicted cost of k points geometrically spaced after last, up to maxSize
+				double scheduleCost(double last, int k) const {
+					double g = std::pow(maxSize / last, 1. / k);
+					double cost = 0.;
+					double n = last;
+					for (int i = 0; i < k; ++i) {
+						n *= g;
+						cost += predict(n);
+					}
+					return cost;
+				}
+
+			public:
+				/**
+				 * @param minSize first size of the sweep
+				 * @param maxSize largest size of the sweep
+				 * @param budget total time of the sweep in seconds
+				 * @param maxPoints largest number of points of the sweep
+				 **/
+				SweepScheduler(double minSize, double maxSize, double budget, int maxPoints = 30)
+					: minSize(std::max(1., minSize)), maxSize(std::max(minSize, maxSize)),
+					  budget(budget), maxRunTime(std::numeric_limits<double>::max()),
+					  maxPoints(std::max(2, maxPoints)), minGrowth(1.05), maxGrowth(4.),
+						  safety(1.5),
+					  startTime(clock::now()), logc(0.), exponent(1.) {
+				}
+
+				///@brief no single run can be predicted longer than this (in seconds)
+				void setMaxRunTime(double t) {
+					maxRunTime = t;
+				}
+
+				///@brief sizes grow at least by this factor between two points
+				void setMinGrowth(double g) {
+					minGrowth = std::max(1., g);
+				}
+
+				/**
+				 * @brief sizes grow at most by this factor between two points
+				 * when the maximum size is out of reach
+				 *
+				 * The fit on small sizes tends to underestimate the exponent,
+				 * so the sweep approaches the limit in several steps.
+				 **/
+				void setMaxGrowth(double g) {
+					maxGrowth = std::max(minGrowth, g);
+				}
+
+				///@brief predictions are multiplied by this factor before being compared to the budget
+				void setSafetyFactor(double s) {
+					safety = s;
+				}
+
+				///@return seconds left in the budget
+				double remainingBudget() const {
+					std::chrono::duration<double> spent = clock::now() - startTime;
+					return budget - spent.count();
+				}
+
+				///@return predicted runtime (in seconds) of a run of the given size
+				double predict(double size) const {
+					if (sizes.empty())
+						return 0.;
+					return std::exp(logc + exponent * std::log(size));
+				}
+
+				///@return the exponent b of the fitted t = c * n^b
+				double getExponent() const {
+					return exponent;
+				}
+
+				///@return whether a run of that size is predicted to fit in the remaining budget and the run time limit
+				bool affordable(double size) const {
+					double p = safety * predict(size);
+					return p <= remainingBudget() && p <= maxRunTime;
+				}
+
+				/**
+				 * @brief records a measurement
+				 *
+				 * @param size size of the run
+				 * @param seconds runtime of the run
+				 **/
+				void record(double size, double seconds) {
+					sizes.push_back(size);
+					times.push_back(seconds);
+					fit();
+				}
+
+				/**
+				 * @brief size of the next point
+				 *
+				 * @return the next size to run, or a negative value when the
+				 * sweep is over
+				 **/
+				double next() const {
+					if (remainingBudget() <= 0.)
+						return -1.;
+					if (sizes.empty())
+						return minSize;
+
+					double last = sizes.back();
+					int left = maxPoints - (int) sizes.size();
+					if (last >= maxSize || left <= 0)
+						return -1.;
+
+					double remaining = remainingBudget();
+					//the densest geometric schedule to maxSize that fits
+					for (int k = left; k >= 1; --k) {
+						double g = std::pow(maxSize / last, 1. / k);
+						if (g < minGrowth && k > 1)
+							continue;
+						if (safety * scheduleCost(last, k) <= remaining) {
+							double n = std::min(maxSize, last * std::max(g, minGrowth));
+							if (affordable(n))
+								return n;
+						}
+					}
+
+					//maxSize is out of reach: largest size using at most half
+					//of what is left, so that a few more points can follow
+					double limit = std::min(remaining / 2., maxRunTime) / safety;
+					double n = std::exp((std::log(limit) - logc) / exponent);
+					n = std::min(std::min(n, last * maxGrowth), maxSize);
+					if (n < last * minGrowth)
+						return -1.;
+					return n;
+				}
+		};
+	}
+}
+
+#endif
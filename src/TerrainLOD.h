@@ -0,0 +1,419 @@
+#ifndef TERRAIN_LOD_H
+#define TERRAIN_LOD_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <stdexcept>
+
+#include "TerrainMesh.h"
+#include "Scene.h"
+#include "data_src/ElevationData.h"
+
+namespace bridges {
+
+	/**
+	 * @brief Shows a large elevation map in a Scene, with less detail
+	 * far from the camera.
+	 *
+	 * The map is cut into a quadtree of square chunks. Each chunk is a
+	 * TerrainMesh of at most (chunkSize + 1) x (chunkSize + 1) vertices.
+	 * The leaves use every elevation value. Each level up uses every
+	 * other value of the level below, so a chunk costs the same to send
+	 * at any level.
+	 *
+	 * update() chooses the chunks of the scene, starting from the root.
+	 * A chunk is replaced by its four children when the camera is closer
+	 * than detail times its width. Chunks farther than the view distance
+	 * are not shown. The chosen chunks are added to the scene and the
+	 * others are removed. Chunks that stay are left untouched, so with
+	 * Scene::setDeltaFrames() a frame only sends the chunks that appeared.
+	 *
+	 * At most maxBuilds chunks are built per update. A chunk is only
+	 * replaced by its children once they can all be built, so the scene
+	 * shows coarser chunks for a few frames instead of stalling the game
+	 * when the camera moves fast.
+	 *
+	 * The terrain lies in the x-z plane: column c of the map is at
+	 * x = c * spacing, row r at z = r * spacing, and the height of a
+	 * vertex is its elevation times heightScale. The camera has no
+	 * direction, so all the chunks within the view distance are visible.
+	 * Neighboring chunks of different levels may show small cracks along
+	 * their common edge.
+	 *
+	 * \code{.cpp}
+	 * // in initialize() of a NonBlockingGame3D
+	 * auto lod = std::make_shared<TerrainLOD>(ds.getElevationData(bbox, res));
+	 * setTerrainLOD(lod);
+	 * setDeltaFrames(true);
+	 * \endcode
+	 *
+	 * @sa TerrainMesh::setPlacement()
+	 **/
+	class TerrainLOD {
+		public:
+			/// @brief a chunk of the quadtree; the root is at level 0
+			struct Chunk {
+				int level;
+				int row;
+				int col;
+			};
+
+		private:
+			std::shared_ptr<const dataset::ElevationData> data;
+			int chunkSize;
+			// level of the leaves
+			int depth = 0;
+			float spacing;
+			float heightScale;
+
+			float detail = 2.;
+			float viewDistance = std::numeric_limits<float>::infinity();
+			int maxBuilds = 16;
+			std::string prefix = "terrain";
+
+			// lowest and highest elevation of each chunk, by level, with
+			// (1 << level) chunks per side, row-major; chunks outside of
+			// the map have min > max
+			std::vector<std::vector<int>> minElevation, maxElevation;
+
+			// names of the chunks this object put in the scene
+			std::unordered_set<std::string> shown;
+			// builds left in the current update
+			int budget = 0;
+			int lastBuilds = 0;
+
+			int stride(int level) const {
+				return 1 << (depth - level);
+			}
+
+			// number of vertices along a side of the map, from cell first
+			int vertexCount(int first, int mapSize, int level) const {
+				int s = stride(level);
+				int cells = std::min(chunkSize, (mapSize - 1 - first + s - 1) / s);
+				return cells + 1;
+			}
+
+			bool inMap(const Chunk& c) const {
+				return minElevation[c.level][(c.row << c.level) + c.col]
+					<= maxElevation[c.level][(c.row << c.level) + c.col];
+			}
+
+			void computeBounds() {
+				const int rows = data->getRows(), cols = data->getCols();
+				minElevation.resize(depth + 1);
+				maxElevation.resize(depth + 1);
+				for (int level = 0; level <= depth; ++level) {
+					size_t n = (size_t) 1 << level;
+					minElevation[level].assign(n * n, std::numeric_limits<int>::max());
+					maxElevation[level].assign(n * n, std::numeric_limits<int>::min());
+				}
+
+				// leaves, from the map
+				const std::vector<int>& values = data->getData();
+				const int n = 1 << depth;
+				for (int r = 0; r < n && r * chunkSize < rows - 1; ++r) {
+					int r1 = std::min(rows - 1, (r + 1) * chunkSize);
+					for (int c = 0; c < n && c * chunkSize < cols - 1; ++c) {
+						int c0 = c * chunkSize, c1 = std::min(cols - 1, c0 + chunkSize);
+						int lo = std::numeric_limits<int>::max();
+						int hi = std::numeric_limits<int>::min();
+						for (int i = r * chunkSize; i <= r1; ++i) {
+							auto row = values.begin() + (size_t) i * cols;
+							auto mm = std::minmax_element(row + c0, row + c1 + 1);
+							lo = std::min(lo, *mm.first);
+							hi = std::max(hi, *mm.second);
+						}
+						minElevation[depth][(size_t) r * n + c] = lo;
+						maxElevation[depth][(size_t) r * n + c] = hi;
+					}
+				}
+
+				// each chunk covers its children
+				for (int level = depth - 1; level >= 0; --level) {
+					const size_t n = (size_t) 1 << level;
+					for (size_t r = 0; r < n; ++r)
+						for (size_t c = 0; c < n; ++c) {
+							int& lo = minElevation[level][r * n + c];
+							int& hi = maxElevation[level][r * n + c];
+							for (size_t k = 0; k < 4; ++k) {
+								size_t child = (2 * r + k / 2) * 2 * n + 2 * c + k % 2;
+								lo = std::min(lo, minElevation[level + 1][child]);
+								hi = std::max(hi, maxElevation[level + 1][child]);
+							}
+						}
+				}
+			}
+
+			// distance from the camera to the box around the chunk
+			float distance(const Chunk& c, const float pos[3]) const {
+				int s = stride(c.level);
+				int r0 = c.row * chunkSize * s, c0 = c.col * chunkSize * s;
+				float x0 = c0 * spacing;
+				float x1 = (c0 + (vertexCount(c0, data->getCols(), c.level) - 1) * s) * spacing;
+				float z0 = r0 * spacing;
+				float z1 = (r0 + (vertexCount(r0, data->getRows(), c.level) - 1) * s) * spacing;
+				size_t idx = ((size_t) c.row << c.level) + c.col;
+				float y0 = minElevation[c.level][idx] * heightScale;
+				float y1 = maxElevation[c.level][idx] * heightScale;
+				if (y0 > y1)
+					std::swap(y0, y1);
+				float dx = std::max({x0 - pos[0], 0.f, pos[0] - x1});
+				float dy = std::max({y0 - pos[1], 0.f, pos[1] - y1});
+				float dz = std::max({z0 - pos[2], 0.f, pos[2] - z1});
+				return std::sqrt(dx * dx + dy * dy + dz * dz);
+			}
+
+			bool visible(const Chunk& c, const float pos[3]) const {
+				return inMap(c) && distance(c, pos) <= viewDistance;
+			}
+
+			bool shouldRefine(const Chunk& c, const float pos[3]) const {
+				float width = (float) chunkSize * stride(c.level) * spacing;
+				return c.level < depth && distance(c, pos) < detail * width;
+			}
+
+			// chooses the chunks covering c; a build was reserved for c
+			// if it is not in the scene yet
+			void select(const Chunk& c, const float pos[3], const Scene& scene,
+				std::vector<Chunk>& out) {
+				if (!shouldRefine(c, pos)) {
+					out.push_back(c);
+					return;
+				}
+				bool reserved = !isBuilt(scene, c);
+				if (reserved)
+					++budget;
+
+				Chunk children[4];
+				int count = 0, missing = 0;
+				for (int k = 0; k < 4; ++k) {
+					Chunk child{c.level + 1, 2 * c.row + k / 2, 2 * c.col + k % 2};
+					if (!visible(child, pos))
+						continue;
+					children[count++] = child;
+					if (!isBuilt(scene, child))
+						++missing;
+				}
+				if (missing > budget) {
+					// not enough builds left: the children wait for a
+					// later update
+					if (reserved)
+						--budget;
+					out.push_back(c);
+					return;
+				}
+				budget -= missing;
+				for (int k = 0; k < count; ++k)
+					select(children[k], pos, scene, out);
+			}
+
+			bool isBuilt(const Scene& scene, const Chunk& c) const {
+				return scene.getTerrains().count(chunkName(c)) > 0;
+			}
+
+		public:
+			/**
+			 * @brief Prepares the chunks of an elevation map
+			 *
+			 * @param data the elevation map, of at least 2 rows and 2
+			 * columns; pass it with std::move to avoid a copy
+			 * @param chunkSize number of cells along a side of a chunk
+			 * @param heightScale factor from elevation to height
+			 * @param spacing distance between two neighboring values of
+			 * the map; 0 uses the cell size of the map, or 1 if it has none
+			 * @throw std::invalid_argument if the map is too small or the
+			 * chunk size is not positive
+			 */
+			TerrainLOD(dataset::ElevationData data, int chunkSize = 64,
+				float heightScale = 1., float spacing = 0.)
+				: data(std::make_shared<const dataset::ElevationData>(std::move(data))),
+				  chunkSize(chunkSize), heightScale(heightScale) {
+				const dataset::ElevationData& map = *this->data;
+				if (map.getRows() < 2 || map.getCols() < 2
+					|| map.getData().size() < (size_t) map.getRows() * map.getCols())
+					throw std::invalid_argument("TerrainLOD: the elevation map needs at least 2 x 2 values");
+				if (chunkSize <= 0)
+					throw std::invalid_argument("TerrainLOD: the chunk size must be positive");
+
+				if (spacing > 0)
+					this->spacing = spacing;
+				else
+					this->spacing = map.getCellSize() > 0 ? map.getCellSize() : 1.f;
+
+				int cells = std::max(map.getRows(), map.getCols()) - 1;
+				while ((long) chunkSize << depth < cells)
+					++depth;
+				computeBounds();
+			}
+
+			/**
+			 * @brief How soon chunks are refined
+			 *
+			 * A chunk is replaced by its children when the camera is closer
+			 * than detail times its width: higher values show more detail
+			 * and more chunks.
+			 *
+			 * @param detail a positive factor (default is 2)
+			 * @throw std::invalid_argument if detail is not positive
+			 */
+			void setDetail(float detail) {
+				if (!(detail > 0))
+					throw std::invalid_argument("TerrainLOD: the detail must be positive");
+				this->detail = detail;
+			}
+
+			/**
+			 * @param distance chunks farther from the camera are not shown
+			 * (default is no limit)
+			 * @throw std::invalid_argument if distance is not positive
+			 */
+			void setViewDistance(float distance) {
+				if (!(distance > 0))
+					throw std::invalid_argument("TerrainLOD: the view distance must be positive");
+				viewDistance = distance;
+			}
+
+			/**
+			 * @param builds number of chunks built per update, at least 1
+			 * (default is 16)
+			 */
+			void setMaxBuilds(int builds) {
+				maxBuilds = std::max(1, builds);
+			}
+
+			/**
+			 * @param prefix start of the names of the chunks in the scene,
+			 * so that several terrains can share a scene (default is
+			 * "terrain")
+			 */
+			void setName(const std::string& prefix) {
+				this->prefix = prefix;
+			}
+
+			///@return level of the most detailed chunks; the root is level 0
+			int getDepth() const {
+				return depth;
+			}
+
+			///@return name of chunk c in the scene
+			std::string chunkName(const Chunk& c) const {
+				return prefix + "/" + std::to_string(c.level) + "/"
+					+ std::to_string(c.row) + "/" + std::to_string(c.col);
+			}
+
+			/**
+			 * @brief builds the mesh of a chunk
+			 *
+			 * @param c the chunk
+			 * @return a mesh named chunkName(c), placed in the scene
+			 */
+			TerrainMesh buildChunk(const Chunk& c) const {
+				const int rows = data->getRows(), cols = data->getCols();
+				const int s = stride(c.level);
+				const int r0 = c.row * chunkSize * s, c0 = c.col * chunkSize * s;
+				const int nr = vertexCount(r0, rows, c.level);
+				const int nc = vertexCount(c0, cols, c.level);
+
+				// the last vertices may fall past the edge of the map, by
+				// less than a stride; they take the value at the edge
+				std::vector<float> vertices((size_t) nr * nc);
+				for (int i = 0; i < nr; ++i) {
+					int r = std::min(rows - 1, r0 + i * s);
+					for (int j = 0; j < nc; ++j)
+						vertices[(size_t) i * nc + j] =
+							data->getVal(r, std::min(cols - 1, c0 + j * s)) * heightScale;
+				}
+
+				TerrainMesh mesh;
+				mesh.setName(chunkName(c));
+				mesh.setType("terrain");
+				mesh.setRows(nr);
+				mesh.setCols(nc);
+				mesh.getVertices().swap(vertices);
+				mesh.getColors().assign((size_t) 4 * nr * nc, 1.f);
+				mesh.setPlacement(c0 * spacing, r0 * spacing, s * spacing);
+				return mesh;
+			}
+
+			/**
+			 * @brief chooses the chunks to show from a camera position
+			 *
+			 * Does not modify the scene, except for the builds it counts:
+			 * chunks that are not in the scene take one of the maxBuilds
+			 * builds.
+			 *
+			 * @param scene the scene the chunks are in
+			 * @param position position of the camera
+			 * @param out receives the chunks, which do not overlap
+			 */
+			void selectChunks(const Scene& scene, const float position[3],
+				std::vector<Chunk>& out) {
+				out.clear();
+				Chunk root{0, 0, 0};
+				if (!visible(root, position))
+					return;
+				budget = maxBuilds;
+				// the root is shown whatever the budget
+				if (!isBuilt(scene, root))
+					--budget;
+				select(root, position, scene, out);
+			}
+
+			/**
+			 * @brief Shows the chunks needed from the camera of the scene
+			 *
+			 * Adds the chunks that are needed and not in the scene yet,
+			 * and removes the chunks of this terrain that are no longer
+			 * needed.
+			 *
+			 * @param scene the scene to update
+			 */
+			void update(Scene& scene) {
+				float position[3];
+				scene.getCamera().getPosition(position);
+
+				std::vector<Chunk> chunks;
+				selectChunks(scene, position, chunks);
+
+				std::unordered_set<std::string> needed;
+				needed.reserve(2 * chunks.size());
+				lastBuilds = 0;
+				for (const Chunk& c : chunks) {
+					std::string name = chunkName(c);
+					if (scene.getTerrains().count(name) == 0) {
+						scene.add(buildChunk(c));
+						++lastBuilds;
+					}
+					needed.insert(std::move(name));
+				}
+				for (const std::string& name : shown)
+					if (needed.count(name) == 0)
+						scene.remove(name);
+				shown.swap(needed);
+			}
+
+			/// @brief removes the chunks of this terrain from the scene
+			void clear(Scene& scene) {
+				for (const std::string& name : shown)
+					scene.remove(name);
+				shown.clear();
+			}
+
+			///@return number of chunks shown after the last update
+			size_t getChunkCount() const {
+				return shown.size();
+			}
+
+			///@return number of chunks built by the last update
+			int getLastBuildCount() const {
+				return lastBuilds;
+			}
+	};
+} // namespace bridges
+
+#endif
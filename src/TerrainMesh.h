@@ -4,6 +4,7 @@
 
 #include <string>
 #include <vector>
+#include <atomic>
 using namespace std;
 
 namespace bridges {
@@ -16,6 +17,19 @@ namespace bridges {
 			vector<float> colors;
 			int rows;
 			int cols;
+			// where the mesh is in the scene; meshes that are not placed
+			// are positioned by the viewer
+			bool placed = false;
+			float originX = 0., originZ = 0., spacing = 1.;
+			// changes whenever the content may have changed; drawn from a
+			// counter shared by all meshes, so two meshes only have the
+			// same version if one is a copy of the other
+			unsigned long version = nextVersion();
+
+			static unsigned long nextVersion() {
+				static std::atomic<unsigned long> counter{0};
+				return ++counter;
+			}
 
 		public:
 			TerrainMesh() {}
@@ -34,50 +48,127 @@ namespace bridges {
 
 			void setName (string n) {
 				name = n;
+				markChanged();
 			}
 
-			string getName () {
+			string getName () const {
 				return name;
 			}
 
 			void setType (string t) {
 				type = t;
+				markChanged();
 			}
 
-			string getType () {
+			string getType () const {
 				return type;
 			}
 
-			int getRows() {
+			int getRows() const {
 				return rows;
 			}
 
 			void setRows(int r) {
 				rows = r;
+				markChanged();
 			}
 
-			int getCols() {
+			int getCols() const {
 				return cols;
 			}
 
 			void setCols(int c) {
 				cols = c;
+				markChanged();
 			}
 
+			/// the colors can be modified through the reference, so the
+			/// mesh counts as changed
 			vector<float>&  getColors() {
+				markChanged();
+				return colors;
+			}
+
+			const vector<float>& getColors() const {
 				return colors;
 			}
 
 			void setColors(vector<float>& cols) {
 				colors = cols;
+				markChanged();
 			}
 
+			/// the vertices can be modified through the reference, so the
+			/// mesh counts as changed
 			vector<float>& getVertices() {
+				markChanged();
+				return vertices;
+			}
+
+			const vector<float>& getVertices() const {
 				return vertices;
 			}
 
 			void setVertices(vector<float>& v) {
 				vertices = v;
+				markChanged();
+			}
+
+			/**
+			 * @brief Places the mesh in the scene
+			 *
+			 * Vertex (i, j) of the mesh is at x = x + j * spacing and
+			 * z = z + i * spacing, and its value is its height (y). Tiles
+			 * of a larger terrain, such as the chunks of TerrainLOD, are
+			 * placed this way.
+			 *
+			 * @param x x coordinate of the first vertex
+			 * @param z z coordinate of the first vertex
+			 * @param spacing distance between two neighboring vertices
+			 */
+			void setPlacement(float x, float z, float spacing) {
+				placed = true;
+				originX = x;
+				originZ = z;
+				this->spacing = spacing;
+				markChanged();
+			}
+
+			///@return whether setPlacement() was called
+			bool hasPlacement() const {
+				return placed;
+			}
+
+			///@return x coordinate of the first vertex
+			float getOriginX() const {
+				return originX;
+			}
+
+			///@return z coordinate of the first vertex
+			float getOriginZ() const {
+				return originZ;
+			}
+
+			///@return distance between two neighboring vertices
+			float getSpacing() const {
+				return spacing;
+			}
+
+			/**
+			 * @brief Records that the mesh changed
+			 *
+			 * Scenes with delta frames only send the meshes that changed.
+			 * Setters and the non-const getters call this function; call it
+			 * after modifying the vertices or colors through a reference
+			 * obtained in an earlier frame.
+			 */
+			void markChanged() {
+				version = nextVersion();
+			}
+
+			///@return a number that changes whenever the mesh changes
+			unsigned long getVersion() const {
+				return version;
 			}
 	};
 } //namespace bridges
@@ -0,0 +1,183 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <exception>
+#include <algorithm>
+
+namespace bridges {
+
+	/**
+	 * @brief A fixed set of worker threads running parallel loops.
+	 *
+	 * parallelFor() splits a range of indices in chunks that the
+	 * calling thread and the workers take in turn. The calling thread
+	 * always takes part, so a parallel loop nested in another one (or
+	 * a pool without workers) still completes, only with less
+	 * parallelism.
+	 *
+	 * Starting threads costs tens of microseconds, so the library
+	 * shares one pool, global(), sized after the number of cores.
+	 *
+	 * This class is not meant to be used directly by students.
+	 **/
+	class ThreadPool {
+		private:
+			std::vector<std::thread> workers;
+			std::deque<std::function<void()>> tasks;
+			std::mutex m;
+			std::condition_variable cv;
+			bool stopping;
+
+			/// chunks of a parallelFor, shared by the threads working on it
+			struct Job {
+				std::mutex m;
+				std::condition_variable done;
+				long nextChunk = 0;
+				long nbChunks = 0;
+				int active = 0;
+				std::exception_ptr error;
+			};
+
+			void workerLoop() {
+				for (;;) {
+					std::function<void()> task;
+					{
+						std::unique_lock<std::mutex> lk(m);
+						cv.wait(lk, [this]() {
+							return stopping || !tasks.empty();
+						});
+						if (tasks.empty())
+							return;
+						task = std::move(tasks.front());
+						tasks.pop_front();
+					}
+					task();
+				}
+			}
+
+			/// takes chunks of the job until none is left
+			template <typename Func>
+			static void work(Job& job, long begin, long end, long grain, Func& f) {
+				for (;;) {
+					long c;
+					{
+						std::lock_guard<std::mutex> lk(job.m);
+						if (job.nextChunk >= job.nbChunks)
+							return;
+						c = job.nextChunk++;
+						++job.active;
+					}
+					try {
+						long b = begin + c * grain;
+						f(b, std::min(end, b + grain));
+					}
+					catch (...) {
+						std::lock_guard<std::mutex> lk(job.m);
+						if (!job.error)
+							job.error = std::current_exception();
+						job.nextChunk = job.nbChunks;
+					}
+					{
+						std::lock_guard<std::mutex> lk(job.m);
+						--job.active;
+					}
+					job.done.notify_all();
+				}
+			}
+
+		public:
+			/**
+			 * @param threads number of worker threads, in addition to the
+			 * thread calling parallelFor(); negative for one per core
+			 **/
+			explicit ThreadPool(int threads = -1) : stopping(false) {
+				if (threads < 0)
+					threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+				for (int t = 0; t < threads; ++t)
+					workers.emplace_back([this]() {
+					workerLoop();
+				});
+			}
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator= (const ThreadPool&) = delete;
+
+			~ThreadPool() {
+				{
+					std::lock_guard<std::mutex> lk(m);
+					stopping = true;
+				}
+				cv.notify_all();
+				for (auto& w : workers)
+					w.join();
+			}
+
+			///@return the number of threads running a parallel loop (workers and caller)
+			int size() const {
+				return (int) workers.size() + 1;
+			}
+
+			/**
+			 * @brief runs f(b, e) on consecutive chunks [b, e) of [begin, end)
+			 *
+			 * Chunks hold grain indices (the last one may hold fewer) and
+			 * may run concurrently, in any order. The call returns when
+			 * all of them are done. If f throws, the remaining chunks are
+			 * skipped and the first exception is rethrown.
+			 *
+			 * @param begin first index
+			 * @param end one past the last index
+			 * @param grain number of indices per chunk
+			 * @param f function of the chunk bounds
+			 **/
+			template <typename Func>
+			void parallelFor(long begin, long end, long grain, Func f) {
+				if (end <= begin)
+					return;
+				grain = std::max(1L, grain);
+				long nbChunks = (end - begin + grain - 1) / grain;
+				if (nbChunks == 1 || workers.empty()) {
+					f(begin, end);
+					return;
+				}
+
+				auto job = std::make_shared<Job>();
+				job->nbChunks = nbChunks;
+				long helpers = std::min<long>((long) workers.size(), nbChunks - 1);
+				{
+					std::lock_guard<std::mutex> lk(m);
+					// the job outlives the call for helpers that start late;
+					// they find no chunk left and do not touch f
+					for (long h = 0; h < helpers; ++h)
+						tasks.emplace_back([job, begin, end, grain, &f]() {
+						work(*job, begin, end, grain, f);
+					});
+				}
+				cv.notify_all();
+
+				work(*job, begin, end, grain, f);
+
+				std::unique_lock<std::mutex> lk(job->m);
+				job->done.wait(lk, [&]() {
+					return job->active == 0;
+				});
+				if (job->error)
+					std::rethrow_exception(job->error);
+			}
+
+			///@return the pool shared by the library, with one thread per core
+			static ThreadPool& global() {
+				static ThreadPool pool;
+				return pool;
+			}
+	};
+}
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef TILED_COLOR_GRID_H
+#define TILED_COLOR_GRID_H
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Bridges.h"
+#include "ColorGrid.h"
+
+namespace bridges {
+	namespace datastructure {
+		/**
+		 * @brief An image too large for a single ColorGrid, stored as tiles.
+		 *
+		 * The server displays ColorGrids of at most 1080 x 1920 pixels.
+		 * A TiledColorGrid stores a larger image (a satellite tile, an
+		 * 8k x 8k simulation field, ...) as a grid of ColorGrid tiles of
+		 * fixed size (the tiles of the last row and column may be
+		 * smaller), so each tile can be encoded and uploaded on its own.
+		 *
+		 * getOverview() provides a level of detail pyramid: each level
+		 * halves the resolution of the previous one (averaging 2 x 2
+		 * pixels), and the overview is the first level that fits in a
+		 * single ColorGrid. visualize() uploads the overview followed by
+		 * each tile, as successive visualizations of the assignment. An
+		 * assignment holds at most 99 visualizations, so large images
+		 * need large tiles: 8192 x 8192 pixels fit in 8 x 8 tiles of
+		 * 1024 x 1024 pixels.
+		 *
+		 * \code{.cpp}
+		 * TiledColorGrid img (8192, 8192, 1024, 1024);
+		 * for (int i = 0; i < img.getHeight(); ++i)
+		 *   for (int j = 0; j < img.getWidth(); ++j)
+		 *     img.set(i, j, Color(i % 256, j % 256, 0));
+		 * img.visualize(bridges);
+		 * \endcode
+		 *
+		 * There is a tutorial about ColorGrid :
+		 * https://bridgesuncc.github.io/tutorials/Grid.html
+		 **/
+		class TiledColorGrid {
+			private:
+				int rows;
+				int cols;
+				int tileRows;
+				int tileCols;
+				int tilesDown;
+				int tilesAcross;
+				std::vector<ColorGrid> tiles;
+
+				void checkRowCol(int row, int col) const {
+					if (row < 0 || col < 0 || row >= rows || col >= cols)
+						throw std::out_of_range("invalid location in TiledColorGrid");
+				}
+
+				static Color average(const Color& a, const Color& b, const Color& c, const Color& d) {
+					return Color(
+							(a.getRed() + b.getRed() + c.getRed() + d.getRed() + 2) / 4,
+							(a.getGreen() + b.getGreen() + c.getGreen() + d.getGreen() + 2) / 4,
+							(a.getBlue() + b.getBlue() + c.getBlue() + d.getBlue() + 2) / 4,
+							(a.getAlpha() + b.getAlpha() + c.getAlpha() + d.getAlpha() + 2) / 4);
+				}
+
+				/// copies row r of the image, across the tiles, into out
+				void readRow(int r, Color* out) const {
+					const ColorGrid* tile = &tiles[(size_t) (r / tileRows) * tilesAcross];
+					const size_t offset = (size_t) (r % tileRows);
+					for (int tc = 0; tc < tilesAcross; ++tc, ++tile) {
+						int width = std::min(tileCols, cols - tc * tileCols);
+						const Color* row = tile->data() + offset * width;
+						std::copy(row, row + width, out + (size_t) tc * tileCols);
+					}
+				}
+
+				/// copies in into row r of the image, across the tiles
+				void writeRow(int r, const Color* in) {
+					ColorGrid* tile = &tiles[(size_t) (r / tileRows) * tilesAcross];
+					const size_t offset = (size_t) (r % tileRows);
+					for (int tc = 0; tc < tilesAcross; ++tc, ++tile) {
+						int width = std::min(tileCols, cols - tc * tileCols);
+						const Color* from = in + (size_t) tc * tileCols;
+						std::copy(from, from + width, tile->data() + offset * width);
+					}
+				}
+
+				/// averages two consecutive rows of cols pixels, 2 x 2 pixels
+				/// at a time, into a row half as wide
+				static void halveRow(const Color* a, const Color* b, int cols, Color* out) {
+					for (int j = 0; 2 * j < cols; ++j) {
+						int j0 = 2 * j, j1 = std::min(2 * j + 1, cols - 1);
+						out[j] = average(a[j0], a[j1], b[j0], b[j1]);
+					}
+				}
+
+				// a level of the pyramid, produced one row at a time
+				struct Level {
+					int rows;
+					int cols;
+					int next;
+					// the two rows of the level below that make the next row
+					std::vector<Color> first, second;
+				};
+
+				/// produces the next row of level l into out; the rows of the
+				/// levels in between are produced on the way, and never stored
+				/// as a whole
+				void nextRow(std::vector<Level>& levels, size_t l, Color* out) const {
+					Level& level = levels[l];
+					int i = level.next++;
+					if (l == 0) {
+						readRow(i, out);
+						return;
+					}
+					const Level& source = levels[l - 1];
+					nextRow(levels, l - 1, level.first.data());
+					// the last row of an odd level is averaged with itself
+					const Color* second = level.first.data();
+					if (2 * i + 1 < source.rows) {
+						nextRow(levels, l - 1, level.second.data());
+						second = level.second.data();
+					}
+					halveRow(level.first.data(), second, source.cols, out);
+				}
+
+				/// the levels from this image to `halvings` halvings of it
+				std::vector<Level> pyramid(int halvings) const {
+					std::vector<Level> levels;
+					levels.push_back(Level{rows, cols, 0, {}, {}});
+					for (int l = 1; l <= halvings; ++l) {
+						const Level& source = levels.back();
+						Level level{(source.rows + 1) / 2, (source.cols + 1) / 2, 0,
+							std::vector<Color>(source.cols), std::vector<Color>(source.cols)};
+						levels.push_back(std::move(level));
+					}
+					return levels;
+				}
+
+			public:
+				/**
+				 * @param rows height of the image
+				 * @param cols width of the image
+				 * @param tileRows height of the tiles (at most 1080)
+				 * @param tileCols width of the tiles (at most 1920)
+				 * @param color initial color of the pixels
+				 * @throw std::invalid_argument if a dimension is not positive
+				 * or the tiles are larger than a ColorGrid
+				 **/
+				TiledColorGrid(int rows, int cols, int tileRows = 512, int tileCols = 512,
+					const Color& color = colors::black)
+					: rows(rows), cols(cols), tileRows(tileRows), tileCols(tileCols) {
+					if (rows <= 0 || cols <= 0 || tileRows <= 0 || tileCols <= 0)
+						throw std::invalid_argument("TiledColorGrid dimensions must be positive");
+					tilesDown = (rows + tileRows - 1) / tileRows;
+					tilesAcross = (cols + tileCols - 1) / tileCols;
+					tiles.reserve((size_t) tilesDown * tilesAcross);
+					for (int tr = 0; tr < tilesDown; ++tr)
+						for (int tc = 0; tc < tilesAcross; ++tc)
+							tiles.emplace_back(std::min(tileRows, rows - tr * tileRows),
+								std::min(tileCols, cols - tc * tileCols), color);
+				}
+
+				///@return the height (number of rows) of the image
+				int getHeight() const {
+					return rows;
+				}
+
+				///@return the width (number of columns) of the image
+				int getWidth() const {
+					return cols;
+				}
+
+				///@return the number of rows of tiles
+				int getTilesDown() const {
+					return tilesDown;
+				}
+
+				///@return the number of columns of tiles
+				int getTilesAcross() const {
+					return tilesAcross;
+				}
+
+				/**
+				 * @brief Get the (row, col) pixel of the image
+				 * @return the color at row, col
+				 */
+				Color const& get(int row, int col) const {
+					checkRowCol(row, col);
+					return getTile(row / tileRows, col / tileCols)
+						.getUnchecked(row % tileRows, col % tileCols);
+				}
+
+				/**
+				 * @brief Set the (row, col) pixel of the image
+				 * @param row row of the pixel
+				 * @param col column of the pixel
+				 * @param color color to be set
+				 */
+				void set(int row, int col, const Color& color) {
+					checkRowCol(row, col);
+					getTile(row / tileRows, col / tileCols)
+					.setUnchecked(row % tileRows, col % tileCols, color);
+				}
+
+				/**
+				 * @brief Get a tile of the image
+				 *
+				 * Tile (tr, tc) holds the pixels from row tr * tileRows and
+				 * column tc * tileCols.
+				 *
+				 * @param tr row of the tile
+				 * @param tc column of the tile
+				 * @return the tile
+				 */
+				ColorGrid& getTile(int tr, int tc) {
+					if (tr < 0 || tc < 0 || tr >= tilesDown || tc >= tilesAcross)
+						throw std::out_of_range("invalid tile in TiledColorGrid");
+					return tiles[(size_t) tr * tilesAcross + tc];
+				}
+
+				/// @brief const version of getTile()
+				const ColorGrid& getTile(int tr, int tc) const {
+					return const_cast<TiledColorGrid*>(this)->getTile(tr, tc);
+				}
+
+				/**
+				 * @brief the image at half the resolution
+				 *
+				 * Each pixel averages 2 x 2 pixels of this image (fewer on
+				 * the last row or column when a dimension is odd). The tiles
+				 * keep the same size.
+				 *
+				 * @return the next level of the pyramid
+				 */
+				TiledColorGrid downsample() const {
+					TiledColorGrid half((rows + 1) / 2, (cols + 1) / 2, tileRows, tileCols);
+					std::vector<Level> levels = pyramid(1);
+					std::vector<Color> row(half.cols);
+					for (int i = 0; i < half.rows; ++i) {
+						nextRow(levels, 1, row.data());
+						half.writeRow(i, row.data());
+					}
+					return half;
+				}
+
+				/**
+				 * @brief the coarsest useful level of the pyramid as a single
+				 * ColorGrid
+				 *
+				 * The image is halved until it fits in maxRows x maxCols, as
+				 * by calling downsample() repeatedly, but the levels in
+				 * between are not built: only two rows of each are kept.
+				 *
+				 * @param maxRows largest height of the overview
+				 * @param maxCols largest width of the overview
+				 * @return the overview
+				 * @throw std::invalid_argument if maxRows or maxCols is not
+				 * positive
+				 */
+				ColorGrid getOverview(int maxRows = 1080, int maxCols = 1920) const {
+					if (maxRows <= 0 || maxCols <= 0)
+						throw std::invalid_argument("TiledColorGrid: the overview must have a positive size");
+					int halvings = 0;
+					int r = rows, c = cols;
+					while (r > maxRows || c > maxCols) {
+						r = (r + 1) / 2;
+						c = (c + 1) / 2;
+						++halvings;
+					}
+					std::vector<Level> levels = pyramid(halvings);
+					ColorGrid cg(r, c);
+					for (int i = 0; i < r; ++i)
+						nextRow(levels, halvings, cg.data() + (size_t) i * c);
+					return cg;
+				}
+
+				/**
+				 * @brief Uploads the image to the server
+				 *
+				 * The overview is sent first, then each tile in row-major
+				 * order, each as a visualization of the assignment titled
+				 * after the title set in bridges and the tile position.
+				 * The title and the data structure of bridges are restored
+				 * afterwards, also when a post fails.
+				 *
+				 * @param bridges connection to the server
+				 * @param overview whether to send the overview
+				 * @param sendTiles whether to send the full resolution tiles
+				 * @throw std::invalid_argument before posting anything, if
+				 * the assignment does not have enough sub-assignments left
+				 * for the overview and the tiles (use larger tiles)
+				 */
+				void visualize(Bridges& bridges, bool overview = true, bool sendTiles = true) const {
+					unsigned long posts = (overview ? 1UL : 0UL)
+						+ (sendTiles ? (unsigned long) tilesDown * tilesAcross : 0UL);
+					if (posts > bridges.getSubAssignmentsLeft())
+						throw std::invalid_argument("TiledColorGrid::visualize: " + std::to_string(posts)
+							+ " visualizations needed, but the assignment has "
+							+ std::to_string(bridges.getSubAssignmentsLeft()) + " left; use larger tiles");
+
+					// puts back the title and the data structure of bridges
+					struct Restore {
+						Bridges& bridges;
+						std::string title;
+						DataStructure* previous;
+						~Restore() {
+							bridges.setTitle(title);
+							bridges.setDataStructure(previous);
+						}
+					} restore {bridges, bridges.getTitle(), bridges.getDataStructure()};
+					const std::string& title = restore.title;
+
+					if (overview) {
+						ColorGrid ov = getOverview();
+						bridges.setTitle(title + " (overview)");
+						bridges.setDataStructure(ov);
+						bridges.visualize();
+					}
+					if (sendTiles) {
+						for (int tr = 0; tr < tilesDown; ++tr) {
+							for (int tc = 0; tc < tilesAcross; ++tc) {
+								bridges.setTitle(title + " (tile " + std::to_string(tr)
+									+ ", " + std::to_string(tc) + ")");
+								bridges.setDataStructure(const_cast<ColorGrid&>(getTile(tr, tc)));
+								bridges.visualize();
+							}
+						}
+					}
+				}
+		};
+	}
+}
+
+#endif
@@ -4,6 +4,13 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
 using namespace std;
 
 /**
@@ -37,6 +44,11 @@ using namespace std;
  *   Modified Implementation [from LihO, Dec. 18, 12]
  *	https://stackoverflow.com/questions/180947/base64-decode-snippet-in-c
 
+ *	The scalar code is now table driven, writes into a preallocated
+ *	buffer, and 12 (SSSE3) or 24 (AVX2) bytes are converted at a time
+ *	when the compiler targets these instruction sets, following the
+ *	method of Wojciech Muła and Daniel Lemire, "Faster Base64 Encoding
+ *	and Decoding Using AVX2 Instructions" (ACM TOW, 2018).
  */
 
 namespace bridges {
@@ -53,90 +65,224 @@ namespace bridges {
 			return (isalnum(c) || (c == '+') || (c == '/'));
 		}
 
-		string inline encode(BYTE const* buf, unsigned int bufLen) {
-			string ret;
-			int i = 0;
-			int j = 0;
-			BYTE char_array_3[3];
-			BYTE char_array_4[4];
-
-			while (bufLen--) {
-				// 3 chars become 4 chars in base 64 representation
-				// hence the char arrays of 3 and 4
-				char_array_3[i++] = *(buf++);
-				if (i == 3) {
-					char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-					char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-					char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-					char_array_4[3] = char_array_3[2] & 0x3f;
-
-					for (i = 0; (i < 4) ; i++)
-						ret += base64_chars[char_array_4[i]];
-					i = 0;
-				}
+		namespace detail {
+			static const char encodeTable[65] =
+				"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+				"abcdefghijklmnopqrstuvwxyz"
+				"0123456789+/";
+
+			/// value of each base64 character, 0xFF for the other characters
+			inline const BYTE* decodeTable() {
+				static const struct Table {
+					BYTE v[256];
+					Table() {
+						memset(v, 0xFF, sizeof(v));
+						for (int i = 0; i < 64; ++i)
+							v[(BYTE) encodeTable[i]] = (BYTE) i;
+					}
+				} table;
+				return table.v;
 			}
 
-			// handle any left over bytes, by padding with end of string chars
-			if (i) {
-				for (j = i; j < 3; j++)
-					char_array_3[j] = '\0';
+#if defined(__SSSE3__) || defined(__AVX2__)
+			/// 16 6-bit values to their base64 characters
+			inline __m128i encodeLookup(__m128i idx) {
+				// 0..51 -> 0 (13 for 0..25), 52..61 -> 1..10, 62 -> 11, 63 -> 12
+				__m128i r = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+				__m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+				r = _mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+				const __m128i shift = _mm_setr_epi8(
+						'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+						'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+						'/' - 63, 'A', 0, 0);
+				return _mm_add_epi8(_mm_shuffle_epi8(shift, r), idx);
+			}
 
-				char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-				char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-				char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-				char_array_4[3] = char_array_3[2] & 0x3f;
+			/// 12 bytes (in the first 12 of the 16 loaded) to 16 characters
+			inline __m128i encodeBlock(__m128i in) {
+				in = _mm_shuffle_epi8(in, _mm_set_epi8(
+							10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+				__m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+				__m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+				__m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+				__m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+				return encodeLookup(_mm_or_si128(t1, t3));
+			}
 
-				for (j = 0; (j < i + 1); j++)
-					ret += base64_chars[char_array_4[j]];
+			/**
+			 * 16 characters to their 6-bit values
+			 *
+			 * @return false if one of them is not a base64 character
+			 */
+			inline bool decodeLookup(__m128i c, __m128i& values) {
+				__m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+						_mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), c));
+				__m128i lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+						_mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), c));
+				__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+						_mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+				__m128i plus = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+				__m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+				__m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+						_mm_or_si128(digit, _mm_or_si128(plus, slash)));
+				if (_mm_movemask_epi8(valid) != 0xFFFF)
+					return false;
+				__m128i shift = _mm_or_si128(
+						_mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+							_mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+						_mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+							_mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')),
+								_mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+				values = _mm_add_epi8(c, shift);
+				return true;
+			}
 
-				// not sure what this does!
-				while ((i++ < 3))
-					ret += '=';
+			/// 16 6-bit values to 12 bytes (in the first 12 of the result)
+			inline __m128i decodePack(__m128i values) {
+				__m128i ab_bc = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+				__m128i abc = _mm_madd_epi16(ab_bc, _mm_set1_epi32(0x00011000));
+				return _mm_shuffle_epi8(abc, _mm_setr_epi8(
+							2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
 			}
+#endif
+		}
 
-			return ret;
+		/// @return the number of characters encoding len bytes
+		inline size_t encodedLength(size_t len) {
+			return 4 * ((len + 2) / 3);
 		}
 
-		vector<BYTE> inline decode(string const& encoded_string) {
-			size_t in_len = encoded_string.size();
-			int i = 0;
-			//  int j = 0;
-			int in_ = 0;
-			BYTE char_array_4[4], char_array_3[3];
-			vector<BYTE> ret;
-
-			while (in_len-- && ( encoded_string[in_] != '=') && is_base64(encoded_string[in_])) {
-				char_array_4[i++] = encoded_string[in_];
-				in_++;
-				if (i == 4) {
-					for (i = 0; i < 4; i++)
-						char_array_4[i] = (BYTE) base64_chars.find(char_array_4[i]);
-
-					char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-					char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-					char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
-
-					for (i = 0; (i < 3); i++)
-						ret.push_back(char_array_3[i]);
-					i = 0;
-				}
+		/// @return an upper bound on the number of bytes decoded from len characters
+		inline size_t decodedLength(size_t len) {
+			return 3 * (len / 4) + 3;
+		}
+
+		/**
+		 * @brief encodes bufLen bytes into a caller buffer
+		 *
+		 * @param buf bytes to encode
+		 * @param bufLen number of bytes
+		 * @param out buffer of at least encodedLength(bufLen) characters,
+		 * not null terminated
+		 * @return the number of characters written
+		 */
+		inline size_t encode(BYTE const* buf, size_t bufLen, char* out) {
+			const char* table = detail::encodeTable;
+			size_t i = 0;
+			char* o = out;
+
+#if defined(__AVX2__)
+			for (; i + 28 <= bufLen; i += 24, o += 32) {
+				__m128i lo = detail::encodeBlock(_mm_loadu_si128((const __m128i*) (buf + i)));
+				__m128i hi = detail::encodeBlock(_mm_loadu_si128((const __m128i*) (buf + i + 12)));
+				_mm256_storeu_si256((__m256i*) o,
+					_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1));
+			}
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+			for (; i + 16 <= bufLen; i += 12, o += 16)
+				_mm_storeu_si128((__m128i*) o,
+					detail::encodeBlock(_mm_loadu_si128((const __m128i*) (buf + i))));
+#endif
+
+			for (; i + 3 <= bufLen; i += 3, o += 4) {
+				uint32_t v = ((uint32_t) buf[i] << 16) | ((uint32_t) buf[i + 1] << 8) | buf[i + 2];
+				o[0] = table[v >> 18];
+				o[1] = table[(v >> 12) & 0x3F];
+				o[2] = table[(v >> 6) & 0x3F];
+				o[3] = table[v & 0x3F];
+			}
+
+			// handle any left over bytes, by padding with end of string chars
+			if (i < bufLen) {
+				uint32_t v = (uint32_t) buf[i] << 16;
+				if (i + 1 < bufLen)
+					v |= (uint32_t) buf[i + 1] << 8;
+				o[0] = table[v >> 18];
+				o[1] = table[(v >> 12) & 0x3F];
+				o[2] = (i + 1 < bufLen) ? table[(v >> 6) & 0x3F] : '=';
+				o[3] = '=';
+				o += 4;
 			}
+			return o - out;
+		}
+
+		string inline encode(BYTE const* buf, unsigned int bufLen) {
+			string ret(encodedLength(bufLen), '\0');
+			if (bufLen > 0)
+				encode(buf, bufLen, &ret[0]);
+			return ret;
+		}
 
-			if (i) {
-				for (int j = i; j < 4; j++)
-					char_array_4[j] = 0;
+		/**
+		 * @brief decodes base64 characters into a caller buffer
+		 *
+		 * Decoding stops at the first padding or non base64 character.
+		 *
+		 * @param in characters to decode
+		 * @param len number of characters
+		 * @param out buffer of at least decodedLength(len) bytes
+		 * @return the number of bytes written
+		 */
+		inline size_t decode(const char* in, size_t len, BYTE* out) {
+			const BYTE* table = detail::decodeTable();
+			size_t i = 0;
+			BYTE* o = out;
 
-				for (int j = 0; j < 4; j++)
-					char_array_4[j] = (BYTE) base64_chars.find(char_array_4[j]);
+#if defined(__AVX2__)
+			// the stores write 32 bytes for 24 decoded ones, the margin
+			// on the input keeps them in the buffer
+			for (; i + 48 <= len; i += 32, o += 24) {
+				__m128i v0, v1;
+				if (!detail::decodeLookup(_mm_loadu_si128((const __m128i*) (in + i)), v0)
+					|| !detail::decodeLookup(_mm_loadu_si128((const __m128i*) (in + i + 16)), v1))
+					break;
+				__m256i packed = _mm256_inserti128_si256(_mm256_castsi128_si256(
+							detail::decodePack(v0)), detail::decodePack(v1), 1);
+				_mm256_storeu_si256((__m256i*) o, _mm256_permutevar8x32_epi32(packed,
+						_mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7)));
+			}
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+			for (; i + 24 <= len; i += 16, o += 12) {
+				__m128i v;
+				if (!detail::decodeLookup(_mm_loadu_si128((const __m128i*) (in + i)), v))
+					break;
+				_mm_storeu_si128((__m128i*) o, detail::decodePack(v));
+			}
+#endif
 
-				char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-				char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-				char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
+			int k = 0;
+			uint32_t v = 0;
+			for (; i < len; ++i) {
+				BYTE d = table[(BYTE) in[i]];
+				if (d == 0xFF)
+					break;
+				v = (v << 6) | d;
+				if (++k == 4) {
+					o[0] = (BYTE) (v >> 16);
+					o[1] = (BYTE) (v >> 8);
+					o[2] = (BYTE) v;
+					o += 3;
+					k = 0;
+					v = 0;
+				}
+			}
 
-				for (int j = 0; (j < i - 1); j++)
-					ret.push_back(char_array_3[j]);
+			// k characters left make k-1 bytes
+			if (k > 1) {
+				v <<= 6 * (4 - k);
+				o[0] = (BYTE) (v >> 16);
+				if (k > 2)
+					o[1] = (BYTE) (v >> 8);
+				o += k - 1;
 			}
+			return o - out;
+		}
 
+		vector<BYTE> inline decode(string const& encoded_string) {
+			vector<BYTE> ret(decodedLength(encoded_string.size()));
+			ret.resize(decode(encoded_string.data(), encoded_string.size(), ret.data()));
 			return ret;
 		}
 
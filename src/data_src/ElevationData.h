@@ -100,13 +100,6 @@ namespace bridges {
 					setMinVal(minVal);
 				}
 
-				/**
-				 * destructor
-				 */
-				~ElevationData() {
-					//delete [] data;
-				}
-
 				/**
 				 * get width of elevation map
 				 * @return width of map
@@ -125,9 +118,9 @@ namespace bridges {
 				}
 
 				/**
-				 *  get the elevation data
+				 *  get the elevation data, row by row
 				 */
-				vector<int> getData() {
+				const vector<int>& getData() const {
 					return data;
 				}
 
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "base64.h"
+
+// The SIMD paths of base64 are compiled in with -mssse3 or -mavx2;
+// the unit_tests_ssse3 and unit_tests_avx2 targets build these tests
+// that way, so each path is compared with the plain encoder below.
+namespace Test_Base64 {
+	using namespace bridges;
+
+	/// one 3-byte group at a time, as the scalar tail of base64::encode
+	inline std::string referenceEncode(const std::vector<BYTE>& in) {
+		static const char* table =
+			"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		std::string out;
+		size_t i = 0;
+		for (; i + 3 <= in.size(); i += 3) {
+			uint32_t v = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+			out += table[v >> 18];
+			out += table[(v >> 12) & 63];
+			out += table[(v >> 6) & 63];
+			out += table[v & 63];
+		}
+		if (i < in.size()) {
+			uint32_t v = in[i] << 16;
+			if (i + 1 < in.size())
+				v |= in[i + 1] << 8;
+			out += table[v >> 18];
+			out += table[(v >> 12) & 63];
+			out += (i + 1 < in.size()) ? table[(v >> 6) & 63] : '=';
+			out += '=';
+		}
+		return out;
+	}
+
+	/// bytes covering all the values, in an order that is not periodic
+	inline std::vector<BYTE> testBytes(size_t len) {
+		std::vector<BYTE> bytes(len);
+		uint32_t x = 12345;
+		for (size_t i = 0; i < len; ++i) {
+			x = x * 1103515245 + 12345;
+			bytes[i] = (BYTE) (x >> 16);
+		}
+		return bytes;
+	}
+}
+
+TEST(Base64, EncodedLength) {
+	using bridges::base64::encodedLength;
+	EXPECT_EQ(encodedLength(0), 0u);
+	EXPECT_EQ(encodedLength(1), 4u);
+	EXPECT_EQ(encodedLength(2), 4u);
+	EXPECT_EQ(encodedLength(3), 4u);
+	EXPECT_EQ(encodedLength(4), 8u);
+	for (size_t len = 0; len <= 100; ++len)
+		EXPECT_EQ(encodedLength(len), Test_Base64::referenceEncode(Test_Base64::testBytes(len)).size());
+}
+
+TEST(Base64, EncodeMatchesScalarForEveryTail) {
+	const char canary = '#';
+	for (size_t len = 0; len <= 100; ++len) {
+		std::vector<bridges::BYTE> bytes = Test_Base64::testBytes(len);
+		std::string expected = Test_Base64::referenceEncode(bytes);
+
+		// caller buffer of exactly encodedLength() characters
+		std::string buf(bridges::base64::encodedLength(len) + 16, canary);
+		size_t written = bridges::base64::encode(bytes.data(), len, &buf[0]);
+		ASSERT_EQ(written, expected.size()) << "length " << len;
+		EXPECT_EQ(buf.substr(0, written), expected) << "length " << len;
+		EXPECT_EQ(buf.substr(written), std::string(16, canary)) << "length " << len;
+
+		EXPECT_EQ(bridges::base64::encode(bytes.data(), (unsigned int) len), expected)
+				<< "length " << len;
+	}
+}
+
+TEST(Base64, DecodeRoundTripsEveryTail) {
+	const bridges::BYTE canary = 0xA5;
+	for (size_t len = 0; len <= 100; ++len) {
+		std::vector<bridges::BYTE> bytes = Test_Base64::testBytes(len);
+		std::string encoded = Test_Base64::referenceEncode(bytes);
+
+		std::vector<bridges::BYTE> buf(bridges::base64::decodedLength(encoded.size()) + 16, canary);
+		size_t written = bridges::base64::decode(encoded.data(), encoded.size(), buf.data());
+		ASSERT_EQ(written, len) << "length " << len;
+		EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), buf.begin())) << "length " << len;
+		for (size_t i = bridges::base64::decodedLength(encoded.size()); i < buf.size(); ++i)
+			EXPECT_EQ(buf[i], canary) << "length " << len;
+
+		EXPECT_EQ(bridges::base64::decode(encoded), bytes) << "length " << len;
+	}
+}
+
+TEST(Base64, DecodeStopsAtInvalidCharacter) {
+	std::vector<bridges::BYTE> bytes = Test_Base64::testBytes(90);
+	std::string encoded = Test_Base64::referenceEncode(bytes);
+	// 120 characters; a bad one in the middle of the first SIMD block
+	encoded[10] = '*';
+	std::vector<bridges::BYTE> decoded = bridges::base64::decode(encoded);
+	ASSERT_EQ(decoded.size(), 7u);
+	EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), bytes.begin()));
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "BenchmarkResults.h"
+
+using namespace bridges::benchmark;
+
+namespace Test_BenchmarkResults {
+	inline std::string path(const std::string& name) {
+		return testing::TempDir() + "bridges_benchmarkresults_" + name;
+	}
+
+	inline BenchmarkPoint point(const std::vector<double>& samples) {
+		BenchmarkPoint p;
+		p.x = 0.;
+		p.samples = samples;
+		return p;
+	}
+
+	/// results whose series names need quoting in CSV and escaping in JSON
+	inline BenchmarkResults sample() {
+		BenchmarkResults res;
+		res.setMetadata("commit", "0123abcd");
+		res.setMetadata("flags", "-O3 -DNAME=\"x,y\"");
+		res.setMetadata("date", "2024-01-02T03:04:05");
+		res.addSample("plain", 100., 0.5);
+		res.addSample("plain", 100., 0.25);
+		res.addSample("plain", 200., 1. / 3.);
+		res.addSample("quick \"sort\", v2", 1000., 1e-7);
+		res.addSample("quick \"sort\", v2", 1000., 0.1 + 0.2);
+		res.addSample("back\\slash", 1e6, 123456.789);
+		return res;
+	}
+
+	inline void expectSameResults(const BenchmarkResults& a, const BenchmarkResults& b) {
+		EXPECT_EQ(a.getAllMetadata(), b.getAllMetadata());
+		ASSERT_EQ(a.getSeriesNames(), b.getSeriesNames());
+		for (auto& name : a.getSeriesNames()) {
+			std::vector<BenchmarkPoint> pa = a.getSeries(name), pb = b.getSeries(name);
+			ASSERT_EQ(pa.size(), pb.size()) << name;
+			for (size_t i = 0; i < pa.size(); ++i) {
+				EXPECT_EQ(pa[i].x, pb[i].x) << name;
+				EXPECT_EQ(pa[i].samples, pb[i].samples) << name;
+			}
+		}
+	}
+
+	inline void roundTrip(const std::string& file) {
+		BenchmarkResults res = sample();
+		std::string p = path(file);
+		res.save(p);
+		BenchmarkResults loaded = BenchmarkResults::load(p);
+		std::remove(p.c_str());
+		expectSameResults(res, loaded);
+	}
+}
+
+TEST(BenchmarkResults, JSONRoundTrip) {
+	using namespace Test_BenchmarkResults;
+	roundTrip("results.json");
+}
+
+TEST(BenchmarkResults, CSVRoundTrip) {
+	using namespace Test_BenchmarkResults;
+	roundTrip("results.csv");
+}
+
+TEST(BenchmarkResults, CSVQuotesSeriesNames) {
+	BenchmarkResults res;
+	res.addSample("a \"b\", c", 10., 2.);
+	std::string csv = res.toCSV();
+	EXPECT_NE(csv.find("\"a \"\"b\"\", c\",10,2\n"), std::string::npos) << csv;
+}
+
+TEST(BenchmarkResults, LoadsUnquotedCSV) {
+	using namespace Test_BenchmarkResults;
+	std::string p = path("handwritten.csv");
+	{
+		std::ofstream out(p);
+		out << "# cpu: some cpu @ 3.00GHz\n"
+			<< "series,x,time\n"
+			<< "mysort,10,0.5\n"
+			<< "\n"
+			<< "mysort,10,1.5\r\n"
+			<< "\"my,sort\",20,2\n";
+	}
+	BenchmarkResults res = BenchmarkResults::load(p);
+	std::remove(p.c_str());
+
+	EXPECT_EQ(res.getMetadata("cpu"), "some cpu @ 3.00GHz");
+	std::vector<BenchmarkPoint> pts = res.getSeries("mysort");
+	ASSERT_EQ(pts.size(), 1u);
+	EXPECT_EQ(pts[0].x, 10.);
+	EXPECT_EQ(pts[0].samples, std::vector<double>({0.5, 1.5}));
+	ASSERT_EQ(res.getSeries("my,sort").size(), 1u);
+	EXPECT_EQ(res.getSeries("my,sort")[0].samples, std::vector<double>({2.}));
+}
+
+TEST(BenchmarkResults, MalformedFilesThrow) {
+	using namespace Test_BenchmarkResults;
+	EXPECT_THROW(BenchmarkResults::load(path("missing.json")), std::runtime_error);
+
+	std::string p = path("bad.json");
+	for (const char* content : {
+				"{\"series\": [", "[1, 2]", "{}", "{\"series\": {}}",
+				"{\"series\": [{\"name\": 3, \"points\": []}]}",
+				"{\"series\": [{\"name\": \"a\", \"points\": [{\"x\": \"1\", \"samples\": []}]}]}",
+				"{\"series\": [{\"name\": \"a\", \"points\": [{\"x\": 1, \"samples\": [null]}]}]}",
+				"{\"metadata\": {\"cpu\": 1}, \"series\": []}"
+			}) {
+		{
+			std::ofstream out(p);
+			out << content;
+		}
+		EXPECT_THROW(BenchmarkResults::load(p), std::runtime_error) << content;
+	}
+	std::remove(p.c_str());
+
+	p = path("bad.csv");
+	for (const char* content : {
+				"series,x,time\nonlyonecolumn\n", "series,x,time\nsort,ten,1\n",
+				"series,x,time\nsort,10,1e999\n"
+			}) {
+		{
+			std::ofstream out(p);
+			out << content;
+		}
+		EXPECT_THROW(BenchmarkResults::load(p), std::runtime_error) << content;
+	}
+	std::remove(p.c_str());
+}
+
+TEST(BenchmarkPoint, Statistics) {
+	using namespace Test_BenchmarkResults;
+	BenchmarkPoint p = point({4., 1., 3., 2.});
+	EXPECT_DOUBLE_EQ(p.mean(), 2.5);
+	EXPECT_DOUBLE_EQ(p.median(), 2.5);
+	EXPECT_DOUBLE_EQ(p.variance(), 5. / 3.);
+	EXPECT_EQ(point({7.}).variance(), 0.);
+	EXPECT_EQ(point({}).mean(), 0.);
+}
+
+TEST(BenchmarkComparison, WelchTTestKnownValues) {
+	using namespace Test_BenchmarkResults;
+
+	// equal variances and sizes: t = -3/sqrt(2) with 2 degrees of
+	// freedom, p = 1 - |t| / sqrt(2 + t^2)
+	double t = -3. / std::sqrt(2.);
+	EXPECT_NEAR(BenchmarkComparison::welchTTest(point({0., 2.}), point({3., 5.})),
+		1. - std::abs(t) / std::sqrt(2. + t * t), 1e-12);
+
+	// one side without variance: t = -4 with 1 degree of freedom (Cauchy),
+	// p = 1 - 2 atan(|t|) / pi
+	EXPECT_NEAR(BenchmarkComparison::welchTTest(point({0., 2.}), point({5., 5.})),
+		1. - 2. * std::atan(4.) / M_PI, 1e-12);
+
+	// t = -4.25 with 8.519 degrees of freedom, p obtained by numerical
+	// integration of the Student density
+	EXPECT_NEAR(BenchmarkComparison::welchTTest(point({1.0, 1.2, 0.9, 1.1, 1.05}),
+			point({1.3, 1.25, 1.4, 1.2, 1.35, 1.5})),
+		0.002426458128150965, 1e-9);
+
+	// symmetric in its arguments
+	EXPECT_NEAR(BenchmarkComparison::welchTTest(point({1.3, 1.25, 1.4, 1.2, 1.35, 1.5}),
+			point({1.0, 1.2, 0.9, 1.1, 1.05})),
+		0.002426458128150965, 1e-9);
+}
+
+TEST(BenchmarkComparison, WelchTTestDegenerateCases) {
+	using namespace Test_BenchmarkResults;
+	EXPECT_TRUE(std::isnan(BenchmarkComparison::welchTTest(point({1.}), point({1., 2.}))));
+	EXPECT_TRUE(std::isnan(BenchmarkComparison::welchTTest(point({1., 2.}), point({}))));
+	EXPECT_EQ(BenchmarkComparison::welchTTest(point({3., 3.}), point({3., 3., 3.})), 1.);
+	EXPECT_EQ(BenchmarkComparison::welchTTest(point({3., 3.}), point({4., 4.})), 0.);
+}
+
+TEST(BenchmarkComparison, MatchesSeriesAndSizes) {
+	BenchmarkResults base, cand;
+	for (double v : {1.0, 1.2, 0.9, 1.1, 1.05})
+		base.addSample("sort", 200., v);
+	for (double v : {1.3, 1.25, 1.4, 1.2, 1.35, 1.5})
+		cand.addSample("sort", 200., v);
+	for (double v : {2., 2.2})
+		base.addSample("sort", 100., v);
+	cand.addSample("sort", 100., 1.);
+	base.addSample("sort", 300., 1.);        // not in the candidate
+	base.addSample("onlybase", 100., 1.);
+	cand.addSample("onlycand", 100., 1.);
+
+	BenchmarkComparison cmp(base, cand);
+	EXPECT_EQ(cmp.getSeriesNames(), std::vector<std::string>({"sort"}));
+
+	std::vector<BenchmarkComparison::PointComparison> pcs = cmp.getComparison("sort");
+	ASSERT_EQ(pcs.size(), 2u);
+	EXPECT_EQ(pcs[0].x, 100.);
+	EXPECT_DOUBLE_EQ(pcs[0].speedup, 2.1);
+	EXPECT_TRUE(std::isnan(pcs[0].pValue));
+	EXPECT_FALSE(pcs[0].significant);
+
+	EXPECT_EQ(pcs[1].x, 200.);
+	EXPECT_DOUBLE_EQ(pcs[1].baselineMean, 1.05);
+	EXPECT_DOUBLE_EQ(pcs[1].candidateMean, 1.3333333333333333);
+	EXPECT_NEAR(pcs[1].pValue, 0.002426458128150965, 1e-9);
+	EXPECT_TRUE(pcs[1].significant);
+
+	EXPECT_NEAR(cmp.getMeanSpeedup("sort"), std::sqrt(2.1 * 1.05 / (4. / 3.)), 1e-12);
+	EXPECT_TRUE(std::isnan(cmp.getMeanSpeedup("onlybase")));
+
+	BenchmarkComparison strict(base, cand, 0.001);
+	EXPECT_FALSE(strict.getComparison("sort")[1].significant);
+}
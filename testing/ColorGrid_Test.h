@@ -0,0 +1,429 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "ColorGrid.h"
+#include "rapidjson/document.h"
+#include <cmath>
+#include <limits>
+
+using namespace bridges;
+using namespace bridges::datastructure;
+
+namespace Test_ColorGrid {
+	/// the representation of a grid, parsed
+	inline rapidjson::Document parse(const ColorGrid& cg) {
+		rapidjson::Document d;
+		d.Parse(("{" + RepresentationAccess::get(cg)).c_str());
+		return d;
+	}
+
+	/// RGBA bytes of the pixels, row-major
+	inline std::vector<BYTE> rawPixels(const ColorGrid& cg) {
+		std::vector<BYTE> raw;
+		int rows = const_cast<ColorGrid&>(cg).getDimensions()[0];
+		int cols = const_cast<ColorGrid&>(cg).getDimensions()[1];
+		for (int i = 0; i < rows; ++i)
+			for (int j = 0; j < cols; ++j) {
+				const Color& c = cg.get(i, j);
+				raw.push_back((BYTE) c.getRed());
+				raw.push_back((BYTE) c.getGreen());
+				raw.push_back((BYTE) c.getBlue());
+				raw.push_back((BYTE) c.getAlpha());
+			}
+		return raw;
+	}
+
+	/// (run length - 1, R, G, B, A) records of at most 256 pixels, one
+	/// pixel at a time
+	inline std::vector<BYTE> referenceRLE(const std::vector<BYTE>& raw) {
+		std::vector<BYTE> rle;
+		size_t count = raw.size() / 4;
+		for (size_t pos = 0; pos < count; ) {
+			size_t run = 1;
+			while (pos + run < count && run < 256
+				&& std::equal(&raw[4 * pos], &raw[4 * pos] + 4, &raw[4 * (pos + run)]))
+				++run;
+			rle.push_back((BYTE) (run - 1));
+			rle.insert(rle.end(), &raw[4 * pos], &raw[4 * pos] + 4);
+			pos += run;
+		}
+		return rle;
+	}
+
+	/// checks the encoding of cg against the reference: RLE unless it is
+	/// larger than RAW
+	inline void expectReferenceEncoding(const ColorGrid& cg, const std::string& what) {
+		std::vector<BYTE> raw = rawPixels(cg);
+		std::vector<BYTE> rle = referenceRLE(raw);
+		bool isRLE = rle.size() <= raw.size();
+		const std::vector<BYTE>& bytes = isRLE ? rle : raw;
+
+		rapidjson::Document d = parse(cg);
+		ASSERT_FALSE(d.HasParseError()) << what;
+		EXPECT_STREQ(d["encoding"].GetString(), isRLE ? "RLE" : "RAW") << what;
+		EXPECT_EQ(std::string(d["nodes"][0].GetString()), base64::encode(bytes.data(), bytes.size())) << what;
+	}
+
+	inline Color shade(int k) {
+		return Color((k * 53) % 256, (k * 7) % 256, 255 - k % 256, 255);
+	}
+}
+
+TEST(ColorGrid, RunsOfExactly256And257Pixels) {
+	using namespace Test_ColorGrid;
+	for (int len : {255, 256, 257, 512, 513, 1000}) {
+		ColorGrid cg(1, len, colors::red);
+		expectReferenceEncoding(cg, "run of " + std::to_string(len));
+		size_t records = (len + 255) / 256;
+		std::vector<BYTE> rle = referenceRLE(rawPixels(cg));
+		ASSERT_EQ(rle.size(), 5 * records);
+		EXPECT_EQ(rle[0], 255 * (len >= 256) + (len - 1) * (len < 256));
+	}
+	// a run of 257 pixels between other colors
+	ColorGrid cg(1, 300, colors::blue);
+	for (int j = 20; j < 277; ++j)
+		cg.set(0, j, colors::green);
+	expectReferenceEncoding(cg, "inner run of 257");
+}
+
+TEST(ColorGrid, RunsCrossingVectorBoundaries) {
+	using namespace Test_ColorGrid;
+	// runs of every length from 1 to 19 start at every offset modulo 8,
+	// so they end inside, at and past the 4 and 8 pixel vectors
+	for (int offset = 0; offset < 8; ++offset) {
+		ColorGrid cg(1, 400);
+		int j = 0, k = 0;
+		for (; j < offset; ++j)
+			cg.set(0, j, shade(k++));
+		for (int len = 1; j < 400; len = len % 19 + 1, ++k)
+			for (int n = 0; n < len && j < 400; ++n)
+				cg.set(0, j++, shade(k));
+		expectReferenceEncoding(cg, "offset " + std::to_string(offset));
+	}
+	// a run that differs only in one channel of a late pixel
+	ColorGrid cg(1, 20, Color(1, 2, 3, 4));
+	cg.set(0, 13, Color(1, 2, 3, 5));
+	expectReferenceEncoding(cg, "alpha differs");
+}
+
+TEST(ColorGrid, OddWidths) {
+	using namespace Test_ColorGrid;
+	for (int rows : {1, 3, 7})
+		for (int cols : {1, 3, 5, 9, 13, 31, 33}) {
+			ColorGrid cg(rows, cols);
+			// runs continue from one row to the next
+			for (int i = 0; i < rows; ++i)
+				for (int j = 0; j < cols; ++j)
+					cg.set(i, j, shade((i * cols + j) / 6));
+			expectReferenceEncoding(cg, std::to_string(rows) + "x" + std::to_string(cols));
+		}
+}
+
+TEST(ColorGrid, FallsBackToRawWhenRLEIsLarger) {
+	using namespace Test_ColorGrid;
+	// 5 pixels are 20 RAW bytes: 4 RLE records fit exactly
+	ColorGrid fits(1, 5);
+	for (int j = 0; j < 5; ++j)
+		fits.set(0, j, shade(j < 2 ? 0 : j));
+	expectReferenceEncoding(fits, "RLE as large as RAW");
+	EXPECT_STREQ(parse(fits)["encoding"].GetString(), "RLE");
+
+	// 5 records are 25 bytes
+	ColorGrid larger(1, 5);
+	for (int j = 0; j < 5; ++j)
+		larger.set(0, j, shade(j));
+	expectReferenceEncoding(larger, "RLE larger than RAW");
+	EXPECT_STREQ(parse(larger)["encoding"].GetString(), "RAW");
+
+	// a large grid that becomes too large for RLE at the end
+	ColorGrid late(40, 40, colors::white);
+	for (int i = 30; i < 40; ++i)
+		for (int j = 0; j < 40; ++j)
+			late.set(i, j, shade(i * 40 + j));
+	expectReferenceEncoding(late, "noise at the end");
+}
+
+namespace Test_ColorGrid {
+	/// a grid large enough to be split in several chunks, with
+	/// different colors everywhere
+	inline ColorGrid pattern(int rows, int cols) {
+		ColorGrid cg(rows, cols);
+		for (int i = 0; i < rows; ++i)
+			for (int j = 0; j < cols; ++j)
+				cg.set(i, j, Color((i * 31 + j) % 256, (j * 17) % 256, (i * j) % 256, (i + j * 3) % 256));
+		return cg;
+	}
+
+	inline void expectSameGrids(const ColorGrid& a, const ColorGrid& b) {
+		int rows = const_cast<ColorGrid&>(a).getDimensions()[0];
+		int cols = const_cast<ColorGrid&>(a).getDimensions()[1];
+		for (int i = 0; i < rows; ++i)
+			for (int j = 0; j < cols; ++j)
+				ASSERT_EQ(a.get(i, j), b.get(i, j)) << "pixel " << i << ", " << j;
+	}
+}
+
+TEST(ColorGrid, ForEachPixelAndTransformMatchASerialLoop) {
+	using namespace Test_ColorGrid;
+	ColorGrid cg = pattern(301, 207), expected = pattern(301, 207);
+	cg.forEachPixel([](int i, int j, Color& c) {
+		c = Color(255 - c.getRed(), (i + j) % 256, c.getBlue(), c.getAlpha());
+	});
+	for (int i = 0; i < 301; ++i)
+		for (int j = 0; j < 207; ++j) {
+			Color c = expected.get(i, j);
+			expected.set(i, j, Color(255 - c.getRed(), (i + j) % 256, c.getBlue(), c.getAlpha()));
+		}
+	expectSameGrids(cg, expected);
+
+	cg.transform([](int i, int j) {
+		return Color(i % 256, j % 256, (i ^ j) % 256, 255);
+	});
+	for (int i = 0; i < 301; ++i)
+		for (int j = 0; j < 207; ++j)
+			expected.set(i, j, Color(i % 256, j % 256, (i ^ j) % 256, 255));
+	expectSameGrids(cg, expected);
+}
+
+TEST(ColorGrid, FillRectIsClipped) {
+	using namespace Test_ColorGrid;
+	const int rect[][4] = {{10, 20, 30, 40}, {-5, -7, 20, 30}, {290, 200, 50, 50},
+		{0, 0, 301, 207}, {-10, 5, 400, 1}, {50, 50, 0, 10}, {400, 0, 5, 5}
+	};
+	for (auto& r : rect) {
+		ColorGrid cg = pattern(301, 207), expected = pattern(301, 207);
+		cg.fillRect(r[0], r[1], r[2], r[3], colors::orange);
+		for (int i = 0; i < 301; ++i)
+			for (int j = 0; j < 207; ++j)
+				if (i >= r[0] && i < r[0] + r[2] && j >= r[1] && j < r[1] + r[3])
+					expected.set(i, j, colors::orange);
+		expectSameGrids(cg, expected);
+	}
+}
+
+TEST(ColorGrid, BlendMatchesASerialLoop) {
+	using namespace Test_ColorGrid;
+	ColorGrid other(301, 207);
+	other.transform([](int i, int j) {
+		return Color((i * 7) % 256, (j * 13) % 256, 255 - (i + j) % 256, (i * j) % 256);
+	});
+	for (double alpha : {0., 0.25, 0.5, 0.9, 1., -1., 2.}) {
+		ColorGrid cg = pattern(301, 207), expected = pattern(301, 207);
+		cg.blend(other, alpha);
+		int w = (int) std::lround(std::min(1., std::max(0., alpha)) * 256.);
+		for (int i = 0; i < 301; ++i)
+			for (int j = 0; j < 207; ++j) {
+				Color a = expected.get(i, j), b = other.get(i, j);
+				auto mix = [w](int x, int y) {
+					return (x * (256 - w) + y * w + 128) >> 8;
+				};
+				expected.set(i, j, Color(mix(a.getRed(), b.getRed()), mix(a.getGreen(), b.getGreen()),
+						mix(a.getBlue(), b.getBlue()), mix(a.getAlpha(), b.getAlpha())));
+			}
+		expectSameGrids(cg, expected);
+		if (alpha <= 0.)
+			expectSameGrids(cg, pattern(301, 207));
+		if (alpha >= 1.)
+			expectSameGrids(cg, other);
+	}
+	ColorGrid small(3, 3);
+	EXPECT_THROW(small.blend(other, 0.5), std::invalid_argument);
+}
+
+TEST(ColorGrid, ColormapMatchesASerialLoop) {
+	using namespace Test_ColorGrid;
+	const int rows = 211, cols = 157;
+	std::vector<double> field((size_t) rows * cols);
+	for (size_t k = 0; k < field.size(); ++k)
+		field[k] = -20. + (double) (k % 1000) * 0.14;
+	field[17] = std::numeric_limits<double>::quiet_NaN();
+
+	// a palette from black to red puts the table index in the red channel
+	ColorGrid cg(rows, cols);
+	cg.colormap(field, 0., 100., {Color(0, 0, 0), Color(255, 0, 0)});
+	for (int i = 0; i < rows; ++i)
+		for (int j = 0; j < cols; ++j) {
+			double v = field[(size_t) i * cols + j];
+			int red = std::isnan(v) ? 0 : (int) std::lround(std::min(255., std::max(0., v * 2.55)));
+			ASSERT_EQ(cg.get(i, j), Color(red, 0, 0)) << "value " << v;
+		}
+
+	EXPECT_THROW(cg.colormap(std::vector<double>(5), 0., 1.), std::invalid_argument);
+	EXPECT_THROW(cg.colormap(field, 0., 1., {}), std::invalid_argument);
+}
+
+TEST(ColorGrid, ConvolveMatchesASerialLoopAtTheEdges) {
+	using namespace Test_ColorGrid;
+	// an asymmetric kernel catches flipped or shifted taps
+	auto kernelOf = [](int size) {
+		std::vector<double> k((size_t) size * size);
+		for (size_t t = 0; t < k.size(); ++t)
+			k[t] = (t % 3 == 1) ? 0. : (double) (t + 1) / (size * size * 4) - 0.02;
+		return k;
+	};
+	const int dims[][2] = {{301, 207}, {1, 9}, {9, 1}, {2, 3}, {5, 5}};
+	for (int size : {1, 3, 5, 7})
+		for (auto& d : dims) {
+			const int rows = d[0], cols = d[1];
+			std::vector<double> kernel = kernelOf(size);
+			ColorGrid cg = pattern(rows, cols), src = pattern(rows, cols), expected = pattern(rows, cols);
+			cg.convolve(kernel, size);
+			const int half = size / 2;
+			for (int i = 0; i < rows; ++i)
+				for (int j = 0; j < cols; ++j) {
+					double acc[3] = {0., 0., 0.};
+					for (int ki = 0; ki < size; ++ki)
+						for (int kj = 0; kj < size; ++kj) {
+							double wt = kernel[(size_t) ki * size + kj];
+							if (wt == 0.)
+								continue;
+							int si = std::min(rows - 1, std::max(0, i + ki - half));
+							int sj = std::min(cols - 1, std::max(0, j + kj - half));
+							const Color& c = src.get(si, sj);
+							acc[0] += wt * c.getRed();
+							acc[1] += wt * c.getGreen();
+							acc[2] += wt * c.getBlue();
+						}
+					auto clamp = [](double v) {
+						return v <= 0. ? 0 : (v >= 255. ? 255 : (int) (v + 0.5));
+					};
+					expected.set(i, j, Color(clamp(acc[0]), clamp(acc[1]), clamp(acc[2]),
+							src.get(i, j).getAlpha()));
+				}
+			SCOPED_TRACE(std::to_string(rows) + "x" + std::to_string(cols) + " kernel " + std::to_string(size));
+			expectSameGrids(cg, expected);
+		}
+
+	ColorGrid cg(4, 4);
+	EXPECT_THROW(cg.convolve({1., 1., 1., 1.}, 2), std::invalid_argument);
+	EXPECT_THROW(cg.convolve({1., 1.}, 3), std::invalid_argument);
+}
+
+namespace Test_ColorGrid {
+	/// the RGBA pixels of a RAW or RLE payload
+	inline std::vector<BYTE> decodePixels(const std::string& encoding, const std::string& b64) {
+		std::vector<BYTE> bytes(base64::decodedLength(b64.size()) + 16);
+		bytes.resize(base64::decode(b64.data(), b64.size(), bytes.data()));
+		if (encoding == "RAW")
+			return bytes;
+		std::vector<BYTE> raw;
+		for (size_t k = 0; k + 5 <= bytes.size(); k += 5)
+			for (int n = 0; n <= bytes[k]; ++n)
+				raw.insert(raw.end(), &bytes[k + 1], &bytes[k + 5]);
+		return raw;
+	}
+
+	/// checks that a rectangle [row, col, h, w, encoding, pixels] of a
+	/// delta frame holds the pixels of cg
+	inline void expectRect(const rapidjson::Value& rect, const ColorGrid& cg, int row, int col, int h, int w) {
+		ASSERT_EQ(rect.Size(), 6u);
+		EXPECT_EQ(rect[0].GetInt(), row);
+		EXPECT_EQ(rect[1].GetInt(), col);
+		ASSERT_EQ(rect[2].GetInt(), h);
+		ASSERT_EQ(rect[3].GetInt(), w);
+		std::vector<BYTE> px = decodePixels(rect[4].GetString(), rect[5].GetString());
+		ASSERT_EQ(px.size(), 4 * (size_t) h * w);
+		for (int i = 0; i < h; ++i)
+			for (int j = 0; j < w; ++j) {
+				const BYTE* p = &px[4 * ((size_t) i * w + j)];
+				ASSERT_EQ(Color(p[0], p[1], p[2], p[3]), cg.get(row + i, col + j)) << "pixel " << row + i << ", " << col + j;
+			}
+	}
+
+	/// posts the representation of cg, as visualize() does
+	inline rapidjson::Document post(const ColorGrid& cg) {
+		rapidjson::Document d = parse(cg);
+		RepresentationAccess::sent(cg);
+		return d;
+	}
+}
+
+TEST(ColorGrid, DeltaFramesSendTheChangedTiles) {
+	using namespace Test_ColorGrid;
+	// 100 columns are 3 full tiles and one 4 pixels wide
+	ColorGrid cg(70, 100, colors::white);
+	cg.setDeltaFrames(true);
+	EXPECT_STRNE(post(cg)["encoding"].GetString(), "DELTA");
+
+	cg.set(40, 70, colors::red);
+	rapidjson::Document d = post(cg);
+	ASSERT_STREQ(d["encoding"].GetString(), "DELTA");
+	EXPECT_EQ(d["dimensions"][0].GetInt(), 70);
+	EXPECT_EQ(d["dimensions"][1].GetInt(), 100);
+	ASSERT_EQ(d["rects"].Size(), 1u);
+	expectRect(d["rects"][0], cg, 32, 64, 32, 32);
+
+	// adjacent changed tiles form one rectangle, separated ones two;
+	// the last band of rows and column of tiles are clipped
+	cg.set(0, 0, colors::blue);
+	cg.set(31, 63, colors::blue);
+	cg.set(69, 0, colors::green);
+	cg.set(69, 99, colors::green);
+	d = post(cg);
+	ASSERT_STREQ(d["encoding"].GetString(), "DELTA");
+	ASSERT_EQ(d["rects"].Size(), 3u);
+	expectRect(d["rects"][0], cg, 0, 0, 32, 64);
+	expectRect(d["rects"][1], cg, 64, 0, 6, 32);
+	expectRect(d["rects"][2], cg, 64, 96, 6, 4);
+
+	// nothing changed
+	d = post(cg);
+	ASSERT_STREQ(d["encoding"].GetString(), "DELTA");
+	EXPECT_EQ(d["rects"].Size(), 0u);
+}
+
+TEST(ColorGrid, DeltaBaselineAdvancesOnlyWhenSent) {
+	using namespace Test_ColorGrid;
+	ColorGrid cg(64, 64, colors::white);
+	cg.setDeltaFrames(true);
+	post(cg);
+
+	cg.set(0, 0, colors::red);
+	rapidjson::Document d = parse(cg);  // a failed post
+	ASSERT_EQ(d["rects"].Size(), 1u);
+
+	// the next frame is still relative to the first one
+	cg.set(63, 63, colors::red);
+	d = parse(cg);
+	ASSERT_STREQ(d["encoding"].GetString(), "DELTA");
+	ASSERT_EQ(d["rects"].Size(), 2u);
+	expectRect(d["rects"][0], cg, 0, 0, 32, 32);
+	expectRect(d["rects"][1], cg, 32, 32, 32, 32);
+	RepresentationAccess::sent(cg);
+
+	// sent once only: a second call does not move the baseline again
+	RepresentationAccess::sent(cg);
+	cg.set(63, 0, colors::red);
+	d = post(cg);
+	ASSERT_EQ(d["rects"].Size(), 1u);
+	expectRect(d["rects"][0], cg, 32, 0, 32, 32);
+}
+
+TEST(ColorGrid, DeltaFramesHaveKeyframes) {
+	using namespace Test_ColorGrid;
+	ColorGrid cg(64, 64, colors::white);
+	cg.setDeltaFrames(true, 3);
+	std::string encodings;
+	for (int f = 0; f < 7; ++f) {
+		cg.set(f, f, colors::red);
+		encodings += post(cg)["encoding"].GetString()[0];
+	}
+	// R(LE) keyframes every 3 frames, D(ELTA) in between
+	EXPECT_EQ(encodings, "RDDRDDR");
+
+	// a delta larger than half the frame is sent as a keyframe
+	ColorGrid noisy(64, 64, colors::white);
+	noisy.setDeltaFrames(true);
+	post(noisy);
+	noisy.transform([](int i, int j) {
+		return Color((i * 37 + j * 11) % 256, (i * j) % 256, (i + j) % 256);
+	});
+	rapidjson::Document d = post(noisy);
+	EXPECT_STRNE(d["encoding"].GetString(), "DELTA");
+	d = post(noisy);
+	EXPECT_STREQ(d["encoding"].GetString(), "DELTA");
+
+	// so does a frame of other dimensions
+	noisy.setDimensions(32, 64);
+	EXPECT_STRNE(post(noisy)["encoding"].GetString(), "DELTA");
+}
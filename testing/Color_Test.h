@@ -95,6 +95,222 @@ namespace Test_Color
         assert(Color("#FF000000") != Color("red"));
     }
 
+    void testGetSetEachChannel()
+    {
+        Color c(10,20,30,40);
+        c.setRed(200);
+        assert(c.getRed() == 200 && c.getGreen() == 20 && c.getBlue() == 30 && c.getAlpha() == 40);
+        c.setGreen(0);
+        assert(c.getRed() == 200 && c.getGreen() == 0 && c.getBlue() == 30 && c.getAlpha() == 40);
+        c.setBlue(255);
+        assert(c.getRed() == 200 && c.getGreen() == 0 && c.getBlue() == 255 && c.getAlpha() == 40);
+        c.setAlpha(255);
+        assert(c.getRed() == 200 && c.getGreen() == 0 && c.getBlue() == 255 && c.getAlpha() == 255);
+        assert(c == Color(200,0,255));
+
+        bool thrown = false;
+        try { c.setGreen(256); } catch (...) { thrown = true; }
+        assert(thrown);
+        thrown = false;
+        try { c.setAlpha(-1); } catch (...) { thrown = true; }
+        assert(thrown);
+        assert(c == Color(200,0,255));
+    }
+    void testRGBA()
+    {
+        // red is the low byte, alpha the high byte
+        assert(Color(0x12,0x34,0x56,0x78).getRGBA() == 0x78563412u);
+        assert(Color::fromRGBA(0x78563412u) == Color(0x12,0x34,0x56,0x78));
+        assert(Color::fromRGBA(0u) == Color(0,0,0,0));
+        assert(Color::fromRGBA(0xFFFFFFFFu) == Color("white"));
+        for (uint32_t v : {0u, 1u, 0xFFu, 0xFF00u, 0xFF0000u, 0xFF000000u, 0x80C0E0F0u, 0xDEADBEEFu})
+        {
+            Color c = Color::fromRGBA(v);
+            assert(c.getRGBA() == v);
+            assert(c == Color(v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, v >> 24));
+        }
+        static_assert(sizeof(Color) == 4, "a Color is one packed rgba value");
+    }
+    void testCSSRepresentation()
+    {
+        // a transparent color is written the same whatever its other channels
+        assert(Color(0,0,0,0).getCSSRepresentation() == "[0, 0, 0, 0.0]");
+        assert(Color(255,128,7,0).getCSSRepresentation() == "[0, 0, 0, 0.0]");
+
+        // every alpha value is written as JSONencode writes alpha / 255
+        for (int a = 1; a < 256; ++a)
+        {
+            Color c(255,128,7,a);
+            string expected = "[255,128,7," + JSONUtil::JSONencode((float) a / 255.0f) + "]";
+            assert(c.getCSSRepresentation() == expected);
+            string appended = "x";
+            c.appendCSSRepresentation(appended);
+            assert(appended == "x" + expected);
+        }
+        assert(Color(0,9,10).getCSSRepresentation() == "[0,9,10,1.0]");
+        assert(Color(99,100,254).getCSSRepresentation() == "[99,100,254,1.0]");
+    }
+    /** The named colors and their channels, as the name table defined them */
+    struct NamedColor
+    {
+        const char* name;
+        Color constant;
+        array<int,4> channels;
+    };
+    void testNamedColors()
+    {
+        const NamedColor named[] =
+        {
+            {"aliceblue", colors::aliceblue, {240, 248, 255, 255}},
+            {"antiquewhite", colors::antiquewhite, {250, 235, 215, 255}},
+            {"cyan", colors::cyan, {0, 255, 255, 255}},
+            {"aquamarine", colors::aquamarine, {127, 255, 212, 255}},
+            {"azure", colors::azure, {240, 255, 255, 255}},
+            {"beige", colors::beige, {245, 245, 220, 255}},
+            {"bisque", colors::bisque, {255, 228, 196, 255}},
+            {"black", colors::black, {0, 0, 0, 255}},
+            {"blanchedalmond", colors::blanchedalmond, {255, 235, 205, 255}},
+            {"blue", colors::blue, {0, 0, 255, 255}},
+            {"blueviolet", colors::blueviolet, {138, 43, 226, 255}},
+            {"brown", colors::brown, {165, 42, 42, 255}},
+            {"burlywood", colors::burlywood, {222, 184, 135, 255}},
+            {"cadetblue", colors::cadetblue, {95, 158, 160, 255}},
+            {"chartreuse", colors::chartreuse, {127, 255, 0, 255}},
+            {"chocolate", colors::chocolate, {210, 105, 30, 255}},
+            {"coral", colors::coral, {255, 127, 80, 255}},
+            {"cornflowerblue", colors::cornflowerblue, {100, 149, 237, 255}},
+            {"cornsilk", colors::cornsilk, {255, 248, 220, 255}},
+            {"crimson", colors::crimson, {220, 20, 60, 255}},
+            {"darkblue", colors::darkblue, {0, 0, 139, 255}},
+            {"darkcyan", colors::darkcyan, {0, 139, 139, 255}},
+            {"darkgoldenrod", colors::darkgoldenrod, {184, 134, 11, 255}},
+            {"darkgrey", colors::darkgrey, {169, 169, 169, 255}},
+            {"darkgreen", colors::darkgreen, {0, 100, 0, 255}},
+            {"darkkhaki", colors::darkkhaki, {189, 183, 107, 255}},
+            {"darkmagenta", colors::darkmagenta, {139, 0, 139, 255}},
+            {"darkolivegreen", colors::darkolivegreen, {85, 107, 47, 255}},
+            {"darkorange", colors::darkorange, {255, 140, 0, 255}},
+            {"darkorchid", colors::darkorchid, {153, 50, 204, 255}},
+            {"darkred", colors::darkred, {139, 0, 0, 255}},
+            {"darksalmon", colors::darksalmon, {233, 150, 122, 255}},
+            {"darkseagreen", colors::darkseagreen, {143, 188, 143, 255}},
+            {"darkslateblue", colors::darkslateblue, {72, 61, 139, 255}},
+            {"darkslategrey", colors::darkslategrey, {47, 79, 79, 255}},
+            {"darkturquoise", colors::darkturquoise, {0, 206, 209, 255}},
+            {"darkviolet", colors::darkviolet, {148, 0, 211, 255}},
+            {"deeppink", colors::deeppink, {255, 20, 147, 255}},
+            {"deepskyblue", colors::deepskyblue, {0, 191, 255, 255}},
+            {"dimgrey", colors::dimgrey, {105, 105, 105, 255}},
+            {"dodgerblue", colors::dodgerblue, {30, 144, 255, 255}},
+            {"firebrick", colors::firebrick, {178, 34, 34, 255}},
+            {"floralwhite", colors::floralwhite, {255, 250, 240, 255}},
+            {"forestgreen", colors::forestgreen, {34, 139, 34, 255}},
+            {"magenta", colors::magenta, {255, 0, 255, 255}},
+            {"gainsboro", colors::gainsboro, {220, 220, 220, 255}},
+            {"ghostwhite", colors::ghostwhite, {248, 248, 255, 255}},
+            {"gold", colors::gold, {255, 215, 0, 255}},
+            {"goldenrod", colors::goldenrod, {218, 165, 32, 255}},
+            {"grey", colors::grey, {128, 128, 128, 255}},
+            {"green", colors::green, {0, 128, 0, 255}},
+            {"greenyellow", colors::greenyellow, {173, 255, 47, 255}},
+            {"honeydew", colors::honeydew, {240, 255, 240, 255}},
+            {"hotpink", colors::hotpink, {255, 105, 180, 255}},
+            {"indianred", colors::indianred, {205, 92, 92, 255}},
+            {"indigo", colors::indigo, {75, 0, 130, 255}},
+            {"ivory", colors::ivory, {255, 255, 240, 255}},
+            {"khaki", colors::khaki, {240, 230, 140, 255}},
+            {"lavender", colors::lavender, {230, 230, 250, 255}},
+            {"lavenderblush", colors::lavenderblush, {255, 240, 245, 255}},
+            {"lawngreen", colors::lawngreen, {124, 252, 0, 255}},
+            {"lemonchiffon", colors::lemonchiffon, {255, 250, 205, 255}},
+            {"lightblue", colors::lightblue, {173, 216, 230, 255}},
+            {"lightcoral", colors::lightcoral, {240, 128, 128, 255}},
+            {"lightcyan", colors::lightcyan, {224, 255, 255, 255}},
+            {"lightgoldenrodyellow", colors::lightgoldenrodyellow, {250, 250, 210, 255}},
+            {"lightgrey", colors::lightgrey, {211, 211, 211, 255}},
+            {"lightgreen", colors::lightgreen, {144, 238, 144, 255}},
+            {"lightpink", colors::lightpink, {255, 182, 193, 255}},
+            {"lightsalmon", colors::lightsalmon, {255, 160, 122, 255}},
+            {"lightseagreen", colors::lightseagreen, {32, 178, 170, 255}},
+            {"lightskyblue", colors::lightskyblue, {135, 206, 250, 255}},
+            {"lightslategrey", colors::lightslategrey, {119, 136, 153, 255}},
+            {"lightsteelblue", colors::lightsteelblue, {176, 196, 222, 255}},
+            {"lightyellow", colors::lightyellow, {255, 255, 224, 255}},
+            {"lime", colors::lime, {0, 255, 0, 255}},
+            {"limegreen", colors::limegreen, {50, 205, 50, 255}},
+            {"linen", colors::linen, {250, 240, 230, 255}},
+            {"maroon", colors::maroon, {128, 0, 0, 255}},
+            {"mediumaquamarine", colors::mediumaquamarine, {102, 205, 170, 255}},
+            {"mediumblue", colors::mediumblue, {0, 0, 205, 255}},
+            {"mediumorchid", colors::mediumorchid, {186, 85, 211, 255}},
+            {"mediumpurple", colors::mediumpurple, {147, 112, 219, 255}},
+            {"mediumseagreen", colors::mediumseagreen, {60, 179, 113, 255}},
+            {"mediumslateblue", colors::mediumslateblue, {123, 104, 238, 255}},
+            {"mediumspringgreen", colors::mediumspringgreen, {0, 250, 154, 255}},
+            {"mediumturquoise", colors::mediumturquoise, {72, 209, 204, 255}},
+            {"mediumvioletred", colors::mediumvioletred, {199, 21, 133, 255}},
+            {"midnightblue", colors::midnightblue, {25, 25, 112, 255}},
+            {"mintcream", colors::mintcream, {245, 255, 250, 255}},
+            {"mistyrose", colors::mistyrose, {255, 228, 225, 255}},
+            {"moccasin", colors::moccasin, {255, 228, 181, 255}},
+            {"navajowhite", colors::navajowhite, {255, 222, 173, 255}},
+            {"navy", colors::navy, {0, 0, 128, 255}},
+            {"oldlace", colors::oldlace, {253, 245, 230, 255}},
+            {"olive", colors::olive, {128, 128, 0, 255}},
+            {"olivedrab", colors::olivedrab, {107, 142, 35, 255}},
+            {"orange", colors::orange, {255, 165, 0, 255}},
+            {"orangered", colors::orangered, {255, 69, 0, 255}},
+            {"orchid", colors::orchid, {218, 112, 214, 255}},
+            {"palegoldenrod", colors::palegoldenrod, {238, 232, 170, 255}},
+            {"palegreen", colors::palegreen, {152, 251, 152, 255}},
+            {"paleturquoise", colors::paleturquoise, {175, 238, 238, 255}},
+            {"palevioletred", colors::palevioletred, {219, 112, 147, 255}},
+            {"papayawhip", colors::papayawhip, {255, 239, 213, 255}},
+            {"peachpuff", colors::peachpuff, {255, 218, 185, 255}},
+            {"peru", colors::peru, {205, 133, 63, 255}},
+            {"pink", colors::pink, {255, 192, 203, 255}},
+            {"plum", colors::plum, {221, 160, 221, 255}},
+            {"powderblue", colors::powderblue, {176, 224, 230, 255}},
+            {"purple", colors::purple, {128, 0, 128, 255}},
+            {"red", colors::red, {255, 0, 0, 255}},
+            {"rosybrown", colors::rosybrown, {188, 143, 143, 255}},
+            {"royalblue", colors::royalblue, {65, 105, 225, 255}},
+            {"saddlebrown", colors::saddlebrown, {139, 69, 19, 255}},
+            {"salmon", colors::salmon, {250, 128, 114, 255}},
+            {"sandybrown", colors::sandybrown, {244, 164, 96, 255}},
+            {"seagreen", colors::seagreen, {46, 139, 87, 255}},
+            {"seashell", colors::seashell, {255, 245, 238, 255}},
+            {"sienna", colors::sienna, {160, 82, 45, 255}},
+            {"silver", colors::silver, {192, 192, 192, 255}},
+            {"skyblue", colors::skyblue, {135, 206, 235, 255}},
+            {"slateblue", colors::slateblue, {106, 90, 205, 255}},
+            {"slategrey", colors::slategrey, {112, 128, 144, 255}},
+            {"snow", colors::snow, {255, 250, 250, 255}},
+            {"springgreen", colors::springgreen, {0, 255, 127, 255}},
+            {"steelblue", colors::steelblue, {70, 130, 180, 255}},
+            {"tan", colors::tan, {210, 180, 140, 255}},
+            {"teal", colors::teal, {0, 128, 128, 255}},
+            {"thistle", colors::thistle, {216, 191, 216, 255}},
+            {"tomato", colors::tomato, {255, 99, 71, 255}},
+            {"turquoise", colors::turquoise, {64, 224, 208, 255}},
+            {"violet", colors::violet, {238, 130, 238, 255}},
+            {"wheat", colors::wheat, {245, 222, 179, 255}},
+            {"white", colors::white, {255, 255, 255, 255}},
+            {"whitesmoke", colors::whitesmoke, {245, 245, 245, 255}},
+            {"yellow", colors::yellow, {255, 255, 0, 255}},
+            {"yellowgreen", colors::yellowgreen, {154, 205, 50, 255}},
+        };
+        for (const NamedColor& n : named)
+        {
+            Color expected(n.channels.at(0), n.channels.at(1), n.channels.at(2), n.channels.at(3));
+            assert(n.constant == expected);
+            assert(Color(n.name) == expected);
+        }
+        // usable in constant expressions
+        static_assert(colors::red.getRed() == 255 && colors::red.getGreen() == 0, "colors::red");
+        static_assert(colors::black == Color(), "the default color is black");
+    }
+
     /** Runs Tests for any cases provided */
     void runTests(const vector<TestCase*>& cases)
     {
@@ -106,6 +322,10 @@ namespace Test_Color
             testGetHex(tc);
         }
         testEquality();
+        testGetSetEachChannel();
+        testRGBA();
+        testCSSRepresentation();
+        testNamedColors();
     }
     /** Runs Tests for cases pertaining to this object */
     void runTests(){runTests(nativeCases());}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ComplexityFit.h"
+
+using namespace bridges::benchmark;
+
+namespace Test_ComplexityFit {
+	/// runtimes a + b * f(n) for n = 1000 ... 1024000, with a deterministic
+	/// relative noise of at most 1%
+	inline void synthetic(const std::function<double(double)>& f, double a, double b,
+		std::vector<double>& sizes, std::vector<double>& times) {
+		sizes.clear();
+		times.clear();
+		for (int i = 0; i <= 10; ++i) {
+			double n = 1000. * (1 << i);
+			sizes.push_back(n);
+			times.push_back((a + b * f(n)) * (1. + 0.01 * std::sin(2.3 * i)));
+		}
+	}
+
+	/// checks the best model and that the models are sorted by AIC
+	inline void expectBest(const ComplexityFit& fit, const std::string& name) {
+		EXPECT_EQ(fit.getBestModel().name, name);
+		const std::vector<FittedModel>& models = fit.getModels();
+		for (size_t i = 1; i < models.size(); ++i)
+			EXPECT_LE(models[i - 1].aic, models[i].aic);
+		EXPECT_LT(fit.getBestModel().error, 0.02);
+	}
+}
+
+TEST(ComplexityFit, RanksTheGeneratingModelFirst) {
+	using namespace Test_ComplexityFit;
+	std::vector<double> sizes, times;
+
+	synthetic([](double n) {
+		return n;
+	}, 1e-5, 2e-9, sizes, times);
+	ComplexityFit linear(sizes, times);
+	expectBest(linear, "n");
+	EXPECT_NEAR(linear.getBestModel().coefficients[1], 2e-9, 2e-10);
+	EXPECT_GT(linear.getModel("n^2").aic, linear.getModel("n").aic + 10.);
+
+	synthetic([](double n) {
+		return n * std::log2(n);
+	}, 1e-5, 3e-9, sizes, times);
+	ComplexityFit nlogn(sizes, times);
+	expectBest(nlogn, "n log n");
+	// n^k fits about as well but pays for its extra parameter
+	EXPECT_LT(nlogn.getModel("n log n").aic, nlogn.getModel("n^k").aic);
+	EXPECT_LT(nlogn.getModel("n log n").aic, nlogn.getModel("n").aic);
+
+	synthetic([](double n) {
+		return n * n;
+	}, 1e-4, 1e-12, sizes, times);
+	ComplexityFit quadratic(sizes, times);
+	expectBest(quadratic, "n^2");
+	EXPECT_NEAR(quadratic.getModel("n^k").exponent, 2., 0.05);
+	EXPECT_NEAR(quadratic.getBestModel().evaluate(1e6), 1e-4 + 1., 0.02);
+	EXPECT_EQ(quadratic.getDroppedPoints(), 0u);
+}
+
+TEST(ComplexityFit, DropsNonPositiveTimes) {
+	using namespace Test_ComplexityFit;
+	std::vector<double> sizes, times;
+	synthetic([](double n) {
+		return n * n;
+	}, 1e-4, 1e-12, sizes, times);
+	ComplexityFit clean(sizes, times);
+
+	// runs too short for the clock, and a broken measurement
+	sizes.insert(sizes.begin(), {10., 20., 40.});
+	times.insert(times.begin(), {0., -1e-9, std::nan("")});
+	ComplexityFit fit(sizes, times);
+	EXPECT_EQ(fit.getDroppedPoints(), 3u);
+	expectBest(fit, "n^2");
+	EXPECT_DOUBLE_EQ(fit.getBestModel().aic, clean.getBestModel().aic);
+
+	// 3 usable points are enough, 2 are not
+	EXPECT_NO_THROW(ComplexityFit({1., 100., 1000., 1e4, 1e5}, {0., 0., 1e-3, 1e-2, 1e-1}));
+	EXPECT_THROW(ComplexityFit({1., 100., 1000., 1e4}, {0., 0., 1e-3, 1e-2}), std::runtime_error);
+	EXPECT_THROW(ComplexityFit({1., 100.}, {1., 2., 3.}), std::runtime_error);
+}
+
+TEST(ComplexityFit, GraphModel) {
+	std::vector<double> vertices, edges, times;
+	for (int i = 0; i < 12; ++i) {
+		double n = 1000. * (i + 1), m = n * (1 + (i * 7) % 5);
+		vertices.push_back(n);
+		edges.push_back(m);
+		times.push_back((1e-5 + 4e-9 * n + 1e-8 * m) * (1. + 0.005 * std::cos(1.7 * i)));
+	}
+	// a graph with no measurable time is dropped with its edge count
+	vertices.push_back(1.);
+	edges.push_back(0.);
+	times.push_back(0.);
+	ComplexityFit fit(vertices, edges, times);
+	EXPECT_EQ(fit.getDroppedPoints(), 1u);
+	EXPECT_EQ(fit.getBestModel().name, "n + m");
+	EXPECT_NEAR(fit.getBestModel().coefficients[2], 1e-8, 1e-9);
+}
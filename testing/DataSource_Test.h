@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "DataSource.h"
+#include "ColorGrid.h"
+
+using namespace bridges;
+using namespace bridges::datastructure;
+
+namespace Test_DataSource {
+	/// an assignment holding the representation of cg, as the server stores it
+	inline std::string assignmentOf(const ColorGrid& cg) {
+		return "{\"assignment_type\":\"ColorGrid\",\"title\":\"t\",\"data\":[{"
+			+ RepresentationAccess::get(cg) + "]}";
+	}
+
+	inline ColorGrid noise(int rows, int cols) {
+		ColorGrid cg(rows, cols);
+		cg.transform([](int i, int j) {
+			return Color((i * 97 + j * 13) % 256, (i * j + 7) % 256, (i ^ j) % 256, (i * 5 + j) % 256);
+		});
+		return cg;
+	}
+
+	inline void expectSameGrids(const ColorGrid& a, const ColorGrid& b) {
+		ASSERT_EQ(a.getHeight(), b.getHeight());
+		ASSERT_EQ(a.getWidth(), b.getWidth());
+		for (int i = 0; i < a.getHeight(); ++i)
+			for (int j = 0; j < a.getWidth(); ++j)
+				ASSERT_EQ(a.get(i, j), b.get(i, j)) << "pixel " << i << ", " << j;
+	}
+}
+
+TEST(DataSource, DecodesRAWColorGrids) {
+	using namespace Test_DataSource;
+	DataSource ds;
+	// 4 * pixels bytes end on every position of a base64 quad, so the
+	// last pixels go through the tail buffer with 0, 1 or 2 padding
+	for (int rows : {1, 2, 3})
+		for (int cols : {1, 2, 3, 4, 5, 7, 64}) {
+			ColorGrid cg = noise(rows, cols);
+			std::string json = assignmentOf(cg);
+			ASSERT_NE(json.find("\"RAW\""), std::string::npos);
+			SCOPED_TRACE(std::to_string(rows) + "x" + std::to_string(cols));
+			expectSameGrids(ds.getColorGridFromJSON(json), cg);
+		}
+}
+
+TEST(DataSource, DecodesRLEColorGrids) {
+	using namespace Test_DataSource;
+	DataSource ds;
+	ColorGrid cg(37, 300, colors::white);
+	cg.fillRect(3, 5, 20, 290, colors::red);   // runs longer than 256
+	cg.set(36, 299, colors::blue);
+	std::string json = assignmentOf(cg);
+	ASSERT_NE(json.find("\"RLE\""), std::string::npos);
+	expectSameGrids(ds.getColorGridFromJSON(json), cg);
+
+	ColorGrid one(1, 1, colors::green);
+	expectSameGrids(ds.getColorGridFromJSON(assignmentOf(one)), one);
+}
+
+TEST(DataSource, FieldsMayComeInAnyOrder) {
+	using namespace Test_DataSource;
+	DataSource ds;
+	ColorGrid cg = noise(2, 3);
+	std::string rep = RepresentationAccess::get(cg);
+	std::string nodes = rep.substr(rep.find("\"nodes\""));
+	nodes.pop_back();
+	// nodes before the dimensions, extra fields and data after the grid
+	std::string json = "{\"data\":[{\"extra\":[1,{\"nodes\":[\"x\"]}]," + nodes
+		+ ",\"encoding\":\"RAW\",\"dimensions\":[2,3]},{\"encoding\":\"RLE\"}],"
+		+ "\"assignment_type\":\"ColorGrid\",\"x\":-1.5}";
+	expectSameGrids(ds.getColorGridFromJSON(json), cg);
+}
+
+TEST(DataSource, MalformedColorGrids) {
+	using namespace Test_DataSource;
+	DataSource ds;
+	std::string good = assignmentOf(noise(2, 2));
+	const std::string bad[] = {
+		"{", "[]", "{\"data\":[]}",
+		"{\"assignment_type\":\"Tree\",\"data\":[]}",
+		"{\"assignment_type\":\"ColorGrid\",\"data\":[]}",
+		"{\"assignment_type\":\"ColorGrid\",\"data\":[{\"encoding\":\"PNG\",\"dimensions\":[1,1],\"nodes\":[\"AAAA\"]}]}",
+		"{\"assignment_type\":\"ColorGrid\",\"data\":[{\"encoding\":\"RAW\",\"dimensions\":[1],\"nodes\":[\"AAAA\"]}]}",
+		"{\"assignment_type\":\"ColorGrid\",\"data\":[{\"encoding\":\"RAW\",\"dimensions\":[2,2],\"nodes\":[\"AAAA\"]}]}",
+		"{\"assignment_type\":\"ColorGrid\",\"data\":[{\"encoding\":\"RLE\",\"dimensions\":[2,2],\"nodes\":[\"AAAA\"]}]}",
+		"{\"assignment_type\":\"ColorGrid\",\"data\":[{\"encoding\":\"RLE\",\"dimensions\":[1,1],\"nodes\":[\"AQAAAAA=\"]}]}",
+		good.substr(0, good.size() - 3),
+	};
+	for (const std::string& json : bad)
+		EXPECT_THROW(ds.getColorGridFromJSON(json), const char*) << json;
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include "FramePacer.h"
+
+using namespace bridges::game;
+
+namespace Test_FramePacer {
+	typedef std::chrono::steady_clock clock;
+
+	inline double secondsSince(clock::time_point t) {
+		return std::chrono::duration<double>(clock::now() - t).count();
+	}
+}
+
+TEST(FramePacer, PeriodIsNotTruncated) {
+	using namespace Test_FramePacer;
+	FramePacer pacer(144.);
+	EXPECT_NEAR(pacer.getFrameRate(), 144., 1e-4);
+	pacer.setFrameRate(60.);
+	EXPECT_NEAR(pacer.getFrameRate(), 60., 1e-4);
+	EXPECT_THROW(pacer.setFrameRate(0.), std::invalid_argument);
+	EXPECT_THROW(pacer.setFrameRate(-5.), std::invalid_argument);
+
+	// the deadlines are absolute: 72 frames at 144 fps last half a
+	// second, not 72 periods rounded down to the millisecond
+	pacer.setFrameRate(144.);
+	pacer.start();
+	clock::time_point t0 = clock::now();
+	for (int f = 0; f < 72; ++f)
+		pacer.wait();
+	double elapsed = secondsSince(t0);
+	EXPECT_GE(elapsed, 0.495);
+	EXPECT_LT(elapsed, 0.6);
+}
+
+TEST(FramePacer, MissedDeadlineRestartsTheSchedule) {
+	using namespace Test_FramePacer;
+	FrameStats stats;
+	FramePacer pacer(100., &stats);
+	pacer.wait();
+	// a frame that takes 5 periods
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	pacer.wait();
+	EXPECT_EQ(stats.getMissedDeadlines(), 1);
+
+	// the next frames are a period apart, not run back to back
+	clock::time_point t0 = clock::now();
+	for (int f = 0; f < 3; ++f)
+		pacer.wait();
+	EXPECT_GE(secondsSince(t0), 0.025);
+	EXPECT_EQ(stats.getMissedDeadlines(), 1);
+
+	std::vector<long> h = stats.getJitterHistogram();
+	EXPECT_EQ(std::accumulate(h.begin(), h.end(), 0L), 5);
+	// 40 ms late is past the 32768 us limit of bucket 15
+	EXPECT_GE(h[FrameStats::jitterBuckets - 1], 1);
+}
+
+TEST(FramePacer, UnpacedFramesDoNotWait) {
+	using namespace Test_FramePacer;
+	FrameStats stats;
+	FramePacer pacer(1., &stats);
+	pacer.setPaced(false);
+	EXPECT_FALSE(pacer.isPaced());
+	clock::time_point t0 = clock::now();
+	for (int f = 0; f < 1000; ++f)
+		pacer.wait();
+	EXPECT_LT(secondsSince(t0), 0.1);
+	std::vector<long> h = stats.getJitterHistogram();
+	EXPECT_EQ(std::accumulate(h.begin(), h.end(), 0L), 0);
+}
+
+TEST(FrameStats, JitterBuckets) {
+	FrameStats stats;
+	typedef std::chrono::microseconds us;
+	// bucket 0 is below 1 us, bucket i in [2^(i-1), 2^i) us
+	const long late[] = {0, 1, 2, 3, 4, 1023, 1024, 16383, 16384, 1000000};
+	const int bucket[] = {0, 1, 2, 2, 3, 10, 11, 14, 15, 15};
+	for (long l : late)
+		stats.recordJitter(us(l), l >= 16384);
+	std::vector<long> expected(FrameStats::jitterBuckets, 0);
+	for (int b : bucket)
+		++expected[b];
+	EXPECT_EQ(stats.getJitterHistogram(), expected);
+	EXPECT_EQ(stats.getMissedDeadlines(), 2);
+
+	for (size_t k = 0; k < sizeof(late) / sizeof(late[0]); ++k) {
+		int b = bucket[k];
+		if (b < FrameStats::jitterBuckets - 1)
+			EXPECT_LT(late[k] * 1e-6, FrameStats::getJitterBucketLimit(b));
+		if (b > 0)
+			EXPECT_GE(late[k] * 1e-6, FrameStats::getJitterBucketLimit(b - 1));
+	}
+	// a sub-microsecond delay is in bucket 0
+	stats.recordJitter(std::chrono::nanoseconds(999), false);
+	EXPECT_EQ(stats.getJitterHistogram()[0], 2);
+
+	stats.reset();
+	EXPECT_EQ(stats.getJitterHistogram(), std::vector<long>(FrameStats::jitterBuckets, 0));
+	EXPECT_EQ(stats.getMissedDeadlines(), 0);
+}
+
+TEST(FrameStats, Timings) {
+	FrameStats stats;
+	typedef std::chrono::milliseconds ms;
+	stats.recordUpdate(ms(2));
+	stats.recordUpdate(ms(6));
+	stats.recordEncode(ms(1));
+	FrameStats::Timing u = stats.getUpdateTime();
+	EXPECT_EQ(u.count, 2);
+	EXPECT_NEAR(u.mean(), 0.004, 1e-9);
+	EXPECT_NEAR(u.max, 0.006, 1e-9);
+	EXPECT_NEAR(u.last, 0.006, 1e-9);
+	EXPECT_EQ(stats.getEncodeTime().count, 1);
+	EXPECT_EQ(stats.getEmitTime().count, 0);
+	EXPECT_EQ(stats.getEmitTime().mean(), 0.);
+	stats.reset();
+	EXPECT_EQ(stats.getUpdateTime().count, 0);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "GameBatch.h"
+
+using namespace bridges;
+using namespace bridges::game;
+
+namespace Test_GameBatch {
+	using Test_NonBlockingGame::Painter;
+
+	/// the observation of game i
+	std::vector<unsigned char> observation(const GameBatch<Painter>& batch, size_t i) {
+		const size_t board = 3 * 8 * 8;
+		const unsigned char* obs = batch.getObservations() + i * board;
+		return std::vector<unsigned char>(obs, obs + board);
+	}
+
+	std::vector<InputEvent> keys(std::initializer_list<Key> pressed) {
+		std::vector<InputEvent> events;
+		for (Key k : pressed) {
+			std::vector<InputEvent> p = Test_NonBlockingGame::press(k);
+			events.insert(events.end(), p.begin(), p.end());
+		}
+		return events;
+	}
+}
+
+TEST(GameBatch, ObservationsAreTheBoards) {
+	using namespace Test_GameBatch;
+	ThreadPool pool(3);
+	GameBatch<Painter> batch(5);
+	batch.setThreadPool(pool);
+	EXPECT_EQ(batch.size(), 5u);
+	EXPECT_EQ(batch.getObservationShape(), (std::array<size_t, 4> {{5, 3, 8, 8}}));
+
+	std::vector<unsigned char> initial = observation(batch, 0);
+	for (size_t i = 0; i < batch.size(); ++i)
+		EXPECT_EQ(observation(batch, i), batch.get(i).board());
+
+	// each game gets its own events
+	std::vector<std::vector<InputEvent>> events(5);
+	events[1] = keys({Key::Space});
+	events[2] = keys({Key::Right, Key::Space});
+	events[3] = keys({Key::Down});
+	batch.step(events);
+	for (size_t i = 0; i < batch.size(); ++i)
+		EXPECT_EQ(observation(batch, i), batch.get(i).board()) << "game " << i;
+
+	// plane 0 holds the background colors, row-major
+	const size_t cells = 8 * 8;
+	EXPECT_EQ(observation(batch, 1)[0], 1);
+	EXPECT_EQ(observation(batch, 2)[1], 1);
+	EXPECT_EQ(observation(batch, 2)[0], initial[0]);
+	// plane 2 the symbols: the cursor moved down in game 3
+	EXPECT_EQ((NamedSymbol) observation(batch, 3)[2 * cells + 8], NamedSymbol::circle);
+	EXPECT_EQ(batch.get(3).getRow(), 1);
+	EXPECT_EQ(observation(batch, 0), observation(batch, 4));
+
+	EXPECT_THROW(batch.step(std::vector<std::vector<InputEvent>>(4)), std::invalid_argument);
+	EXPECT_THROW(batch.step(std::vector<std::vector<InputEvent>>(6)), std::invalid_argument);
+	EXPECT_THROW(GameBatch<Painter>(0), std::invalid_argument);
+}
+
+TEST(GameBatch, FinishedGamesRestart) {
+	using namespace Test_GameBatch;
+	GameBatch<Painter> batch(3);
+	std::vector<unsigned char> initial = observation(batch, 0);
+
+	std::vector<std::vector<InputEvent>> events(3);
+	events[0] = keys({Key::Space});
+	events[1] = keys({Key::Space, Key::Q});
+	batch.step(events);
+	EXPECT_EQ(batch.getDone()[0], 0);
+	EXPECT_EQ(batch.getDone()[1], 1);
+	EXPECT_EQ(batch.getDone()[2], 0);
+
+	// the observation of the game that ended is its first frame
+	EXPECT_FALSE(batch.get(1).isGameOver());
+	EXPECT_EQ(batch.get(1).getFrameNumber(), 0);
+	EXPECT_EQ(observation(batch, 1), initial);
+	EXPECT_NE(observation(batch, 0), initial);
+
+	batch.step();
+	EXPECT_EQ(batch.getDone()[1], 0);
+	EXPECT_EQ(batch.get(1).getFrameNumber(), 1);
+
+	// games stopped by their own rule restart too
+	GameBatch<Painter> timed(2, 3L);
+	std::string doneFrames;
+	for (int s = 0; s < 8; ++s) {
+		timed.step();
+		doneFrames += timed.getDone()[0] ? 'x' : '.';
+		EXPECT_EQ(timed.getDone()[0], timed.getDone()[1]);
+	}
+	EXPECT_EQ(doneFrames, "...x...x");
+}
+
+TEST(GameBatch, WithoutAutoResetFinishedGamesAreSkipped) {
+	using namespace Test_GameBatch;
+	GameBatch<Painter> batch(2);
+	batch.setAutoReset(false);
+	std::vector<unsigned char> initial = observation(batch, 0);
+
+	std::vector<std::vector<InputEvent>> events(2);
+	events[0] = keys({Key::Right, Key::Space, Key::Q});
+	batch.step(events);
+	EXPECT_EQ(batch.getDone()[0], 1);
+	EXPECT_TRUE(batch.get(0).isGameOver());
+	std::vector<unsigned char> last = observation(batch, 0);
+	EXPECT_EQ(last, batch.get(0).board());
+	long frame = batch.get(0).getFrameNumber();
+
+	// the game stays over, reported done once
+	events[0] = keys({Key::Down, Key::Space});
+	batch.step(events);
+	EXPECT_EQ(batch.getDone()[0], 0);
+	EXPECT_TRUE(batch.get(0).isGameOver());
+	EXPECT_EQ(batch.get(0).getFrameNumber(), frame);
+	EXPECT_EQ(observation(batch, 0), last);
+	EXPECT_EQ(batch.get(1).getFrameNumber(), 2);
+
+	batch.reset(0);
+	EXPECT_FALSE(batch.get(0).isGameOver());
+	EXPECT_EQ(observation(batch, 0), initial);
+	batch.step(events);
+	EXPECT_EQ(batch.get(0).getRow(), 1);
+
+	batch.reset();
+	EXPECT_EQ(observation(batch, 0), initial);
+	EXPECT_EQ(observation(batch, 1), initial);
+}
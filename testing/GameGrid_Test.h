@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "GameGrid.h"
+#include "base64.h"
+#include "rapidjson/document.h"
+
+using namespace bridges::game;
+
+TEST(GameGrid, BracketsReadAndWriteCells) {
+	GameGrid g(4, 5);
+	g[1][2].setBGColor(NamedColor::red);
+	g[1][2].setSymbol(NamedSymbol::heart);
+	g[3][4] = GameCell(NamedColor::blue, NamedColor::green, NamedSymbol::star);
+
+	EXPECT_EQ(g.getBGColor(1, 2), NamedColor::red);
+	EXPECT_EQ(g.getSymbol(1, 2), NamedSymbol::heart);
+	EXPECT_EQ(g[1][2].getBGColor(), NamedColor::red);
+
+	const GameGrid& cg = g;
+	GameCell c = cg[3][4];
+	EXPECT_EQ(c.getBGColor(), NamedColor::blue);
+	EXPECT_EQ(c.getFGColor(), NamedColor::green);
+	EXPECT_EQ(c.getSymbol(), NamedSymbol::star);
+
+	// the cells written through the brackets are part of the next delta
+	EXPECT_EQ(g.getChangedCellCount(), 2u);
+
+	g[0][0] = g[3][4];
+	EXPECT_EQ(g.getSymbol(0, 0), NamedSymbol::star);
+
+	EXPECT_THROW(g[4][0].setBGColor(NamedColor::red), std::out_of_range);
+	EXPECT_THROW(cg[0][-1], std::out_of_range);
+}
+
+TEST(GameGrid, CopiesAreIndependent) {
+	GameGrid g(3, 3);
+	g.setDeltaFrames(true, 10);
+	g.setBGColor(0, 0, NamedColor::red);
+
+	GameGrid copy(g);
+	EXPECT_EQ(copy.getBGColor(0, 0), NamedColor::red);
+	EXPECT_EQ(copy.getChangedCellCount(), 0u);
+
+	copy.setBGColor(0, 0, NamedColor::blue);
+	g.setBGColor(1, 1, NamedColor::green);
+	EXPECT_EQ(g.getBGColor(0, 0), NamedColor::red);
+	EXPECT_EQ(copy.getBGColor(1, 1), NamedColor::black);
+
+	GameGrid other(7, 2);
+	other = g;
+	EXPECT_EQ(other.getDimensions()[0], 3);
+	EXPECT_EQ(other.getDimensions()[1], 3);
+	EXPECT_EQ(other.getBGColor(1, 1), NamedColor::green);
+	g.fill(GameCell());
+	EXPECT_EQ(other.getBGColor(1, 1), NamedColor::green);
+	EXPECT_EQ(g.getFGColor(2, 2), NamedColor::white);
+}
+
+TEST(GameGrid, CopyCellsDoesNotRecordChanges) {
+	GameGrid g(3, 4);
+	g.setDeltaFrames(true, 5);
+	g.setSymbol(2, 3, NamedSymbol::circle);
+
+	GameGrid buffer(3, 4);
+	buffer.copyCells(g);
+	EXPECT_EQ(buffer.getSymbol(2, 3), NamedSymbol::circle);
+	EXPECT_EQ(buffer.getChangedCellCount(), 0u);
+
+	// the sent grid still sees the difference with its previous frame
+	GameGrid sent(3, 4);
+	sent.copyFrom(buffer);
+	EXPECT_EQ(sent.getChangedCellCount(), 1u);
+
+	EXPECT_THROW(buffer.copyCells(GameGrid(4, 3)), std::invalid_argument);
+}
+
+TEST(GameGrid, SnapshotIsIsolatedFromTheGrid) {
+	GameGrid g(4, 4);
+	g.setBGColor(1, 1, NamedColor::red);
+	GameGrid::Snapshot s = g.snapshot();
+
+	// writing to the grid copies the cells it shares with the snapshot
+	g.setBGColor(1, 1, NamedColor::blue);
+	g.setSymbol(2, 2, NamedSymbol::star);
+
+	GameGrid other(4, 4);
+	other.restore(s);
+	EXPECT_EQ(other.getBGColor(1, 1), NamedColor::red);
+	EXPECT_EQ(other.getSymbol(2, 2), NamedSymbol::none);
+
+	// nor does writing to a grid restored from the snapshot change it
+	other.setBGColor(0, 0, NamedColor::green);
+	g.restore(s);
+	EXPECT_EQ(g.getBGColor(1, 1), NamedColor::red);
+	EXPECT_EQ(g.getBGColor(0, 0), NamedColor::black);
+	EXPECT_EQ(g.getSymbol(2, 2), NamedSymbol::none);
+	EXPECT_EQ(other.getBGColor(0, 0), NamedColor::green);
+
+	EXPECT_THROW(GameGrid(4, 5).restore(s), std::invalid_argument);
+	EXPECT_THROW(g.restore(GameGrid::Snapshot()), std::invalid_argument);
+}
+
+namespace Test_GameGrid {
+	inline std::string decode(const std::string& b64) {
+		std::string out(bridges::base64::decodedLength(b64.size()) + 16, '\0');
+		out.resize(bridges::base64::decode(b64.data(), b64.size(), (bridges::BYTE*) &out[0]));
+		return out;
+	}
+
+	/// a frame, in the form of the buffers of getFrameBuffers()
+	inline GameGrid::FrameBuffers parseFrame(const std::string& rep) {
+		rapidjson::Document d;
+		d.Parse(("{" + rep).c_str());
+		EXPECT_FALSE(d.HasParseError());
+		GameGrid::FrameBuffers f;
+		f.keyframe = std::string(d["encoding"].GetString()) != "delta";
+		EXPECT_EQ(d.HasMember("cells"), !f.keyframe);
+		if (!f.keyframe)
+			f.cells = decode(d["cells"].GetString());
+		f.bg = decode(d["bg"].GetString());
+		f.fg = decode(d["fg"].GetString());
+		f.symbols = decode(d["symbols"].GetString());
+		return f;
+	}
+
+	/// the next frame of g, from the JSON or the binary representation
+	inline GameGrid::FrameBuffers nextFrame(const GameGrid& g, bool json) {
+		if (json)
+			return parseFrame(g.getFrameRepresentation());
+		GameGrid::FrameBuffers f;
+		g.getFrameBuffers(f);
+		return f;
+	}
+
+	inline std::vector<unsigned int> indices(const std::string& cells) {
+		EXPECT_EQ(cells.size() % 4, 0u);
+		std::vector<unsigned int> idx;
+		for (size_t k = 0; k + 4 <= cells.size(); k += 4) {
+			const unsigned char* p = (const unsigned char*) &cells[k];
+			idx.push_back(p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24));
+		}
+		return idx;
+	}
+}
+
+TEST(GameGrid, DeltaFramesHoldTheChangedCells) {
+	using namespace Test_GameGrid;
+	for (bool json : {true, false}) {
+		SCOPED_TRACE(json ? "JSON" : "buffers");
+		// indices above 65535 need the third byte
+		GameGrid g(300, 300);
+		g.setDeltaFrames(true, 100);
+		g.setBGColor(0, 0, NamedColor::red);
+		GameGrid::FrameBuffers f = nextFrame(g, json);
+		ASSERT_TRUE(f.keyframe);
+		EXPECT_TRUE(f.cells.empty());
+		ASSERT_EQ(f.bg.size(), 90000u);
+		EXPECT_EQ((NamedColor) f.bg[0], NamedColor::red);
+		EXPECT_EQ((NamedColor) f.bg[1], NamedColor::black);
+
+		g.setBGColor(299, 299, NamedColor::blue);
+		g.drawSymbol(5, 3, NamedSymbol::star, NamedColor::green);
+		g.setBGColor(0, 0, NamedColor::red);      // unchanged
+		g.setFGColor(299, 299, NamedColor::white); // already recorded
+		f = nextFrame(g, json);
+		ASSERT_FALSE(f.keyframe);
+		EXPECT_EQ(indices(f.cells), (std::vector<unsigned int> {89999, 1503}));
+		ASSERT_EQ(f.bg.size(), 2u);
+		ASSERT_EQ(f.fg.size(), 2u);
+		ASSERT_EQ(f.symbols.size(), 2u);
+		EXPECT_EQ((NamedColor) f.bg[0], NamedColor::blue);
+		EXPECT_EQ((NamedColor) f.fg[0], NamedColor::white);
+		EXPECT_EQ((NamedSymbol) f.symbols[0], NamedSymbol::none);
+		EXPECT_EQ((NamedColor) f.bg[1], NamedColor::black);
+		EXPECT_EQ((NamedColor) f.fg[1], NamedColor::green);
+		EXPECT_EQ((NamedSymbol) f.symbols[1], NamedSymbol::star);
+
+		// the changes were forgotten
+		f = nextFrame(g, json);
+		ASSERT_FALSE(f.keyframe);
+		EXPECT_TRUE(f.cells.empty());
+		EXPECT_TRUE(f.bg.empty());
+	}
+}
+
+TEST(GameGrid, DeltaFramesHaveKeyframes) {
+	using namespace Test_GameGrid;
+	for (bool json : {true, false}) {
+		GameGrid g(8, 8);
+		g.setDeltaFrames(true, 3);
+		std::string kinds;
+		for (int frame = 0; frame < 7; ++frame) {
+			g.setSymbol(frame, frame, NamedSymbol::circle);
+			kinds += nextFrame(g, json).keyframe ? 'K' : 'D';
+		}
+		EXPECT_EQ(kinds, "KDDKDDK") << (json ? "JSON" : "buffers");
+
+		// changing the settings starts with a keyframe
+		g.setDeltaFrames(true, 3);
+		EXPECT_TRUE(nextFrame(g, json).keyframe);
+		EXPECT_FALSE(nextFrame(g, json).keyframe);
+		g.setDeltaFrames(false);
+		EXPECT_TRUE(nextFrame(g, json).keyframe);
+		EXPECT_TRUE(nextFrame(g, json).keyframe);
+	}
+}
+
+TEST(GameGrid, MoreThanAQuarterChangedIsAFullFrame) {
+	using namespace Test_GameGrid;
+	for (bool json : {true, false}) {
+		SCOPED_TRACE(json ? "JSON" : "buffers");
+		GameGrid g(4, 5);
+		g.setDeltaFrames(true, 100);
+		nextFrame(g, json);
+
+		// 5 of 20 cells is a quarter
+		for (int c = 0; c < 5; ++c)
+			g.setBGColor(1, c, NamedColor::red);
+		GameGrid::FrameBuffers f = nextFrame(g, json);
+		ASSERT_FALSE(f.keyframe);
+		EXPECT_EQ(indices(f.cells), (std::vector<unsigned int> {5, 6, 7, 8, 9}));
+
+		for (int c = 0; c < 5; ++c)
+			g.setBGColor(2, c, NamedColor::blue);
+		g.setBGColor(3, 0, NamedColor::blue);
+		f = nextFrame(g, json);
+		ASSERT_TRUE(f.keyframe);
+		ASSERT_EQ(f.bg.size(), 20u);
+		EXPECT_EQ((NamedColor) f.bg[7], NamedColor::red);
+		EXPECT_EQ((NamedColor) f.bg[15], NamedColor::blue);
+		EXPECT_EQ((NamedColor) f.bg[16], NamedColor::black);
+
+		// the changes sent in the full frame are forgotten
+		EXPECT_FALSE(nextFrame(g, json).keyframe);
+	}
+}
@@ -0,0 +1,11 @@
+// Unit tests of the game API, with GoogleTest. The games include the
+// socket.io client, see SIO_INCL and SIO_LIBS in the Makefile.
+//
+//   make game_tests && ./game_tests
+
+#include "InputStateMachine_Test.h"
+#include "NonBlockingGame_Test.h"
+#include "NonBlockingGame3D_Test.h"
+#include "HeadlessTransport_Test.h"
+#include "SocketConnection_Test.h"
+#include "GameBatch_Test.h"
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "Grid.h"
+
+using namespace bridges;
+using namespace bridges::datastructure;
+
+namespace Test_Grid {
+	/// Grid is abstract, the representation is not tested here
+	template <typename E>
+	class TestGrid : public Grid<E> {
+		public:
+			using Grid<E>::Grid;
+			virtual const string getDataStructureRepresentation() const override {
+				return "";
+			}
+	};
+
+	/// counts the live objects, to check that cells are built and destroyed once
+	struct Counted {
+		static int live;
+		std::string value;
+		Counted() : value("cell") {
+			++live;
+		}
+		Counted(const Counted& c) : value(c.value) {
+			++live;
+		}
+		Counted& operator= (const Counted&) = default;
+		~Counted() {
+			--live;
+		}
+	};
+	int Counted::live = 0;
+
+	template <typename E>
+	bool aligned(const Grid<E>& g) {
+		return reinterpret_cast<std::uintptr_t>(g.data()) % 64 == 0;
+	}
+
+	inline TestGrid<int> numbered(int rows, int cols) {
+		TestGrid<int> g(rows, cols);
+		for (int i = 0; i < rows; ++i)
+			for (int j = 0; j < cols; ++j)
+				g.set(i, j, i * 1000 + j);
+		return g;
+	}
+
+	inline void expectNumbered(const Grid<int>& g, int rows, int cols) {
+		for (int i = 0; i < rows; ++i)
+			for (int j = 0; j < cols; ++j)
+				ASSERT_EQ(g.get(i, j), i * 1000 + j);
+	}
+}
+
+TEST(Grid, CellsAreAlignedAndValueInitialized) {
+	using namespace Test_Grid;
+	for (int cols : {1, 3, 17, 64}) {
+		TestGrid<int> g(5, cols);
+		EXPECT_TRUE(aligned(g));
+		for (int i = 0; i < 5 * cols; ++i)
+			ASSERT_EQ(g.data()[i], 0);
+	}
+	TestGrid<char> c(3, 7);
+	EXPECT_TRUE(aligned(c));
+	TestGrid<int> empty(0, 5);
+	EXPECT_EQ(empty.data(), nullptr);
+}
+
+TEST(Grid, CopyMoveAndSelfAssignment) {
+	using namespace Test_Grid;
+	TestGrid<int> a = numbered(4, 6);
+	TestGrid<int> b(a);
+	expectNumbered(b, 4, 6);
+	EXPECT_NE(a.data(), b.data());
+	EXPECT_TRUE(aligned(b));
+	b.set(0, 0, -1);
+	EXPECT_EQ(a.get(0, 0), 0);
+
+	// assignment resizes
+	TestGrid<int> c(2, 2);
+	c = a;
+	EXPECT_EQ(c.getDimensions()[0], 4);
+	EXPECT_EQ(c.getDimensions()[1], 6);
+	expectNumbered(c, 4, 6);
+
+	TestGrid<int>& same = c;
+	c = same;
+	expectNumbered(c, 4, 6);
+
+	int* cells = a.data();
+	TestGrid<int> d(std::move(a));
+	EXPECT_EQ(d.data(), cells);
+	EXPECT_EQ(a.data(), nullptr);
+	EXPECT_EQ(a.getDimensions()[0], 0);
+	expectNumbered(d, 4, 6);
+
+	TestGrid<int> e(1, 1);
+	e = std::move(d);
+	EXPECT_EQ(e.data(), cells);
+	EXPECT_EQ(d.data(), nullptr);
+	e = std::move(static_cast<TestGrid<int>&>(e));
+	EXPECT_EQ(e.data(), cells);
+	expectNumbered(e, 4, 6);
+
+	// a moved-from grid can be used again
+	a = numbered(2, 3);
+	expectNumbered(a, 2, 3);
+}
+
+TEST(Grid, NonTrivialCellsAreBuiltAndDestroyedOnce) {
+	using namespace Test_Grid;
+	Counted::live = 0;
+	{
+		TestGrid<Counted> a(3, 5);
+		EXPECT_EQ(Counted::live, 15);
+		a.getUnchecked(1, 2).value = "changed";
+		TestGrid<Counted> b(a);
+		EXPECT_EQ(Counted::live, 30);
+		EXPECT_EQ(b.get(1, 2).value, "changed");
+		b.setDimensions(2, 2);
+		EXPECT_EQ(Counted::live, 19);
+		b = a;
+		EXPECT_EQ(Counted::live, 30);
+		EXPECT_EQ(b.get(1, 2).value, "changed");
+		TestGrid<Counted> c(std::move(b));
+		EXPECT_EQ(Counted::live, 30);
+	}
+	EXPECT_EQ(Counted::live, 0);
+}
+
+TEST(Grid, SetDimensionsThrowsInsteadOfExiting) {
+	using namespace Test_Grid;
+	TestGrid<int> g = numbered(3, 3);
+	EXPECT_THROW(g.setDimensions(1081, 10), std::invalid_argument);
+	EXPECT_THROW(g.setDimensions(10, 1921), std::invalid_argument);
+	EXPECT_THROW(g.setDimensions(-1, 10), std::invalid_argument);
+	EXPECT_THROW((TestGrid<int>(2000, 2000)), std::invalid_argument);
+	// a failed resize leaves the grid as it was
+	expectNumbered(g, 3, 3);
+
+	g.setDimensions(1080, 1920);
+	EXPECT_EQ(g.getDimensions()[0], 1080);
+	EXPECT_EQ(g.getDimensions()[1], 1920);
+	EXPECT_TRUE(aligned(g));
+	EXPECT_EQ(g.get(1079, 1919), 0);
+}
+
+TEST(Grid, RowViews) {
+	using namespace Test_Grid;
+	TestGrid<int> g = numbered(4, 5);
+	auto r = g.row(2);
+	EXPECT_EQ(r.size(), 5);
+	EXPECT_EQ(r.data(), g.data() + 10);
+	EXPECT_EQ(r.end() - r.begin(), 5);
+	int j = 0;
+	for (int v : r)
+		EXPECT_EQ(v, 2000 + j++);
+	r[4] = 7;
+	EXPECT_EQ(g.get(2, 4), 7);
+
+	const TestGrid<int>& cg = g;
+	auto cr = cg.row(3);
+	EXPECT_EQ(cr[0], 3000);
+	static_assert(std::is_same<decltype(cr[0]), const int&>::value, "const rows are read-only");
+
+	EXPECT_THROW(g.row(4), const char*);
+	EXPECT_THROW(cg.row(-1), const char*);
+}
+
+TEST(Grid, OutOfRangeAccessThrows) {
+	using namespace Test_Grid;
+	TestGrid<int> g = numbered(3, 4);
+	const TestGrid<int>& cg = g;
+	const int bad[][2] = {{-1, 0}, {0, -1}, {3, 0}, {0, 4}, {3, 4}};
+	for (auto& b : bad) {
+		EXPECT_THROW(g.get(b[0], b[1]), const char*);
+		EXPECT_THROW(g.set(b[0], b[1], 1), const char*);
+		EXPECT_THROW(g[b[0]][b[1]], const char*);
+		EXPECT_THROW(cg[b[0]][b[1]], const char*);
+	}
+	g[2][3] = 5;
+	EXPECT_EQ(cg[2][3], 5);
+	EXPECT_EQ(g.getUnchecked(2, 3), 5);
+	g.setUnchecked(0, 0, 9);
+	EXPECT_EQ(g.get(0, 0), 9);
+}
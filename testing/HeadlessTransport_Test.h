@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HeadlessTransport.h"
+#include "rapidjson/document.h"
+
+using namespace bridges::game;
+
+namespace Test_HeadlessTransport {
+	/// records the events it gets and the thread they come from
+	struct Recorder : public KeypressListener {
+		std::vector<InputEvent> events;
+		std::vector<std::thread::id> threads;
+		void keyEvent(const InputEvent& e) override {
+			events.push_back(e);
+			threads.push_back(std::this_thread::get_id());
+		}
+	};
+
+	inline std::vector<std::string> lines(const std::string& filename) {
+		std::ifstream in(filename);
+		std::vector<std::string> out;
+		std::string line;
+		while (std::getline(in, line))
+			out.push_back(line);
+		return out;
+	}
+}
+
+TEST(HeadlessTransport, ScriptedEventsArriveAtTheirFrame) {
+	using namespace Test_HeadlessTransport;
+	HeadlessTransport t;
+	Recorder r;
+	t.registerKeyListener(&r);
+	t.addKeyEvent(3, Key::Up, true);
+	t.addKeyEvent(1, Key::Down, true);
+	t.addKeyEvent(3, Key::Up, false);
+	t.addKeyEvent(5, Key::Left, true);
+	EXPECT_THROW(t.addKeyEvent(0, Key::Unknown, true), std::invalid_argument);
+
+	t.frameStart(0);
+	EXPECT_TRUE(r.events.empty());
+	t.frameStart(1);
+	ASSERT_EQ(r.events.size(), 1u);
+	EXPECT_EQ(r.events[0].key, Key::Down);
+
+	// the events of skipped frames arrive late, scripted before injected
+	t.pressKey(Key::Space, true);
+	t.frameStart(4);
+	ASSERT_EQ(r.events.size(), 4u);
+	EXPECT_EQ(r.events[1].key, Key::Up);
+	EXPECT_TRUE(r.events[1].pressed);
+	EXPECT_EQ(r.events[2].key, Key::Up);
+	EXPECT_FALSE(r.events[2].pressed);
+	EXPECT_EQ(r.events[3].key, Key::Space);
+	t.frameStart(4);
+	EXPECT_EQ(r.events.size(), 4u);
+}
+
+TEST(HeadlessTransport, KeysInjectedFromAnotherThread) {
+	using namespace Test_HeadlessTransport;
+	HeadlessTransport t;
+	Recorder r;
+	t.registerKeyListener(&r);
+	const int presses = 20000;
+	std::atomic<bool> done(false);
+	std::thread agent([&]() {
+		for (int k = 0; k < presses; ++k)
+			t.pressKey((Key) (k % 10), k % 2 == 0);
+		done = true;
+	});
+	long frame = 0;
+	while (!done)
+		t.frameStart(frame++);
+	agent.join();
+	t.frameStart(frame);
+
+	// every event once, in order, on the game thread
+	ASSERT_EQ(r.events.size(), (size_t) presses);
+	for (int k = 0; k < presses; ++k) {
+		ASSERT_EQ(r.events[k].key, (Key) (k % 10));
+		ASSERT_EQ(r.events[k].pressed, k % 2 == 0);
+		ASSERT_EQ(r.threads[k], std::this_thread::get_id());
+	}
+}
+
+TEST(HeadlessTransport, LoadsScriptsInTheInputLogFormat) {
+	using namespace Test_HeadlessTransport;
+	std::string file = testing::TempDir() + "headless_script.txt";
+	{
+		std::ofstream out(file);
+		out << "# a comment\n2 space down\n2 space up\n\n0 q down\n";
+	}
+	HeadlessTransport t;
+	Recorder r;
+	t.registerKeyListener(&r);
+	t.loadScript(file);
+	t.frameStart(0);
+	ASSERT_EQ(r.events.size(), 1u);
+	EXPECT_EQ(r.events[0].key, Key::Q);
+	t.frameStart(1);
+	t.frameStart(2);
+	ASSERT_EQ(r.events.size(), 3u);
+	EXPECT_EQ(r.events[1].key, Key::Space);
+	EXPECT_TRUE(r.events[1].pressed);
+	EXPECT_FALSE(r.events[2].pressed);
+
+	{
+		std::ofstream out(file);
+		out << "2 jump down\n";
+	}
+	EXPECT_THROW(t.loadScript(file), std::runtime_error);
+	std::remove(file.c_str());
+	EXPECT_THROW(t.loadScript(file), std::runtime_error);
+}
+
+TEST(HeadlessTransport, RecordsOneJSONFramePerLine) {
+	using namespace Test_HeadlessTransport;
+	std::string file = testing::TempDir() + "headless_frames.jsonl";
+	HeadlessTransport t;
+	GameGrid g(4, 4);
+	g.setDeltaFrames(true, 100);
+
+	// not recorded, not encoded: the change is in the next recorded frame
+	t.sendDataToServer(g);
+	g.setBGColor(0, 1, NamedColor::red);
+
+	t.recordTo(file);
+	t.sendDataToServer(g);
+	g.setBGColor(2, 2, NamedColor::blue);
+	t.sendDataToServer(g);
+	t.sendDataToServer(g);
+	EXPECT_EQ(t.getFrameCount(), 4);
+	EXPECT_TRUE(t.getFrames().empty());
+	t.recordTo(file + ".next");
+
+	std::vector<std::string> frames = lines(file);
+	ASSERT_EQ(frames.size(), 3u);
+	const char* encodings[] = {"raw", "delta", "delta"};
+	for (size_t f = 0; f < frames.size(); ++f) {
+		rapidjson::Document d;
+		d.Parse(frames[f].c_str());
+		ASSERT_FALSE(d.HasParseError()) << frames[f];
+		EXPECT_STREQ(d["encoding"].GetString(), encodings[f]);
+	}
+	std::remove(file.c_str());
+	std::remove((file + ".next").c_str());
+
+	EXPECT_THROW(t.recordTo(testing::TempDir() + "no/such/dir/frames.jsonl"), std::runtime_error);
+}
+
+TEST(HeadlessTransport, KeepsTheLastFrames) {
+	HeadlessTransport t(2);
+	GameGrid g(2, 2);
+	for (int f = 0; f < 3; ++f) {
+		g.setBGColor(0, 0, static_cast<NamedColor>(f + 1));
+		t.sendDataToServer(g);
+	}
+	ASSERT_EQ(t.getFrames().size(), 2u);
+	GameGrid expected(2, 2);
+	expected.setBGColor(0, 0, static_cast<NamedColor>(2));
+	EXPECT_EQ(t.getFrames()[0], "{" + bridges::datastructure::RepresentationAccess::get(expected));
+	expected.setBGColor(0, 0, static_cast<NamedColor>(3));
+	EXPECT_EQ(t.getFrames()[1], "{" + bridges::datastructure::RepresentationAccess::get(expected));
+}
+
+TEST(HeadlessTransport, AgentPlaysARecordedGame) {
+	using namespace Test_HeadlessTransport;
+	using Test_NonBlockingGame::Painter;
+	std::string file = testing::TempDir() + "headless_game.jsonl";
+	long sent;
+	{
+		auto t = std::make_shared<HeadlessTransport>();
+		t->recordTo(file);
+		Painter game(t);
+
+		// the game runs until the agent, on its own thread, presses q
+		std::thread agent([&]() {
+			t->pressKey(Key::Right, true);
+			t->pressKey(Key::Right, false);
+			t->pressKey(Key::Space, true);
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			t->pressKey(Key::Q, true);
+		});
+		game.start();
+		agent.join();
+		EXPECT_TRUE(game.isGameOver());
+		EXPECT_EQ(game.getCol(), 1);
+		sent = t->getFrameCount();
+	}
+
+	// the recording is complete once the transport is destroyed
+	std::vector<std::string> frames = lines(file);
+	std::remove(file.c_str());
+	EXPECT_EQ((long) frames.size(), sent);
+	ASSERT_FALSE(frames.empty());
+	rapidjson::Document d;
+	d.Parse(frames.back().c_str());
+	EXPECT_FALSE(d.HasParseError());
+}
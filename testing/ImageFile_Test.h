@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ImageFile.h"
+
+using namespace bridges;
+using namespace bridges::datastructure;
+
+namespace Test_ImageFile {
+	inline std::string path(const std::string& name) {
+		return testing::TempDir() + "bridges_imagefile_" + name;
+	}
+
+	inline std::string writeBytes(const std::string& name, const std::vector<unsigned char>& bytes) {
+		std::string p = path(name);
+		std::ofstream out(p, std::ios::binary);
+		out.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize) bytes.size());
+		return p;
+	}
+
+	inline std::string writeText(const std::string& name, const std::string& text) {
+		return writeBytes(name, std::vector<unsigned char>(text.begin(), text.end()));
+	}
+
+	inline void le16(std::vector<unsigned char>& out, unsigned v) {
+		out.push_back((unsigned char) v);
+		out.push_back((unsigned char) (v >> 8));
+	}
+
+	inline void le32(std::vector<unsigned char>& out, uint32_t v) {
+		for (int i = 0; i < 4; ++i)
+			out.push_back((unsigned char) (v >> (8 * i)));
+	}
+
+	/// file and BITMAPINFOHEADER of a BMP, followed by the masks
+	inline std::vector<unsigned char> bmpHeader(int width, int height, int bpp, uint32_t compression,
+		const std::vector<uint32_t>& masks, uint32_t pixelBytes) {
+		std::vector<unsigned char> b = {'B', 'M'};
+		uint32_t offset = 14 + 40 + 4 * (uint32_t) masks.size();
+		le32(b, offset + pixelBytes);
+		le32(b, 0);
+		le32(b, offset);
+		le32(b, 40);
+		le32(b, (uint32_t) width);
+		le32(b, (uint32_t) height);
+		le16(b, 1);
+		le16(b, bpp);
+		le32(b, compression);
+		le32(b, pixelBytes);
+		le32(b, 2835);
+		le32(b, 2835);
+		le32(b, 0);
+		le32(b, 0);
+		for (uint32_t m : masks)
+			le32(b, m);
+		return b;
+	}
+
+	inline ColorGrid pattern(int rows, int cols) {
+		ColorGrid cg(rows, cols);
+		for (int i = 0; i < rows; ++i)
+			for (int j = 0; j < cols; ++j)
+				cg.set(i, j, Color((i * 40 + j) % 256, (j * 70) % 256, (i * j * 3) % 256, (i + j * 9) % 256));
+		return cg;
+	}
+
+	inline void expectSameImage(const ColorGrid& actual, const ColorGrid& expected, bool alpha) {
+		ASSERT_EQ(actual.getHeight(), expected.getHeight());
+		ASSERT_EQ(actual.getWidth(), expected.getWidth());
+		for (int i = 0; i < expected.getHeight(); ++i)
+			for (int j = 0; j < expected.getWidth(); ++j) {
+				Color e = expected.get(i, j);
+				if (!alpha)
+					e = Color(e.getRed(), e.getGreen(), e.getBlue(), 255);
+				ASSERT_EQ(actual.get(i, j), e) << "pixel " << i << ", " << j;
+			}
+	}
+}
+
+TEST(ImageFile, WriteThenReadEveryFormat) {
+	using namespace Test_ImageFile;
+	// odd widths exercise the padding of the BMP rows
+	for (int cols : {1, 3, 5, 64}) {
+		ColorGrid cg = pattern(7, cols);
+		std::string name = std::to_string(cols);
+		ImageFile::write(cg, path(name + ".ppm"));
+		expectSameImage(ImageFile::read(path(name + ".ppm")), cg, false);
+		ImageFile::write(cg, path(name + ".PAM"));
+		expectSameImage(ImageFile::read(path(name + ".PAM")), cg, true);
+		ImageFile::write(cg, path(name + ".bmp"));
+		expectSameImage(ImageFile::read(path(name + ".bmp")), cg, true);
+		for (const char* ext : {".ppm", ".PAM", ".bmp"})
+			std::remove(path(name + ext).c_str());
+	}
+	EXPECT_THROW(ImageFile::write(pattern(2, 2), path("x.png")), std::runtime_error);
+}
+
+TEST(ImageFile, ReadsEveryNetpbmVariant) {
+	using namespace Test_ImageFile;
+	// ASCII gray with comments and maxval 15
+	ColorGrid g = ImageFile::read(writeText("p2.pgm", "P2\n# comment\n3 1 # width height\n15\n0 15 5\n"));
+	expectSameImage(g, [] {
+		ColorGrid e(1, 3);
+		e.set(0, 0, Color(0, 0, 0));
+		e.set(0, 1, Color(255, 255, 255));
+		e.set(0, 2, Color(85, 85, 85));
+		return e;
+	}(), true);
+
+	ColorGrid p3 = ImageFile::read(writeText("p3.ppm", "P3 2 1 255\n1 2 3  4 5 6\n"));
+	EXPECT_EQ(p3.get(0, 0), Color(1, 2, 3));
+	EXPECT_EQ(p3.get(0, 1), Color(4, 5, 6));
+
+	// 16-bit binary gray, big-endian samples
+	ColorGrid p5 = ImageFile::read(writeBytes("p5.pgm", {'P', '5', ' ', '2', ' ', '1', ' ', '6', '5', '5', '3', '5', '\n',
+				0xFF, 0xFF, 0x80, 0x00
+			}));
+	EXPECT_EQ(p5.get(0, 0), Color(255, 255, 255));
+	EXPECT_EQ(p5.get(0, 1), Color(128, 128, 128));
+
+	// gray and alpha PAM
+	ColorGrid pam = ImageFile::read(writeBytes("ga.pam", [] {
+		std::string h = "P7\nWIDTH 1\nHEIGHT 2\nDEPTH 2\nMAXVAL 255\nTUPLTYPE GRAYSCALE_ALPHA\nENDHDR\n";
+		std::vector<unsigned char> b(h.begin(), h.end());
+		b.insert(b.end(), {10, 20, 30, 40});
+		return b;
+	}()));
+	EXPECT_EQ(pam.get(0, 0), Color(10, 10, 10, 20));
+	EXPECT_EQ(pam.get(1, 0), Color(30, 30, 30, 40));
+
+	EXPECT_THROW(ImageFile::read(writeText("big.pgm", "P2 2 1 15\n0 16\n")), std::runtime_error);
+	for (const char* n : {"p2.pgm", "p3.ppm", "p5.pgm", "ga.pam", "big.pgm"})
+		std::remove(path(n).c_str());
+}
+
+TEST(ImageFile, TruncatedFilesThrowRuntimeError) {
+	using namespace Test_ImageFile;
+	const std::vector<std::string> headers = {
+		"P6", "P6\n4", "P6\n4 4", "P6\n4 4 255", "P6\n4 4 255\n\x01\x02",
+		"P3 2 2 255\n1 2 3", "P7\nWIDTH 2\nHEIGHT 2\n", "P7\nWIDTH 2\nHEIGHT 2\nDEPTH 3\nMAXVAL 255\nENDHDR",
+		"P6 -4 4 255\n", "P6 0 4 255\n", "P6 4 4 0\n", "P7\nWIDTH 1\nHEIGHT 1\nDEPTH 9\nMAXVAL 255\nENDHDR\n",
+		"BM", "XY",
+	};
+	for (size_t k = 0; k < headers.size(); ++k) {
+		std::string p = writeText("truncated" + std::to_string(k), headers[k]);
+		EXPECT_THROW(ImageFile::read(p), std::runtime_error) << headers[k];
+		std::remove(p.c_str());
+	}
+
+	// a BMP header without all its rows
+	std::vector<unsigned char> bmp = bmpHeader(4, 4, 24, 0, {}, 48);
+	bmp.resize(bmp.size() + 36);
+	std::string p = writeBytes("short.bmp", bmp);
+	EXPECT_THROW(ImageFile::read(p), std::runtime_error);
+	std::remove(p.c_str());
+	EXPECT_THROW(ImageFile::read(path("missing.ppm")), std::runtime_error);
+}
+
+TEST(ImageFile, OversizedImagesThrowRuntimeError) {
+	using namespace Test_ImageFile;
+	for (const char* header : {"P6 1921 1 255\n", "P6 1 1081 255\n", "P7\nWIDTH 4000\nHEIGHT 1\nDEPTH 3\nMAXVAL 255\nENDHDR\n"}) {
+		std::string p = writeText("oversized", header);
+		EXPECT_THROW(ImageFile::read(p), std::runtime_error) << header;
+		try {
+			ImageFile::read(p);
+		}
+		catch (const std::invalid_argument&) {
+			ADD_FAILURE() << "invalid_argument for " << header;
+		}
+		catch (const std::runtime_error&) {
+		}
+		std::remove(p.c_str());
+	}
+	std::string p = writeBytes("oversized.bmp", bmpHeader(2000, 2, 24, 0, {}, 0));
+	EXPECT_THROW(ImageFile::read(p), std::runtime_error);
+	std::remove(p.c_str());
+}
+
+TEST(ImageFile, ReadsBMPBitfieldsAndBottomUpRows) {
+	using namespace Test_ImageFile;
+	// 24-bit, bottom-up, 3 pixels per row padded to 12 bytes
+	std::vector<unsigned char> b = bmpHeader(3, 2, 24, 0, {}, 24);
+	const unsigned char rows[2][12] = {
+		{1, 2, 3, 4, 5, 6, 7, 8, 9, 0xEE, 0xEE, 0xEE},      // bottom row, BGR
+		{10, 11, 12, 13, 14, 15, 16, 17, 18, 0xEE, 0xEE, 0xEE},
+	};
+	for (auto& r : rows)
+		b.insert(b.end(), r, r + 12);
+	ColorGrid cg = ImageFile::read(writeBytes("24.bmp", b));
+	EXPECT_EQ(cg.get(0, 0), Color(12, 11, 10));
+	EXPECT_EQ(cg.get(0, 2), Color(18, 17, 16));
+	EXPECT_EQ(cg.get(1, 0), Color(3, 2, 1));
+	EXPECT_EQ(cg.get(1, 2), Color(9, 8, 7));
+
+	// 32-bit bitfields with red in the low byte and no alpha mask
+	b = bmpHeader(2, -1, 32, 3, {0x000000FFu, 0x0000FF00u, 0x00FF0000u}, 8);
+	b.insert(b.end(), {1, 2, 3, 4, 5, 6, 7, 8});
+	cg = ImageFile::read(writeBytes("rgb.bmp", b));
+	EXPECT_EQ(cg.get(0, 0), Color(1, 2, 3, 255));
+	EXPECT_EQ(cg.get(0, 1), Color(5, 6, 7, 255));
+
+	// channels that are not 8-bit and compressed BMP are not supported
+	b = bmpHeader(1, 1, 32, 3, {0x0000FFFFu, 0x00FF0000u, 0xFF000000u}, 4);
+	b.insert(b.end(), {1, 2, 3, 4});
+	EXPECT_THROW(ImageFile::read(writeBytes("565.bmp", b)), std::runtime_error);
+	b = bmpHeader(1, 1, 8, 1, {}, 4);
+	b.insert(b.end(), {1, 2, 3, 4});
+	EXPECT_THROW(ImageFile::read(writeBytes("rle.bmp", b)), std::runtime_error);
+	for (const char* n : {"24.bmp", "rgb.bmp", "565.bmp", "rle.bmp"})
+		std::remove(path(n).c_str());
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "InputLog.h"
+
+using namespace bridges::game;
+
+namespace Test_InputLog {
+	InputEvent event(Key key, bool pressed) {
+		InputEvent e;
+		e.key = key;
+		e.pressed = pressed;
+		return e;
+	}
+}
+
+TEST(InputLog, SaveLoadRoundTrip) {
+	using Test_InputLog::event;
+	InputLog log;
+	log.record(0, event(Key::Up, true));
+	log.record(0, event(Key::Space, true));
+	log.record(3, event(Key::Up, false));
+	log.record(7, event(Key::Q, true));
+	// an event recorded late goes with its frame, after its events
+	log.record(0, event(Key::Space, false));
+	log.record(12, event(Key::D, false));
+
+	std::string file = testing::TempDir() + "inputlog_roundtrip.txt";
+	log.save(file);
+	InputLog loaded;
+	loaded.load(file);
+	std::remove(file.c_str());
+
+	ASSERT_EQ(loaded.size(), log.size());
+	for (size_t i = 0; i < log.size(); ++i) {
+		EXPECT_EQ(loaded.getEntries()[i].frame, log.getEntries()[i].frame);
+		EXPECT_EQ(loaded.getEntries()[i].event.key, log.getEntries()[i].event.key);
+		EXPECT_EQ(loaded.getEntries()[i].event.pressed, log.getEntries()[i].event.pressed);
+	}
+
+	std::vector<InputEvent> events;
+	loaded.eventsAt(0, events);
+	ASSERT_EQ(events.size(), 3u);
+	EXPECT_EQ(events[1].key, Key::Space);
+	EXPECT_TRUE(events[1].pressed);
+	EXPECT_FALSE(events[2].pressed);
+	loaded.eventsAt(5, events);
+	EXPECT_TRUE(events.empty());
+
+	loaded.truncate(7);
+	EXPECT_EQ(loaded.size(), 4u);
+}
+
+TEST(InputLog, LoadRejectsMalformedLines) {
+	std::string file = testing::TempDir() + "inputlog_malformed.txt";
+	{
+		std::ofstream out(file);
+		out << "# comment\n\n4 left down\n5 jump down\n";
+	}
+	InputLog log;
+	EXPECT_THROW(log.load(file), std::runtime_error);
+	std::remove(file.c_str());
+	EXPECT_THROW(log.load(file), std::runtime_error);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "InputHelper.h"
+#include "InputStateMachine.h"
+
+using namespace bridges::game;
+
+namespace Test_InputStateMachine {
+	InputEvent event(Key key, bool pressed) {
+		InputEvent e;
+		e.key = key;
+		e.pressed = pressed;
+		return e;
+	}
+
+	/// runs a frame of ih with the events, and feeds key to sm
+	void frame(InputHelper& ih, InputStateMachine& sm, Key key,
+		const std::vector<InputEvent>& events) {
+		ih.update(events);
+		sm.update(ih.activity(key));
+	}
+}
+
+TEST(InputStateMachine, HeldKeyCycle) {
+	using namespace Test_InputStateMachine;
+	InputHelper ih;
+	InputStateMachine sm;
+	EXPECT_TRUE(sm.stillNotPressed());
+
+	frame(ih, sm, Key::Up, {event(Key::Up, true)});
+	EXPECT_TRUE(sm.justPressed());
+	EXPECT_TRUE(sm.fire());
+	frame(ih, sm, Key::Up, {});
+	EXPECT_TRUE(sm.stillPressed());
+	frame(ih, sm, Key::Up, {event(Key::Up, false)});
+	EXPECT_TRUE(sm.justNotPressed());
+	frame(ih, sm, Key::Up, {});
+	EXPECT_TRUE(sm.stillNotPressed());
+}
+
+TEST(InputStateMachine, TapWithinAFrameIsAPress) {
+	using namespace Test_InputStateMachine;
+	InputHelper ih;
+	InputStateMachine sm;
+	frame(ih, sm, Key::Space, {event(Key::Space, true), event(Key::Space, false)});
+	EXPECT_TRUE(ih.activity(Key::Space).pressed);
+	EXPECT_FALSE(ih.activity(Key::Space).down);
+	EXPECT_TRUE(sm.justPressed());
+	EXPECT_TRUE(sm.fire());
+
+	// the key is up: the press ends at the next frame
+	frame(ih, sm, Key::Space, {});
+	EXPECT_TRUE(sm.justNotPressed());
+}
+
+TEST(InputStateMachine, ReleaseAndPressWithinAFrameIsANewPress) {
+	using namespace Test_InputStateMachine;
+	InputHelper ih;
+	InputStateMachine sm;
+	frame(ih, sm, Key::Left, {event(Key::Left, true)});
+	frame(ih, sm, Key::Left, {});
+	frame(ih, sm, Key::Left, {});
+	ASSERT_TRUE(sm.stillPressed());
+
+	frame(ih, sm, Key::Left, {event(Key::Left, false), event(Key::Left, true)});
+	EXPECT_TRUE(sm.justPressed());
+	EXPECT_TRUE(sm.fire());
+	frame(ih, sm, Key::Left, {});
+	EXPECT_TRUE(sm.stillPressed());
+
+	// other keys are not affected
+	InputStateMachine right;
+	right.update(ih.activity(Key::Right));
+	EXPECT_TRUE(right.stillNotPressed());
+}
+
+TEST(InputStateMachine, EventsFromTheListenerReachTheFrame) {
+	using namespace Test_InputStateMachine;
+	InputHelper ih;
+	InputStateMachine sm;
+	KeypressListener& listener = ih;
+	// from another thread, as the socket does
+	std::thread socket([&listener]() {
+		listener.keyEvent(event(Key::D, true));
+		listener.keyEvent(event(Key::D, false));
+	});
+	socket.join();
+	ih.update();
+	sm.update(ih.activity(Key::D));
+	EXPECT_TRUE(sm.justPressed());
+	ASSERT_EQ(ih.getFrameEvents().size(), 2u);
+	EXPECT_TRUE(ih.getFrameEvents()[0].pressed);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <string>
+#include <vector>
+#include "NonBlockingGame3D.h"
+#include "rapidjson/document.h"
+
+using namespace bridges;
+using namespace bridges::game;
+
+namespace Test_NonBlockingGame3D {
+	/**
+	 * Flies the camera over a terrain shown with a TerrainLOD, and
+	 * records the meshes of the scene at each frame.
+	 */
+	class Flyover : public NonBlockingGame3D {
+			std::shared_ptr<TerrainLOD> lod;
+			int frames;
+
+		public:
+			std::vector<std::set<std::string>> shown;
+
+			Flyover(std::shared_ptr<GameTransport> transport, int frames)
+				: NonBlockingGame3D(transport), frames(frames) {
+			}
+
+		protected:
+			void initialize() override {
+				dataset::ElevationData map(257, 257);
+				for (int r = 0; r < 257; ++r)
+					for (int c = 0; c < 257; ++c)
+						map.setVal(r, c, (int) (20 * std::sin(r * 0.05) * std::cos(c * 0.07)));
+				lod = std::make_shared<TerrainLOD>(std::move(map), 16, 1.f, 1.f);
+				lod->setMaxBuilds(64);
+				setTerrainLOD(lod);
+				setDeltaFrames(true, 1000);
+			}
+
+			void gameLoop() override {
+				std::set<std::string> names;
+				for (const auto& t : current_scene.getTerrains())
+					names.insert(t.first);
+				shown.push_back(names);
+
+				// from one corner of the map to the other
+				long frame = (long) shown.size();
+				float position[3] = {256.f * frame / frames, 30.f, 256.f * frame / frames};
+				Camera camera("fps", 90, position);
+				current_scene.setCamera(camera);
+				if (frame == frames)
+					quit();
+			}
+	};
+
+	/**
+	 * Two meshes that do not change, except the second one at frame
+	 * 2, with delta frames.
+	 */
+	class StillLife : public NonBlockingGame3D {
+		public:
+			long frame = 0;
+
+			StillLife(std::shared_ptr<GameTransport> transport)
+				: NonBlockingGame3D(transport) {
+			}
+
+		protected:
+			void initialize() override {
+				for (std::string name : {
+							"hill", "lake"
+						}) {
+					TerrainMesh mesh;
+					mesh.setName(name);
+					mesh.setType("terrain");
+					mesh.setRows(2);
+					mesh.setCols(2);
+					mesh.getVertices().assign(4, 1.f);
+					mesh.getColors().assign(16, 1.f);
+					current_scene.add(mesh);
+				}
+				setDeltaFrames(true, 1000);
+			}
+
+			void gameLoop() override {
+				if (frame == 1)
+					current_scene.get("lake").getVertices()[0] = 2.f;
+				if (++frame == 2)
+					quit();
+			}
+	};
+
+	std::vector<std::string> names(const rapidjson::Value& array, const char* field) {
+		std::vector<std::string> out;
+		for (const auto& v : array.GetArray())
+			out.push_back(field ? v[field].GetString() : v.GetString());
+		std::sort(out.begin(), out.end());
+		return out;
+	}
+}
+
+TEST(NonBlockingGame3D, DeltaFramesKeepUnchangedMeshes) {
+	auto transport = std::make_shared<HeadlessTransport>(8);
+	Test_NonBlockingGame3D::StillLife game(transport);
+	game.start();
+	ASSERT_EQ(transport->getFrames().size(), 3u);
+
+	using Test_NonBlockingGame3D::names;
+	const std::vector<std::string> both {"hill", "lake"};
+	std::vector<rapidjson::Document> frames(3);
+	for (size_t f = 0; f < 3; ++f) {
+		frames[f].Parse(transport->getFrames()[f].c_str());
+		ASSERT_FALSE(frames[f].HasParseError()) << transport->getFrames()[f];
+	}
+
+	// the first frame holds the whole scene
+	EXPECT_EQ(names(frames[0]["meshes"], "name"), both);
+	EXPECT_FALSE(frames[0].HasMember("keep"));
+
+	// nothing changed: no mesh is sent again, the viewer keeps both
+	ASSERT_TRUE(frames[1].HasMember("keep"));
+	EXPECT_TRUE(frames[1]["meshes"].GetArray().Empty());
+	EXPECT_EQ(names(frames[1]["keep"], nullptr), both);
+
+	// only the modified mesh is sent
+	ASSERT_TRUE(frames[2].HasMember("keep"));
+	EXPECT_EQ(names(frames[2]["meshes"], "name"), std::vector<std::string> {"lake"});
+	EXPECT_EQ(names(frames[2]["keep"], nullptr), std::vector<std::string> {"hill"});
+}
+
+TEST(NonBlockingGame3D, TerrainFollowsTheCamera) {
+	auto transport = std::make_shared<HeadlessTransport>(1);
+	Test_NonBlockingGame3D::Flyover game(transport, 40);
+	game.start();
+
+	// the first render and one per frame
+	ASSERT_EQ(game.shown.size(), 40u);
+	EXPECT_EQ(transport->getFrameCount(), 41);
+
+	const std::set<std::string>& first = game.shown.front();
+	const std::set<std::string>& last = game.shown.back();
+	ASSERT_FALSE(first.empty());
+	ASSERT_FALSE(last.empty());
+
+	size_t added = 0, removed = 0;
+	for (size_t f = 1; f < game.shown.size(); ++f) {
+		for (const std::string& name : game.shown[f])
+			added += game.shown[f - 1].count(name) == 0;
+		for (const std::string& name : game.shown[f - 1])
+			removed += game.shown[f].count(name) == 0;
+	}
+	EXPECT_GT(added, 0u);
+	EXPECT_GT(removed, 0u);
+
+	// the most detailed chunks are under the camera
+	EXPECT_EQ(first.count("terrain/4/0/0"), 1u);
+	EXPECT_EQ(last.count("terrain/4/15/15"), 1u);
+
+	// the detailed chunks near the start are gone at the end
+	size_t kept = 0;
+	for (const std::string& name : first)
+		kept += last.count(name);
+	EXPECT_LT(kept, first.size());
+}
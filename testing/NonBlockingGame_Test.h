@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "NonBlockingGame.h"
+
+using namespace bridges::game;
+
+namespace Test_NonBlockingGame {
+	/**
+	 * The arrows move a cursor, space paints the cell under it with
+	 * the next color, q ends the game. The cursor is state beyond the
+	 * board, saved with saveState().
+	 */
+	class Painter : public NonBlockingGame {
+			struct State {
+				int row, col, color;
+			};
+			int row = 0, col = 0, color = 0;
+			long lastFrame;
+
+		public:
+			Painter(std::shared_ptr<GameTransport> transport, long lastFrame = -1)
+				: NonBlockingGame(transport, 8, 8), lastFrame(lastFrame) {
+			}
+
+			int getRow() const {
+				return row;
+			}
+			int getCol() const {
+				return col;
+			}
+
+			std::vector<unsigned char> board() const {
+				std::vector<unsigned char> out(3 * 8 * 8);
+				observe(out.data());
+				return out;
+			}
+
+		protected:
+			void initialize() override {
+				setInputLogging(true);
+			}
+
+			void gameLoop() override {
+				if (keyUpJustPressed())
+					row = (row + 7) % 8;
+				if (keyDownJustPressed())
+					row = (row + 1) % 8;
+				if (keyLeftJustPressed())
+					col = (col + 7) % 8;
+				if (keyRightJustPressed())
+					col = (col + 1) % 8;
+				if (keySpaceJustPressed()) {
+					color = (color + 1) % 16;
+					setBGColor(row, col, static_cast<NamedColor>(color));
+				}
+				drawSymbol(row, col, NamedSymbol::circle, NamedColor::white);
+				if (keyQ() || getFrameNumber() == lastFrame)
+					quit();
+			}
+
+			std::shared_ptr<const void> saveState() const override {
+				return std::make_shared<State>(State{row, col, color});
+			}
+
+			void restoreState(const std::shared_ptr<const void>& s) override {
+				const State& st = *std::static_pointer_cast<const State>(s);
+				row = st.row;
+				col = st.col;
+				color = st.color;
+			}
+	};
+
+	std::vector<InputEvent> press(Key key) {
+		InputEvent down, up;
+		down.key = up.key = key;
+		down.pressed = true;
+		up.pressed = false;
+		return {down, up};
+	}
+
+	/// the key presses of a short game
+	const std::vector<std::pair<long, Key>>& moves() {
+		static const std::vector<std::pair<long, Key>> m {
+			{1, Key::Right}, {2, Key::Space}, {4, Key::Down}, {5, Key::Down},
+			{6, Key::Space}, {9, Key::Left}, {10, Key::Space}, {13, Key::Up},
+			{15, Key::Space}, {18, Key::Right}, {19, Key::Right}, {20, Key::Space}
+		};
+		return m;
+	}
+}
+
+TEST(NonBlockingGame, RestoreGivesTheBoardOfTheSnapshot) {
+	using namespace Test_NonBlockingGame;
+	Painter g(std::make_shared<HeadlessTransport>());
+	g.step(press(Key::Right));
+	g.step(press(Key::Space));
+	g.step(press(Key::Down));
+
+	Painter::Snapshot s = g.snapshot();
+	std::vector<unsigned char> before = g.board();
+
+	g.step(press(Key::Space));
+	g.step(press(Key::Right));
+	g.step(press(Key::Space));
+	g.step(press(Key::Q));
+	ASSERT_TRUE(g.isGameOver());
+	ASSERT_NE(g.board(), before);
+
+	g.restore(s);
+	EXPECT_EQ(g.board(), before);
+	EXPECT_EQ(g.getFrameNumber(), 3);
+	EXPECT_FALSE(g.isGameOver());
+	EXPECT_EQ(g.getRow(), 1);
+	EXPECT_EQ(g.getCol(), 1);
+
+	// the snapshot is not changed by what the game does after restoring it
+	g.step(press(Key::Space));
+	g.restore(s);
+	EXPECT_EQ(g.board(), before);
+}
+
+TEST(NonBlockingGame, SnapshotRestoresInAnotherInstance) {
+	using namespace Test_NonBlockingGame;
+	Painter a(std::make_shared<HeadlessTransport>());
+	Painter b(std::make_shared<HeadlessTransport>());
+	a.step(press(Key::Down));
+	a.step(press(Key::Space));
+	Painter::Snapshot s = a.snapshot();
+
+	b.restore(s);
+	EXPECT_EQ(b.board(), a.board());
+
+	// the two games share the board until one of them changes it
+	b.step(press(Key::Space));
+	a.step(press(Key::Right));
+	EXPECT_NE(b.board(), a.board());
+	b.restore(s);
+	a.restore(s);
+	EXPECT_EQ(b.board(), a.board());
+}
+
+TEST(NonBlockingGame, ReplayReproducesTheBoard) {
+	using namespace Test_NonBlockingGame;
+	// a game played with scripted key events, at the speed of start()
+	auto transport = std::make_shared<HeadlessTransport>();
+	for (const auto& m : moves()) {
+		transport->addKeyEvent(m.first, m.second, true);
+		transport->addKeyEvent(m.first, m.second, false);
+	}
+	Painter played(transport, 24);
+	played.start();
+	ASSERT_TRUE(played.isGameOver());
+	ASSERT_EQ(played.getInputLog().size(), 2 * moves().size());
+
+	// the log, through a file, replayed in a fresh game
+	std::string file = testing::TempDir() + "painter_input.txt";
+	played.getInputLog().save(file);
+	InputLog log;
+	log.load(file);
+	std::remove(file.c_str());
+
+	Painter replayed(std::make_shared<HeadlessTransport>(), 24);
+	replayed.replay(log, 24);
+	EXPECT_TRUE(replayed.isGameOver());
+	EXPECT_EQ(replayed.getFrameNumber(), played.getFrameNumber());
+	EXPECT_EQ(replayed.board(), played.board());
+
+	// and from a snapshot in the middle of the game
+	Painter partial(std::make_shared<HeadlessTransport>(), 24);
+	partial.replay(log, 11);
+	Painter::Snapshot s = partial.snapshot();
+	Painter resumed(std::make_shared<HeadlessTransport>(), 24);
+	resumed.restore(s);
+	resumed.replay(log, 24);
+	EXPECT_EQ(resumed.board(), played.board());
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RunWatchdog.h"
+#include "SortingBenchmark.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/wait.h>
+#endif
+
+using namespace bridges::benchmark;
+using namespace bridges::datastructure;
+
+namespace Test_RunWatchdog {
+	inline double secondsSince(std::chrono::steady_clock::time_point start) {
+		std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+		return d.count();
+	}
+
+	/// std::sort, but stuck for 10 seconds on arrays of 64 elements or more
+	inline void slowOnLarge(int* arr, int n) {
+		if (n >= 64)
+			std::this_thread::sleep_for(std::chrono::seconds(10));
+		std::sort(arr, arr + n);
+	}
+
+#ifndef _WIN32
+	/// no child left to reap, i.e. the watchdog did not leave a zombie
+	inline bool noChildLeft() {
+		return waitpid(-1, nullptr, WNOHANG) == -1 && errno == ECHILD;
+	}
+#endif
+}
+
+TEST(RunWatchdog, ReturnsTheResultOfACompletedRun) {
+	double out = 0.;
+	EXPECT_TRUE(RunWatchdog::run(5., []() {
+		return 2.5;
+	}, out));
+	EXPECT_EQ(out, 2.5);
+}
+
+#ifndef _WIN32
+TEST(RunWatchdog, KillsARunPastItsTimeLimit) {
+	using namespace Test_RunWatchdog;
+	auto start = std::chrono::steady_clock::now();
+	int out = 0;
+	EXPECT_FALSE(RunWatchdog::run(0.2, []() {
+		std::this_thread::sleep_for(std::chrono::seconds(10));
+		return 1;
+	}, out));
+	double elapsed = secondsSince(start);
+	EXPECT_GE(elapsed, 0.2);
+	EXPECT_LT(elapsed, 5.);
+	EXPECT_EQ(out, 0);
+	EXPECT_TRUE(noChildLeft());
+}
+
+TEST(RunWatchdog, ReportsAFailedChild) {
+	using namespace Test_RunWatchdog;
+	int out = 0;
+	EXPECT_FALSE(RunWatchdog::run(5., []() -> int {
+		_exit(3);
+	}, out));
+	EXPECT_TRUE(noChildLeft());
+}
+
+TEST(RunWatchdog, ChildWritesAreNotVisible) {
+	int value = 1;
+	int out = 0;
+	EXPECT_TRUE(RunWatchdog::run(5., [&]() {
+		value = 2;
+		return value;
+	}, out));
+	EXPECT_EQ(out, 2);
+	EXPECT_EQ(value, 1);
+}
+
+TEST(RunWatchdog, SortingBenchmarkReportsAndDropsTheAbortedSize) {
+	using namespace Test_RunWatchdog;
+	LineChart lc;
+	BenchmarkResults res;
+	SortingBenchmark sb(lc);
+	sb.geometricRange(16, 256, 2.);
+	sb.setTimeCap(0.2);
+	sb.setWatchdog(true);
+	sb.recordResults(res);
+
+	auto start = std::chrono::steady_clock::now();
+	testing::internal::CaptureStderr();
+	sb.run("slow", slowOnLarge);
+	std::string err = testing::internal::GetCapturedStderr();
+	EXPECT_LT(secondsSince(start), 5.);
+
+	EXPECT_NE(err.find("slow aborted on size 64"), std::string::npos) << err;
+	EXPECT_EQ(lc.getXData("slow"), std::vector<double>({16., 32.}));
+	std::vector<BenchmarkPoint> pts = res.getSeries("slow");
+	ASSERT_EQ(pts.size(), 2u);
+	EXPECT_EQ(pts[0].x, 16.);
+	EXPECT_EQ(pts[1].x, 32.);
+	EXPECT_TRUE(noChildLeft());
+}
+#endif
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "SPSCRing.h"
+
+using namespace bridges;
+
+TEST(SPSCRing, FullAndEmpty) {
+	SPSCRing<int, 4> ring;
+	int v = -1;
+	EXPECT_TRUE(ring.empty());
+	EXPECT_FALSE(ring.pop(v));
+	EXPECT_EQ(v, -1);
+
+	for (int i = 0; i < 4; ++i)
+		EXPECT_TRUE(ring.push(i));
+	EXPECT_FALSE(ring.push(4));
+	EXPECT_FALSE(ring.empty());
+
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_TRUE(ring.pop(v));
+		EXPECT_EQ(v, i);
+	}
+	EXPECT_FALSE(ring.pop(v));
+	EXPECT_TRUE(ring.empty());
+}
+
+TEST(SPSCRing, WrapsAround) {
+	SPSCRing<int, 8> ring;
+	int next = 0, expected = 0, v;
+	// fills of every size, so the indices wrap at every position
+	for (int round = 0; round < 100; ++round) {
+		int n = 1 + round % 8;
+		for (int i = 0; i < n; ++i)
+			ASSERT_TRUE(ring.push(next++));
+		if (n == 8)
+			EXPECT_FALSE(ring.push(next));
+		for (int i = 0; i < n; ++i) {
+			ASSERT_TRUE(ring.pop(v));
+			ASSERT_EQ(v, expected++);
+		}
+		ASSERT_TRUE(ring.empty());
+	}
+}
+
+TEST(SPSCRing, ProducerAndConsumerThreads) {
+	SPSCRing<long, 64> ring;
+	const long count = 200000;
+	std::thread producer([&ring, count]() {
+		for (long i = 0; i < count; ++i)
+			while (!ring.push(i))
+				std::this_thread::yield();
+	});
+	long expected = 0, v;
+	while (expected < count) {
+		if (ring.pop(v)) {
+			ASSERT_EQ(v, expected);
+			++expected;
+		}
+		else
+			std::this_thread::yield();
+	}
+	producer.join();
+	EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,312 @@
+// Measures the throughput of the serialization hot paths of the library:
+// getDataStructureRepresentation() of the main data structures, base64
+// and JSONencode.
+//
+//   make serialization_bench
+//   ./serialization_bench [--filter name] [--min-time s] [--save file]
+//                         [--baseline file]
+//
+// --save stores the measurements (JSON, or CSV if the file name ends with
+// .csv) so that a later run can be compared against it with --baseline.
+
+#include "Bridges.h"
+#include "SLelement.h"
+#include "GraphAdjList.h"
+#include "ColorGrid.h"
+#include "AudioClip.h"
+#include "SymbolCollection.h"
+#include "Circle.h"
+#include "LineChart.h"
+#include "base64.h"
+#include "JSONutil.h"
+#include "BenchmarkResults.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bridges {
+	namespace benchmark {
+		using namespace bridges::datastructure;
+
+		class SerializationBenchmark {
+			private:
+				double minTime;
+				int samples;
+				std::string filter;
+				BenchmarkResults results;
+				size_t sink;
+
+				static std::string repr(const DataStructure& ds) {
+					return RepresentationAccess::get(ds);
+				}
+
+				/**
+				 * Times op() (which returns the number of bytes it produced)
+				 * in batches lasting at least minTime, and records the
+				 * time per call of each batch.
+				 **/
+				template <typename Func>
+				void measure(const std::string& name, double size, Func op) {
+					if (name.find(filter) == std::string::npos)
+						return;
+
+					size_t bytes = op();
+					sink += bytes;
+
+					long iterations = 1;
+					std::vector<double> perOp;
+					while ((int) perOp.size() < samples) {
+						auto start = std::chrono::steady_clock::now();
+						for (long i = 0; i < iterations; ++i)
+							sink += op();
+						std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+						if (elapsed.count() < minTime && perOp.empty()) {
+							iterations *= 2;
+							continue;
+						}
+						perOp.push_back(elapsed.count() / iterations);
+						results.addSample(name, size, elapsed.count() / iterations);
+					}
+
+					BenchmarkPoint pt;
+					pt.samples = perOp;
+					double t = pt.median();
+					std::cout << std::left << std::setw(26) << name
+						<< std::right << std::setw(10) << size
+						<< std::setw(14) << t * 1e6 << " us"
+						<< std::setw(12) << bytes / t / 1e6 << " MB/s"
+						<< std::endl;
+				}
+
+				void benchSLelement() {
+					for (int n : {
+							100, 1000, 4000
+						}) {
+						std::vector<std::unique_ptr<SLelement<int>>> list;
+						for (int i = 0; i < n; ++i) {
+							list.emplace_back(new SLelement<int>(i, std::to_string(i)));
+							if (i > 0)
+								list[i - 1]->setNext(list[i].get());
+						}
+						const SLelement<int>& head = *list[0];
+						measure("SLelement list", n, [&]() {
+							return repr(head).size();
+						});
+					}
+				}
+
+				void benchGraph(const std::string& name, bool large, std::vector<int> sizes) {
+					for (int n : sizes) {
+						GraphAdjList<int, int, int> gr;
+						std::mt19937 rng(n);
+						for (int i = 0; i < n; ++i) {
+							gr.addVertex(i, i);
+							if (large)
+								gr.getVertex(i)->setLocation(rng() % 1000, rng() % 1000);
+						}
+						for (int i = 0; i < n; ++i)
+							for (int d = 0; d < 4; ++d)
+								gr.addEdge(i, rng() % n, d);
+						if (large)
+							gr.forceLargeVisualization(true);
+						else
+							gr.forceSmallVisualization(true);
+						measure(name, n, [&]() {
+							return repr(gr).size();
+						});
+					}
+				}
+
+				void benchColorGrid() {
+					std::vector<std::pair<int, int>> dims = {{100, 100}, {480, 640}, {1080, 1920}};
+					for (auto d : dims) {
+						int rows = d.first, cols = d.second;
+
+						// horizontal stripes: long runs, encoded as RLE
+						ColorGrid stripes(rows, cols);
+						for (int i = 0; i < rows; ++i)
+							for (int j = 0; j < cols; ++j)
+								stripes.set(i, j, Color((i / 16) % 256, 0, 255 - (i / 16) % 256));
+						measure("ColorGrid RLE", (double) rows * cols, [&]() {
+							return repr(stripes).size();
+						});
+
+						// noise: no runs, encoded as RAW
+						ColorGrid noise(rows, cols);
+						std::mt19937 rng(rows);
+						for (int i = 0; i < rows; ++i)
+							for (int j = 0; j < cols; ++j)
+								noise.set(i, j, Color(rng() % 256, rng() % 256, rng() % 256));
+						measure("ColorGrid RAW", (double) rows * cols, [&]() {
+							return repr(noise).size();
+						});
+					}
+				}
+
+				void benchAudioClip() {
+					for (int n : {
+							10000, 100000, 1000000
+						}) {
+						AudioClip ac(n, 1, 16, 44100);
+						for (int i = 0; i < n; ++i)
+							ac.setSample(0, i, (int)(30000 * std::sin(i * 0.01)));
+						measure("AudioClip", n, [&]() {
+							return repr(ac).size();
+						});
+					}
+				}
+
+				void benchSymbolCollection() {
+					for (int n : {
+							100, 1000, 10000
+						}) {
+						SymbolCollection sc;
+						for (int i = 0; i < n; ++i)
+							sc.addSymbol(Circle(i % 100, i / 100, 1.));
+						measure("SymbolCollection", n, [&]() {
+							return repr(sc).size();
+						});
+					}
+				}
+
+				void benchLineChart() {
+					for (int n : {
+							1000, 10000, 100000
+						}) {
+						LineChart lc;
+						std::vector<double> x(n), y(n);
+						for (int i = 0; i < n; ++i) {
+							x[i] = i;
+							y[i] = std::sqrt((double) i);
+						}
+						lc.setDataSeries("sqrt", x, y);
+						measure("LineChart", n, [&]() {
+							return repr(lc).size();
+						});
+					}
+				}
+
+				void benchBase64() {
+					for (int n : {
+							1 << 10, 1 << 20, 1 << 24
+						}) {
+						std::vector<BYTE> buf(n);
+						std::mt19937 rng(n);
+						for (auto& b : buf)
+							b = (BYTE) rng();
+						std::string enc = base64::encode(buf.data(), (unsigned int) buf.size());
+						measure("base64 encode", n, [&]() {
+							return base64::encode(buf.data(), (unsigned int) buf.size()).size();
+						});
+						measure("base64 decode", n, [&]() {
+							return base64::decode(enc).size();
+						});
+					}
+				}
+
+				void benchJSONencode() {
+					using bridges::JSONUtil::JSONencode;
+					for (int n : {
+							1 << 10, 1 << 16, 1 << 20
+						}) {
+						std::string str(n, 'a');
+						for (int i = 0; i < n; i += 37)
+							str[i] = (i % 2) ? '"' : '\n';
+						measure("JSONencode string", n, [&]() {
+							return JSONencode(str).size();
+						});
+
+						std::vector<double> values(n / 8);
+						for (size_t i = 0; i < values.size(); ++i)
+							values[i] = i / 7.;
+						measure("JSONencode double", (double) values.size(), [&]() {
+							size_t len = 0;
+							for (double v : values)
+								len += JSONencode(v).size();
+							return len;
+						});
+					}
+				}
+
+			public:
+				SerializationBenchmark(const std::string& filter, double minTime)
+					: minTime(minTime), samples(5), filter(filter), sink(0) {
+					results.setMetadata("benchmark", "SerializationBenchmark");
+				}
+
+				void run() {
+					std::cout << std::left << std::setw(26) << "benchmark"
+						<< std::right << std::setw(10) << "size"
+						<< std::setw(17) << "time/op"
+						<< std::setw(17) << "output" << std::endl;
+					benchSLelement();
+					benchGraph("GraphAdjList small", false, {100, 1000, 2000});
+					benchGraph("GraphAdjList large", true, {5000, 50000});
+					benchColorGrid();
+					benchAudioClip();
+					benchSymbolCollection();
+					benchLineChart();
+					benchBase64();
+					benchJSONencode();
+					if (sink == 0)
+						std::cout << "nothing measured" << std::endl;
+				}
+
+				const BenchmarkResults& getResults() const {
+					return results;
+				}
+		};
+	}
+}
+
+using namespace bridges::benchmark;
+
+int main(int argc, char** argv) {
+	std::string filter;
+	double minTime = 0.1;
+	std::string saveFile;
+	std::string baselineFile;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (i + 1 < argc && arg == "--filter")
+			filter = argv[++i];
+		else if (i + 1 < argc && arg == "--min-time")
+			minTime = std::atof(argv[++i]);
+		else if (i + 1 < argc && arg == "--save")
+			saveFile = argv[++i];
+		else if (i + 1 < argc && arg == "--baseline")
+			baselineFile = argv[++i];
+		else {
+			std::cerr << "usage: " << argv[0]
+				<< " [--filter name] [--min-time s] [--save file] [--baseline file]"
+				<< std::endl;
+			return 1;
+		}
+	}
+
+	try {
+		SerializationBenchmark sb(filter, minTime);
+		sb.run();
+
+		if (!saveFile.empty())
+			sb.getResults().save(saveFile);
+
+		if (!baselineFile.empty()) {
+			BenchmarkComparison cmp(BenchmarkResults::load(baselineFile), sb.getResults());
+			std::cout << "\nspeedup over " << baselineFile << std::endl;
+			cmp.print(std::cout);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+#include "SocketConnection.h"
+
+using namespace bridges::game;
+
+namespace Test_SocketConnection {
+	std::set<std::string> keys(const sio::message::ptr& msg) {
+		std::set<std::string> k;
+		for (const auto& f : msg->get_map())
+			k.insert(f.first);
+		return k;
+	}
+
+	const sio::message::ptr& field(const sio::message::ptr& msg, const std::string& name) {
+		static const sio::message::ptr none;
+		auto it = msg->get_map().find(name);
+		return it == msg->get_map().end() ? none : it->second;
+	}
+
+	const std::string& bytes(const sio::message::ptr& msg, const std::string& name) {
+		const sio::message::ptr& f = field(msg, name);
+		EXPECT_TRUE(f && f->get_flag() == sio::message::flag_binary) << name;
+		return *f->get_binary();
+	}
+
+	/// little-endian 32-bit floats
+	std::vector<float> floats(const std::string& buf) {
+		EXPECT_EQ(buf.size() % 4, 0u);
+		std::vector<float> out(buf.size() / 4);
+		for (size_t i = 0; i < out.size(); ++i) {
+			const unsigned char* p = (const unsigned char*) &buf[4 * i];
+			uint32_t bits = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+			std::memcpy(&out[i], &bits, 4);
+		}
+		return out;
+	}
+
+	TerrainMesh mesh(const std::string& name, std::vector<float> vertices) {
+		TerrainMesh m;
+		m.setName(name);
+		m.setType("terrain");
+		m.setRows(2);
+		m.setCols(2);
+		m.setVertices(vertices);
+		m.getColors().assign(16, 0.5f);
+		return m;
+	}
+}
+
+TEST(SocketConnection, GridMessageLayout) {
+	using namespace Test_SocketConnection;
+	GameGrid g(3, 4);
+	g.setDeltaFrames(true, 100);
+	g.setBGColor(0, 1, NamedColor::red);
+	g.drawSymbol(2, 3, NamedSymbol::star, NamedColor::green);
+
+	sio::message::ptr msg = SocketConnection::getGridMessage(g);
+	ASSERT_EQ(msg->get_flag(), sio::message::flag_object);
+	EXPECT_EQ(keys(msg), (std::set<std::string> {"encoding", "dimensions", "bg", "fg", "symbols"}));
+	EXPECT_EQ(field(msg, "encoding")->get_string(), "raw");
+	const auto& dims = field(msg, "dimensions")->get_vector();
+	ASSERT_EQ(dims.size(), 2u);
+	EXPECT_EQ(dims[0]->get_int(), 3);
+	EXPECT_EQ(dims[1]->get_int(), 4);
+	const std::string& bg = bytes(msg, "bg");
+	ASSERT_EQ(bg.size(), 12u);
+	EXPECT_EQ((NamedColor) bg[1], NamedColor::red);
+	EXPECT_EQ((NamedColor) bg[0], NamedColor::black);
+	ASSERT_EQ(bytes(msg, "fg").size(), 12u);
+	EXPECT_EQ((NamedColor) bytes(msg, "fg")[11], NamedColor::green);
+	EXPECT_EQ((NamedSymbol) bytes(msg, "symbols")[11], NamedSymbol::star);
+
+	// only delta frames have cells
+	g.setBGColor(2, 2, NamedColor::blue);
+	g.setBGColor(0, 0, NamedColor::white);
+	msg = SocketConnection::getGridMessage(g);
+	EXPECT_EQ(keys(msg), (std::set<std::string> {"encoding", "dimensions", "cells", "bg", "fg", "symbols"}));
+	EXPECT_EQ(field(msg, "encoding")->get_string(), "delta");
+	EXPECT_EQ(bytes(msg, "cells"), std::string("\x0a\0\0\0\0\0\0\0", 8));
+	EXPECT_EQ(bytes(msg, "bg"), std::string({(char) NamedColor::blue, (char) NamedColor::white}));
+	EXPECT_EQ(bytes(msg, "fg").size(), 2u);
+	EXPECT_EQ(bytes(msg, "symbols").size(), 2u);
+}
+
+TEST(SocketConnection, SceneMessageLayout) {
+	using namespace Test_SocketConnection;
+	float pos[3] = {1.5f, -2.f, 3.25f};
+	Scene s("fps", 75, pos);
+	s.setDeltaFrames(true, 100);
+	s.add(mesh("hill", {0.f, 1.f, -2.5f, 1e-3f}));
+	TerrainMesh lake = mesh("lake", {3.f, 3.f, 3.f, 3.f});
+	lake.setPlacement(10.f, 20.f, 0.5f);
+	s.add(lake);
+
+	sio::message::ptr msg = SocketConnection::getSceneMessage(s);
+	EXPECT_EQ(keys(msg), (std::set<std::string> {"camera", "lights", "meshes"}));
+	const sio::message::ptr& cam = field(msg, "camera");
+	EXPECT_EQ(field(cam, "name")->get_string(), "fps");
+	EXPECT_EQ(field(cam, "fov")->get_int(), 75);
+	const auto& position = field(cam, "position")->get_vector();
+	ASSERT_EQ(position.size(), 3u);
+	for (int c = 0; c < 3; ++c)
+		EXPECT_EQ(position[c]->get_double(), pos[c]);
+	EXPECT_TRUE(field(msg, "lights")->get_vector().empty());
+
+	const auto& meshes = field(msg, "meshes")->get_vector();
+	ASSERT_EQ(meshes.size(), 2u);
+	for (const auto& m : meshes) {
+		std::string name = field(m, "name")->get_string();
+		const TerrainMesh& expected = s.getTerrains().at(name);
+		EXPECT_EQ(field(m, "type")->get_string(), "terrain");
+		EXPECT_EQ(field(m, "rows")->get_int(), 2);
+		EXPECT_EQ(field(m, "cols")->get_int(), 2);
+		EXPECT_EQ(floats(bytes(m, "vertices")), expected.getVertices()) << name;
+		EXPECT_EQ(floats(bytes(m, "colors")), expected.getColors()) << name;
+		if (name == "lake") {
+			EXPECT_EQ(keys(m), (std::set<std::string> {"name", "type", "rows", "cols", "origin", "spacing", "vertices", "colors"}));
+			const auto& origin = field(m, "origin")->get_vector();
+			ASSERT_EQ(origin.size(), 2u);
+			EXPECT_EQ(origin[0]->get_double(), 10.);
+			EXPECT_EQ(origin[1]->get_double(), 20.);
+			EXPECT_EQ(field(m, "spacing")->get_double(), 0.5);
+		}
+		else
+			EXPECT_EQ(keys(m), (std::set<std::string> {"name", "type", "rows", "cols", "vertices", "colors"}));
+	}
+
+	// a delta frame sends the modified mesh and keeps the other one
+	s.get("lake").getVertices()[0] = 4.f;
+	msg = SocketConnection::getSceneMessage(s);
+	EXPECT_EQ(keys(msg), (std::set<std::string> {"camera", "lights", "meshes", "keep"}));
+	const auto& sent = field(msg, "meshes")->get_vector();
+	ASSERT_EQ(sent.size(), 1u);
+	EXPECT_EQ(field(sent[0], "name")->get_string(), "lake");
+	EXPECT_EQ(floats(bytes(sent[0], "vertices")), (std::vector<float> {4.f, 3.f, 3.f, 3.f}));
+	const auto& keep = field(msg, "keep")->get_vector();
+	ASSERT_EQ(keep.size(), 1u);
+	EXPECT_EQ(keep[0]->get_string(), "hill");
+}
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SortingInputGenerator.h"
+#include "SortingBenchmark.h"
+
+using namespace bridges::benchmark;
+using namespace bridges::datastructure;
+
+namespace Test_SortingInputGenerator {
+	inline std::vector<long> generate(const std::string& type, long n,
+		uint64_t seed = 42, int threads = 1, double zipf = 1., long k = 0) {
+		SortingInputGenerator<long> gen;
+		gen.setSeed(seed);
+		gen.setThreads(threads);
+		gen.setZipfExponent(zipf);
+		gen.setKSortedness(k);
+		std::vector<long> arr(n);
+		gen.generate(type, arr.data(), n);
+		return arr;
+	}
+
+	inline bool allIn(const std::vector<long>& arr, long lo, long hi) {
+		for (long v : arr)
+			if (v < lo || v >= hi)
+				return false;
+		return true;
+	}
+
+	inline size_t distinct(const std::vector<long>& arr) {
+		return std::set<long>(arr.begin(), arr.end()).size();
+	}
+}
+
+TEST(SortingInputGenerator, OutputOnlyDependsOnTheSeed) {
+	using namespace Test_SortingInputGenerator;
+	// above the parallel threshold, and not a multiple of the chunks
+	const long n = 3 * (1 << 20) + 12345;
+	for (const char* type : {
+				"random", "zipf", "almostsorted", "duplicates", "ksorted"
+			}) {
+		std::vector<long> serial = generate(type, n, 7, 1);
+		for (int threads : {
+					2, 3, 8, 0
+				})
+			EXPECT_TRUE(generate(type, n, 7, threads) == serial) << type << " " << threads;
+		EXPECT_TRUE(generate(type, n, 7, 3) == serial) << type;
+		EXPECT_FALSE(generate(type, n, 8, 3) == serial) << type;
+	}
+}
+
+TEST(SortingInputGenerator, SmallArraysOnlyDependOnTheSeed) {
+	using namespace Test_SortingInputGenerator;
+	EXPECT_EQ(generate("random", 1000, 1), generate("random", 1000, 1));
+	EXPECT_NE(generate("random", 1000, 1), generate("random", 1000, 2));
+	// with values independent of n, a prefix does not depend on the
+	// length of the array
+	std::vector<long> longer = generate("fewdifferentvalues", 200000, 1);
+	std::vector<long> shorter = generate("fewdifferentvalues", 100000, 1);
+	EXPECT_TRUE(std::equal(shorter.begin(), shorter.end(), longer.begin()));
+}
+
+TEST(SortingInputGenerator, Random) {
+	using namespace Test_SortingInputGenerator;
+	const long n = 100000;
+	std::vector<long> arr = generate("random", n);
+	EXPECT_TRUE(allIn(arr, 0, 2 * n));
+	// roughly uniform: 10 buckets of about n / 10 elements
+	std::vector<long> buckets(10, 0);
+	for (long v : arr)
+		buckets[v * 10 / (2 * n)]++;
+	for (long b : buckets)
+		EXPECT_NEAR(b, n / 10, n / 100);
+}
+
+TEST(SortingInputGenerator, SortedSequences) {
+	using namespace Test_SortingInputGenerator;
+	const long n = 1000;
+	std::vector<long> in = generate("inorder", n);
+	std::vector<long> rev = generate("reverseorder", n);
+	for (long i = 0; i < n; ++i) {
+		EXPECT_EQ(in[i], i);
+		EXPECT_EQ(rev[i], n - i);
+	}
+}
+
+TEST(SortingInputGenerator, FewDifferentValues) {
+	using namespace Test_SortingInputGenerator;
+	std::vector<long> arr = generate("fewdifferentvalues", 10000);
+	EXPECT_TRUE(allIn(arr, 0, 4));
+	EXPECT_EQ(distinct(arr), 4u);
+}
+
+TEST(SortingInputGenerator, AlmostSorted) {
+	using namespace Test_SortingInputGenerator;
+	const long n = 1000;
+	std::vector<long> arr = generate("almostsorted", n);
+	for (long i = 0; i < n - 20; ++i)
+		ASSERT_EQ(arr[i], i);
+	std::vector<long> tail(arr.end() - 20, arr.end());
+	EXPECT_TRUE(allIn(tail, 0, 2 * n));
+	EXPECT_FALSE(std::is_sorted(tail.begin(), tail.end()));
+}
+
+TEST(SortingInputGenerator, OrganPipe) {
+	using namespace Test_SortingInputGenerator;
+	for (long n : {
+				1000l, 1001l
+			}) {
+		std::vector<long> arr = generate("organpipe", n);
+		long half = n / 2;
+		EXPECT_TRUE(std::is_sorted(arr.begin(), arr.begin() + half));
+		EXPECT_TRUE(std::is_sorted(arr.rbegin(), arr.rend() - half));
+		for (long i = 0; i < n; ++i)
+			EXPECT_EQ(arr[i], i < half ? i : n - 1 - i);
+	}
+}
+
+TEST(SortingInputGenerator, Sawtooth) {
+	using namespace Test_SortingInputGenerator;
+	const long n = 10000;
+	std::vector<long> arr = generate("sawtooth", n);
+	for (long i = 0; i < n; ++i)
+		ASSERT_EQ(arr[i], i % 100);
+}
+
+TEST(SortingInputGenerator, Duplicates) {
+	using namespace Test_SortingInputGenerator;
+	const long n = 100000;
+	std::vector<long> arr = generate("duplicates", n);
+	// sqrt(n) = 316 distinct values, each about 316 times
+	EXPECT_TRUE(allIn(arr, 0, 316));
+	EXPECT_EQ(distinct(arr), 316u);
+}
+
+TEST(SortingInputGenerator, ZipfFrequencies) {
+	using namespace Test_SortingInputGenerator;
+	const long samples = 400000;
+	for (double s : {
+				1., 2.
+			}) {
+		std::vector<long> arr = generate("zipf", samples, 42, 1, s, 0);
+		// the domain is [1; samples], P(k) = k^-s / H(samples, s)
+		EXPECT_TRUE(allIn(arr, 1, samples + 1));
+		double h = 0.;
+		for (long k = 1; k <= samples; ++k)
+			h += std::pow((double) k, -s);
+		std::vector<long> count(11, 0);
+		for (long v : arr)
+			if (v <= 10)
+				count[v]++;
+		for (long k = 1; k <= 10; ++k) {
+			double expected = samples * std::pow((double) k, -s) / h;
+			EXPECT_NEAR(count[k], expected, 0.05 * expected + 5. * std::sqrt(expected))
+					<< "s=" << s << " k=" << k;
+		}
+	}
+}
+
+TEST(SortingInputGenerator, KSorted) {
+	using namespace Test_SortingInputGenerator;
+	const long n = 100000;
+	for (long k : {
+				0l, 5l, 1000l
+			}) {
+		long maxDisplacement = (k == 0) ? (long) std::log2((double) n) : k;
+		std::vector<long> arr = generate("ksorted", n, 42, 1, 1., k);
+		std::vector<long> sorted = arr;
+		std::sort(sorted.begin(), sorted.end());
+		for (long i = 0; i < n; ++i)
+			ASSERT_EQ(sorted[i], i) << "not a permutation, k=" << k;
+		long worst = 0;
+		for (long i = 0; i < n; ++i)
+			worst = std::max(worst, std::abs(arr[i] - i));
+		EXPECT_LT(worst, maxDisplacement) << "k=" << k;
+		EXPECT_GE(worst, maxDisplacement / 2) << "k=" << k;
+	}
+}
+
+TEST(SortingInputGenerator, KeyTypesKeepTheOrder) {
+	SortingInputGenerator<std::string> strings;
+	std::vector<std::string> s(1000);
+	strings.generate("inorder", s.data(), 1000);
+	EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+	// zero padded to the width of the bound
+	EXPECT_EQ(s[7], "0007");
+
+	SortingInputGenerator<double> doubles;
+	std::vector<double> d(1000);
+	doubles.generate("reverseorder", d.data(), 1000);
+	EXPECT_TRUE(std::is_sorted(d.rbegin(), d.rend()));
+
+	// the value part records the original position
+	typedef std::pair<int, int> KV;
+	SortingInputGenerator<KV> pairs;
+	std::vector<KV> p(1000);
+	pairs.generate("fewdifferentvalues", p.data(), 1000);
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_EQ(p[i].second, i);
+		EXPECT_LT(p[i].first, 4);
+	}
+	EXPECT_TRUE(SortingInputGenerator<KV>::inOrder(KV(1, 9), KV(1, 2)));
+}
+
+TEST(SortingInputGenerator, InvalidParameters) {
+	SortingInputGenerator<int> gen;
+	int arr[4];
+	EXPECT_THROW(gen.generate("nosuchgenerator", arr, 4), std::string);
+	for (double e : {
+				0., -1., std::numeric_limits<double>::quiet_NaN()
+			})
+		EXPECT_THROW(gen.setZipfExponent(e), std::invalid_argument) << e;
+	EXPECT_NO_THROW(gen.setZipfExponent(0.5));
+
+	LineChart lc;
+	SortingBenchmark sb(lc);
+	EXPECT_THROW(sb.setZipfExponent(0.), std::invalid_argument);
+	EXPECT_THROW(sb.setZipfExponent(std::numeric_limits<double>::quiet_NaN()),
+		std::invalid_argument);
+	EXPECT_NO_THROW(sb.setZipfExponent(1.2));
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include "SweepScheduler.h"
+
+using namespace bridges::benchmark;
+
+namespace Test_SweepScheduler {
+	/// records t = c * n^b for n = first, 2 first, ..., 2^(count-1) first
+	inline void powerLaw(SweepScheduler& s, double c, double b, double first, int count) {
+		double n = first;
+		for (int i = 0; i < count; ++i, n *= 2.)
+			s.record(n, c * std::pow(n, b));
+	}
+
+	inline void expectRelNear(double actual, double expected, double rel) {
+		EXPECT_NEAR(actual, expected, rel * std::abs(expected));
+	}
+}
+
+TEST(SweepScheduler, FitsThePowerLaw) {
+	using namespace Test_SweepScheduler;
+	for (double b : {
+				1., 1.5, 2., 3.
+			}) {
+		SweepScheduler s(1000., 1e9, 1e9);
+		powerLaw(s, 3e-9, b, 1000., 4);
+		expectRelNear(s.getExponent(), b, 1e-9);
+		for (double n : {
+					1000., 12345., 1e6
+				})
+			expectRelNear(s.predict(n), 3e-9 * std::pow(n, b), 1e-9);
+	}
+}
+
+TEST(SweepScheduler, ClampsTheExponent) {
+	using namespace Test_SweepScheduler;
+	SweepScheduler sub(1000., 1e9, 1e9);
+	powerLaw(sub, 1e-6, 0.5, 1000., 4);
+	EXPECT_EQ(sub.getExponent(), 1.);
+	// anchored on the last point
+	expectRelNear(sub.predict(16000.), 1e-6 * std::sqrt(8000.) * 2., 1e-9);
+
+	SweepScheduler super(1000., 1e9, 1e9);
+	powerLaw(super, 1e-20, 5., 1000., 4);
+	EXPECT_EQ(super.getExponent(), 4.);
+}
+
+TEST(SweepScheduler, SinglePointIsLinear) {
+	SweepScheduler s(1000., 1e9, 1e9);
+	EXPECT_EQ(s.predict(1000.), 0.);
+	s.record(1000., 0.5);
+	EXPECT_EQ(s.getExponent(), 1.);
+	EXPECT_DOUBLE_EQ(s.predict(3000.), 1.5);
+}
+
+TEST(SweepScheduler, FitsOnlyTheLastPoints) {
+	using namespace Test_SweepScheduler;
+	SweepScheduler s(10., 1e9, 1e9);
+	// a constant overhead dominates the small sizes
+	s.record(10., 1.);
+	s.record(20., 1.);
+	powerLaw(s, 1e-8, 2., 1000., 4);
+	expectRelNear(s.getExponent(), 2., 1e-9);
+}
+
+TEST(SweepScheduler, TimerNoiseDoesNotBreakTheFit) {
+	SweepScheduler s(10., 1e9, 1e9);
+	s.record(10., 0.);
+	s.record(20., 0.);
+	EXPECT_TRUE(std::isfinite(s.getExponent()));
+	EXPECT_TRUE(std::isfinite(s.predict(1e6)));
+}
+
+TEST(SweepScheduler, DenseScheduleWhenTheBudgetAllows) {
+	SweepScheduler s(1000., 1e6, 1e9, 4);
+	EXPECT_EQ(s.next(), 1000.);
+	s.record(1000., 1e-3);
+	// 3 points left, spread geometrically up to 1e6
+	EXPECT_NEAR(s.next(), 1e4, 1e-6);
+	s.record(1e4, 1e-2);
+	EXPECT_NEAR(s.next(), 1e5, 1e-5);
+	s.record(1e5, 1e-1);
+	EXPECT_EQ(s.next(), 1e6);
+	s.record(1e6, 1.);
+	EXPECT_LT(s.next(), 0.);
+}
+
+TEST(SweepScheduler, LargestAffordableSizeWhenMaxSizeIsOutOfReach) {
+	using namespace Test_SweepScheduler;
+	SweepScheduler s(1000., 1e12, 100.);
+	powerLaw(s, 1e-6, 2., 1000., 2);
+	// t(n) = 1e-6 n^2 must use at most half of the budget, with the
+	// default safety factor of 1.5
+	double expected = std::sqrt(s.remainingBudget() / 2. / 1.5 / 1e-6);
+	expectRelNear(s.next(), expected, 1e-3);
+	EXPECT_LE(1.5 * s.predict(s.next()), s.remainingBudget() / 2.);
+
+	// growth is capped at a factor 4 per point
+	SweepScheduler linear(1000., 1e12, 100.);
+	linear.record(1000., 1e-3);
+	EXPECT_DOUBLE_EQ(linear.next(), 4000.);
+}
+
+TEST(SweepScheduler, StopsWhenNothingLargerFits) {
+	using namespace Test_SweepScheduler;
+	SweepScheduler s(1000., 1e12, 100.);
+	s.setMaxRunTime(1.);
+	powerLaw(s, 1e-6, 2., 1000., 2);
+	// the largest run under 1 s (with safety) is about 816 < 2000
+	EXPECT_LT(s.next(), 0.);
+	EXPECT_FALSE(s.affordable(2100.));
+	EXPECT_TRUE(s.affordable(800.));
+
+	SweepScheduler spent(1000., 1e12, 0.);
+	EXPECT_LT(spent.next(), 0.);
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "ThreadPool.h"
+
+using namespace bridges;
+
+TEST(ThreadPool, EveryIndexRunsOnce) {
+	ThreadPool pool(3);
+	EXPECT_EQ(pool.size(), 4);
+	for (long grain : {1L, 7L, 64L, 1000L, 5000L}) {
+		std::vector<std::atomic<int>> seen(3001);
+		for (auto& s : seen)
+			s = 0;
+		pool.parallelFor(-1000, 2001, grain, [&](long b, long e) {
+			EXPECT_LE(e - b, grain);
+			for (long i = b; i < e; ++i)
+				++seen[i + 1000];
+		});
+		for (size_t i = 0; i < seen.size(); ++i)
+			ASSERT_EQ(seen[i], 1) << "index " << (long) i - 1000 << " grain " << grain;
+	}
+}
+
+TEST(ThreadPool, EmptyRangeAndNoWorkers) {
+	ThreadPool pool(0);
+	EXPECT_EQ(pool.size(), 1);
+	bool called = false;
+	pool.parallelFor(5, 5, 1, [&](long, long) {
+		called = true;
+	});
+	EXPECT_FALSE(called);
+
+	long sum = 0;
+	pool.parallelFor(0, 100, 3, [&](long b, long e) {
+		for (long i = b; i < e; ++i)
+			sum += i;
+	});
+	EXPECT_EQ(sum, 4950);
+}
+
+TEST(ThreadPool, ExceptionsReachTheCaller) {
+	ThreadPool pool(3);
+	std::atomic<long> done(0);
+	EXPECT_THROW(pool.parallelFor(0, 1000, 10, [&](long b, long e) {
+		if (b <= 500 && 500 < e)
+			throw std::runtime_error("chunk 50");
+		done += e - b;
+	}), std::runtime_error);
+	EXPECT_LT(done.load(), 1000);
+
+	// the pool still runs loops after one failed
+	std::atomic<long> sum(0);
+	pool.parallelFor(0, 1000, 10, [&](long b, long e) {
+		for (long i = b; i < e; ++i)
+			sum += i;
+	});
+	EXPECT_EQ(sum.load(), 499500);
+}
+
+TEST(ThreadPool, NestedLoopsComplete) {
+	ThreadPool pool(2);
+	std::atomic<long> sum(0);
+	pool.parallelFor(0, 40, 1, [&](long b, long e) {
+		for (long i = b; i < e; ++i)
+			pool.parallelFor(0, 100, 10, [&](long ib, long ie) {
+				for (long j = ib; j < ie; ++j)
+					sum += i * 100 + j;
+			});
+	});
+	EXPECT_EQ(sum.load(), 3999L * 4000 / 2);
+
+	// an exception in an inner loop reaches the outer caller
+	EXPECT_THROW(pool.parallelFor(0, 8, 1, [&](long b, long) {
+		pool.parallelFor(0, 8, 1, [&](long ib, long) {
+			if (b == 3 && ib == 5)
+				throw std::logic_error("inner");
+		});
+	}), std::logic_error);
+}
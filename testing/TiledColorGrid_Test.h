@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "TiledColorGrid.h"
+
+using namespace bridges;
+using namespace bridges::datastructure;
+
+namespace Test_TiledColorGrid {
+	TiledColorGrid pattern(int rows, int cols, int tileRows, int tileCols) {
+		TiledColorGrid g(rows, cols, tileRows, tileCols);
+		for (int i = 0; i < rows; ++i)
+			for (int j = 0; j < cols; ++j)
+				g.set(i, j, Color((i * 37 + j * 11) % 256, (i * j) % 256, (i + 3 * j) % 256, (i * 7 + j) % 256));
+		return g;
+	}
+
+	/// pixel (i, j) of the downsampled image, from the definition
+	Color halfPixel(const TiledColorGrid& g, int i, int j) {
+		int i0 = 2 * i, i1 = std::min(2 * i + 1, g.getHeight() - 1);
+		int j0 = 2 * j, j1 = std::min(2 * j + 1, g.getWidth() - 1);
+		const Color* p[4] = {&g.get(i0, j0), &g.get(i0, j1), &g.get(i1, j0), &g.get(i1, j1)};
+		int sum[4] = {0, 0, 0, 0};
+		for (const Color* c : p) {
+			sum[0] += c->getRed();
+			sum[1] += c->getGreen();
+			sum[2] += c->getBlue();
+			sum[3] += c->getAlpha();
+		}
+		return Color((sum[0] + 2) / 4, (sum[1] + 2) / 4, (sum[2] + 2) / 4, (sum[3] + 2) / 4);
+	}
+}
+
+TEST(TiledColorGrid, DownsampleAveragesAcrossTiles) {
+	for (int rows : {1, 7, 33})
+		for (int cols : {1, 10, 65})
+			for (int tile : {1, 4, 16}) {
+				TiledColorGrid g = Test_TiledColorGrid::pattern(rows, cols, tile, tile + 3);
+				TiledColorGrid half = g.downsample();
+				ASSERT_EQ(half.getHeight(), (rows + 1) / 2);
+				ASSERT_EQ(half.getWidth(), (cols + 1) / 2);
+				for (int i = 0; i < half.getHeight(); ++i)
+					for (int j = 0; j < half.getWidth(); ++j)
+						ASSERT_EQ(half.get(i, j), Test_TiledColorGrid::halfPixel(g, i, j))
+								<< rows << "x" << cols << " tiles " << tile << " at " << i << "," << j;
+			}
+}
+
+TEST(TiledColorGrid, OverviewIsRepeatedDownsampling) {
+	TiledColorGrid g = Test_TiledColorGrid::pattern(75, 41, 8, 16);
+	for (int max : {1, 5, 20, 100}) {
+		TiledColorGrid level = g;
+		while (level.getHeight() > max || level.getWidth() > max)
+			level = level.downsample();
+		ColorGrid ov = g.getOverview(max, max);
+		ASSERT_EQ(ov.getDimensions()[0], level.getHeight());
+		ASSERT_EQ(ov.getDimensions()[1], level.getWidth());
+		for (int i = 0; i < level.getHeight(); ++i)
+			for (int j = 0; j < level.getWidth(); ++j)
+				ASSERT_EQ(ov.get(i, j), level.get(i, j)) << "max " << max;
+	}
+	EXPECT_THROW(g.getOverview(0, 10), std::invalid_argument);
+}
+
+TEST(TiledColorGrid, VisualizeChecksTheSubAssignmentsFirst) {
+	Bridges bridges(1, "user", "key");
+	bridges.setTitle("image");
+	ColorGrid other(2, 2);
+	bridges.setDataStructure(other);
+
+	// 16 x 16 tiles and the overview: more than an assignment holds
+	TiledColorGrid big(8192, 8192, 512, 512);
+	EXPECT_THROW(big.visualize(bridges), std::invalid_argument);
+	EXPECT_EQ(bridges.getSubAssignmentsLeft(), 99u);
+	EXPECT_EQ(bridges.getTitle(), "image");
+	EXPECT_EQ(bridges.getDataStructure(), &other);
+}
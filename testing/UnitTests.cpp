@@ -0,0 +1,31 @@
+// Unit tests of the library, with GoogleTest.
+//
+//   make unit_tests && ./unit_tests
+//
+// unit_tests_ssse3 and unit_tests_avx2 build the same tests with the
+// SIMD code paths enabled.
+
+#include "Bridges.h"
+
+#include "Base64_Test.h"
+#include "BenchmarkResults_Test.h"
+#include "Color_Test.h"
+#include "ColorGrid_Test.h"
+#include "ComplexityFit_Test.h"
+#include "DataSource_Test.h"
+#include "FramePacer_Test.h"
+#include "GameGrid_Test.h"
+#include "Grid_Test.h"
+#include "ImageFile_Test.h"
+#include "InputLog_Test.h"
+#include "RunWatchdog_Test.h"
+#include "SPSCRing_Test.h"
+#include "SortingInputGenerator_Test.h"
+#include "SweepScheduler_Test.h"
+#include "ThreadPool_Test.h"
+#include "TiledColorGrid_Test.h"
+
+// Color_Test.h checks with assert(), which aborts on the first failure
+TEST(Color, AllCases) {
+	Test_Color::runTests();
+}